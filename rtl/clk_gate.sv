@@ -0,0 +1,32 @@
+/**
+ * @info Integrated clock gate
+ *
+ * @author Anastasios Psarras (a.psarras4225@gmail.com)
+ *
+ * @license MIT license, check license.md
+ *
+ * @brief Latch-based clock gate (the usual ICG cell function): en_i is captured while clk is low, so that gclk_o
+ *        only carries full clock pulses: it rises with clk when en_i is asserted, as a register enable would.
+ *        test_en_i forces the clock on (scan). This is a behavioral model -- map it to the ICG cell of the target
+ *        library (or let the synthesis tool do it) for implementation.
+ */
+
+module clk_gate
+(
+    input  logic    clk,        // clock, @posedge
+    input  logic    en_i,       // clock enable for the next cycle
+    input  logic    test_en_i,  // scan enable -- forces the clock on
+    output logic    gclk_o      // gated clock
+);
+
+logic en_l;
+
+always_latch begin: latch_en
+    if (!clk) begin
+        en_l <= en_i | test_en_i;
+    end
+end
+
+assign gclk_o = clk & en_l;
+
+endmodule
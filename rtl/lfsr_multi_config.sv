@@ -23,13 +23,20 @@
  *                     2  | 1 0 1
  *
  *                n[0] = r[0]^r[2] , n[1] = r[0], n[2] = r[0]^r[1]^r[2]
+ * @param STEPS   defines the number of LFSR steps performed in each enabled cycle. The state k steps ahead is
+ *                computed directly from the register through the matrix power M^k (precomputed at elaboration),
+ *                so the logic depth does not grow with STEPS (one XOR of up to N bits per state bit).
+ *                outp_o[k] is the output of the k-th step, i.e. the output bit stream is outp_o[0], outp_o[1], ...
+ *                Jumping to a state further away is a matter of loading it through seq_i (see
+ *                simon_const_pkg::simon_lfsr_jump for computing it at elaboration).
  */
 
 module lfsr_multi_config
 #(
     parameter int                           N        = 3,
     parameter int                           C        = 2,
-    parameter logic[C-1:0][0:N-1][0:N-1]    MATRICES = '{{3'b010, 3'b001, 3'b101}, {3'b010, 3'b100, 3'b010}}
+    parameter logic[C-1:0][0:N-1][0:N-1]    MATRICES = '{{3'b010, 3'b001, 3'b101}, {3'b010, 3'b100, 3'b010}},
+    parameter int                           STEPS    = 1
 )
 (
     input  logic                clk,            // clock, @posedge
@@ -41,7 +48,7 @@ module lfsr_multi_config
     input  logic[C-1:0]         conf_sel_i,     // selects config (binary) -- should be changed on reset (sync)
     // LFSR
     input  logic                run_en_i,       // enables LFSR's FF write enables
-    output logic                outp_o          // output
+    output logic[STEPS-1:0]     outp_o          // output -- one bit per step
 );
 
 // -- Helpful Funcs ------------------------------------------------------------------------------- //
@@ -59,13 +66,40 @@ function logic[C-1:0][0:N-1][N-1:0] transpose_n_reverse();
     return matret;
 endfunction
 
+// powers of the transposed matrices: POWERS_T[c][k][i] selects the bits of r whose XOR is bit i, k steps ahead
+function logic[C-1:0][STEPS:0][0:N-1][N-1:0] matrix_powers();
+    logic[C-1:0][STEPS:0][0:N-1][N-1:0] powret;
+    logic[C-1:0][0:N-1][N-1:0]          mat_t;
+    mat_t = transpose_n_reverse();
+    for (int c=0; c<C; c++) begin
+        for (int i=0; i<N; i++) begin
+            powret[c][0][i] = {{(N-1){1'b0}}, 1'b1} << i;
+        end
+        for (int k=0; k<STEPS; k++) begin
+            for (int i=0; i<N; i++) begin
+                powret[c][k+1][i] = '0;
+                for (int l=0; l<N; l++) begin
+                    if (mat_t[c][i][l]) begin
+                        powret[c][k+1][i] = powret[c][k+1][i] ^ powret[c][k][l];
+                    end
+                end
+            end
+        end
+    end
+    return powret;
+endfunction
+
 // -- Self-config --------------------------------------------------------------------------------- //
-localparam logic[C-1:0][0:N-1][N-1:0] MATRICES_T = transpose_n_reverse();
+localparam logic[C-1:0][STEPS:0][0:N-1][N-1:0] POWERS_T = matrix_powers();
 
 // -- Signals ------------------------------------------------------------------------------------- //
 logic[N-1:0]        lfsr_r;
 logic[N-1:0]        lfsr_nxt;
-logic[0:N-1][N-1:0] active_matrix;
+// only the powers 1..STEPS and, but for the last step, the output bit of each state are used
+// verilator lint_off UNUSEDSIGNAL
+logic[STEPS:0][0:N-1][N-1:0] active_powers;
+logic[STEPS:0][N-1:0] lfsr_steps;   // lfsr_steps[k]: LFSR state k steps after lfsr_r
+// verilator lint_on UNUSEDSIGNAL
 
 // -- Registers ----------------------------------------------------------------------------------- //
 always_ff @(posedge clk, negedge arst_n) begin: ff_lfsr
@@ -83,23 +117,38 @@ end
 // Config -- MUX
 logic tmp;
 always_comb begin: mux_matrix
-    for (int i=0; i<N; i++) begin
-        for (int j=0; j<N; j++) begin
-            tmp = 0;
-            for (int c=0; c<C; c++) begin
-                tmp = tmp | (conf_sel_i[c] & MATRICES_T[c][i][j]);
+    for (int k=0; k<=STEPS; k++) begin
+        for (int i=0; i<N; i++) begin
+            for (int j=0; j<N; j++) begin
+                tmp = 0;
+                for (int c=0; c<C; c++) begin
+                    tmp = tmp | (conf_sel_i[c] & POWERS_T[c][k][i][j]);
+                end
+                active_powers[k][i][j] = tmp;
             end
-            active_matrix[i][j] = tmp;
         end
     end
 end
-// XORs
-for (genvar i=0; i<N; i++) begin: g_for_i
-    assign lfsr_nxt[i] = ^(lfsr_r & active_matrix[i]);
+// XORs -- one level of M^k per step
+assign lfsr_steps[0] = lfsr_r;
+for (genvar k=0; k<STEPS; k++) begin: g_for_k
+    for (genvar i=0; i<N; i++) begin: g_for_i
+        assign lfsr_steps[k+1][i] = ^(lfsr_r & active_powers[k+1][i]);
+    end
 end
+assign lfsr_nxt = lfsr_steps[STEPS];
 
 // -- Output -------------------------------------------------------------------------------------- //
-assign outp_o = lfsr_r[N-1];
+for (genvar k=0; k<STEPS; k++) begin: g_for_outp
+    assign outp_o[k] = lfsr_steps[k][N-1];
+end
+
+// -- Design Parameter Assertions ----------------------------------------------------------------- //
+// synthesis translate_off
+initial begin
+    #0 assert (STEPS >= 1) else $error("Illegal STEPS parameter value %0d -- must be at least 1", STEPS);
+end
+// synthesis translate_on
 
 // -- Assertion Properties ------------------------------------------------------------------------ //
 // synthesis translate_off
@@ -0,0 +1,200 @@
+/**
+ * @info NSA's Simon cipher -- AXI-Stream top module
+ *
+ * @author Anastasios Psarras (a.psarras4225@gmail.com)
+ *
+ * @license MIT license, check license.md
+ *
+ * @brief AXI-Stream adaptor around simon_top (or simon_multi_top, with N_ENGINES > 1) and its input & output FIFOs,
+ *        so that a DMA engine can push bursts of blocks every cycle and drain the results in bursts, with the bus
+ *        latency decoupled from the core latency.
+ *        -- Slave (blocks in): s_axis_tdata = {key, pt} (key_i in the upper NKW*WW bits, pt_i in the lower 2*WW),
+ *           s_axis_tuser = mode (0: encrypt, 1: decrypt).
+ *        -- Master (results out, in input order): m_axis_tdata = ct, m_axis_tuser = mode.
+ *        -- Word order: the text words are passed as is, so decryption blocks (tuser = 1) follow simon_top's convention
+ *           and are word-swapped on both sides: s_axis_tdata carries {key, ct[0], ct[1]} (ciphertext word 0 in the
+ *           upper WW bits of the text) and m_axis_tdata carries {pt[0], pt[1]}, which the consumer swaps back. An
+ *           encryption block (tuser = 0) is {key, pt[1], pt[0]} in and {ct[1], ct[0]} out, unswapped.
+ *        -- TLAST of each block is carried to its result through a sideband FIFO of one entry per block in flight,
+ *           so that packet boundaries survive the engines.
+ *        The data widths are multiples of 8 for all the Simon configurations, as AXI-Stream requires.
+ *
+ * @param WW        Defines the word size (n in [ref], see simon_top)
+ * @param NKW       Defines the number of key words (m in [ref]).
+ * @param DATA_RST  Sets whether the data registers are resettable to zero
+ * @param UNROLL    Number of rounds performed per cycle by each engine (see simon_top)
+ * @param DEC_KEY_CACHE_DEPTH   Decryption key cache entries of each engine (see simon_top)
+ * @param RK_RAM    Round key RAM mode of each engine (see simon_top)
+ * @param N_ENGINES Number of engines (1: simon_top, > 1: simon_multi_top)
+ * @param IN_FIFO_DEPTH     Input FIFO depth of each engine (see simon_top)
+ * @param OUT_FIFO_DEPTH    Output FIFO depth of each engine (see simon_top)
+ */
+
+module simon_axis_top
+#(
+    parameter int   WW          = 16,
+    parameter int   NKW         = 4,
+    parameter logic DATA_RST    = 1'b0,
+    parameter int   UNROLL      = 1,
+    parameter int   DEC_KEY_CACHE_DEPTH = 1,
+    parameter logic RK_RAM      = 1'b0,
+    parameter int   N_ENGINES   = 1,
+    parameter int   IN_FIFO_DEPTH   = 4,
+    parameter int   OUT_FIFO_DEPTH  = 4
+)
+(
+    input  logic                    clk,            // clock, @posedge
+    input  logic                    arst_n,         // async reset -- active low
+    // Activity
+    output logic                    active_o,       // indicates when there's activity in the block
+    // AXI-Stream Slave (blocks in)
+    input  logic                    s_axis_tvalid,
+    output logic                    s_axis_tready,
+    input  logic[(NKW+2)*WW-1:0]    s_axis_tdata,   // {key, pt}
+    input  logic                    s_axis_tuser,   // 0: encrypt / 1: decrypt
+    input  logic                    s_axis_tlast,
+    // AXI-Stream Master (results out)
+    output logic                    m_axis_tvalid,
+    input  logic                    m_axis_tready,
+    output logic[2*WW-1:0]          m_axis_tdata,   // ciphertext (on encryption), or plaintext (on decryption)
+    output logic                    m_axis_tuser,   // 0: encrypt / 1: decrypt
+    output logic                    m_axis_tlast
+);
+
+// -- Constants ----------------------------------------------------------------------------------- //
+// blocks in flight: staged, running, finished & in the FIFOs, in each engine
+localparam int MAX_FLIGHT   = (3 + IN_FIFO_DEPTH + OUT_FIFO_DEPTH) * N_ENGINES;
+
+// -- Signal Definitions -------------------------------------------------------------------------- //
+logic                   eng_valid_i;
+logic                   eng_ready_o;
+logic                   eng_valid_o;
+logic                   eng_ready_i;
+logic                   last_ready;
+logic                   last_valid;
+
+// -- Handshakes ---------------------------------------------------------------------------------- //
+// a block is accepted when both the engines and the TLAST FIFO take it (the latter never stalls, see MAX_FLIGHT)
+assign s_axis_tready    = eng_ready_o & last_ready;
+assign eng_valid_i      = s_axis_tvalid & last_ready;
+assign m_axis_tvalid    = eng_valid_o;
+assign eng_ready_i      = m_axis_tready;
+
+// -- TLAST FIFO ---------------------------------------------------------------------------------- //
+sync_fifo
+#(
+    .WIDTH      (1),
+    .DEPTH      (MAX_FLIGHT),
+    .DATA_RST   (1'b0)
+)
+i_last_fifo
+(
+    .clk        (clk),
+    .arst_n     (arst_n),
+    .clr_i      (1'b0),
+
+    .valid_i    (s_axis_tvalid & s_axis_tready),
+    .ready_o    (last_ready),
+    .data_i     (s_axis_tlast),
+
+    .valid_o    (last_valid),
+    .ready_i    (m_axis_tvalid & m_axis_tready),
+    .data_o     (m_axis_tlast),
+
+    .count_o    ()
+);
+
+// -- Engines ------------------------------------------------------------------------------------- //
+if (N_ENGINES > 1) begin: g_if_multi
+    logic[N_ENGINES-1:0] eng_active;
+
+    simon_multi_top
+    #(
+        .WW                 (WW),
+        .NKW                (NKW),
+        .DATA_RST           (DATA_RST),
+        .UNROLL             (UNROLL),
+        .DEC_KEY_CACHE_DEPTH(DEC_KEY_CACHE_DEPTH),
+        .RK_RAM             (RK_RAM),
+        .N_ENGINES          (N_ENGINES),
+        .IN_FIFO_DEPTH      (IN_FIFO_DEPTH),
+        .OUT_FIFO_DEPTH     (OUT_FIFO_DEPTH)
+    )
+    i_eng
+    (
+        .clk                (clk),
+        .arst_n             (arst_n),
+
+        .active_o           (eng_active),
+
+        .valid_i            (eng_valid_i),
+        .ready_o            (eng_ready_o),
+        .mode_i             (s_axis_tuser),
+        .pt_i               (s_axis_tdata[2*WW-1:0]),
+        .key_i              (s_axis_tdata[(NKW+2)*WW-1:2*WW]),
+
+        .valid_o            (eng_valid_o),
+        .ready_i            (eng_ready_i),
+        .mode_o             (m_axis_tuser),
+        .ct_o               (m_axis_tdata)
+    );
+
+    assign active_o = |eng_active;
+end else begin: g_if_single
+    simon_top
+    #(
+        .WW                 (WW),
+        .NKW                (NKW),
+        .DATA_RST           (DATA_RST),
+        .UNROLL             (UNROLL),
+        .DEC_KEY_CACHE_DEPTH(DEC_KEY_CACHE_DEPTH),
+        .KEY_PERSIST        (1'b0),
+        .RK_RAM             (RK_RAM),
+        .STATS              (1'b0),
+        .IN_FIFO_DEPTH      (IN_FIFO_DEPTH),
+        .OUT_FIFO_DEPTH     (OUT_FIFO_DEPTH)
+    )
+    i_eng
+    (
+        .clk                (clk),
+        .arst_n             (arst_n),
+
+        .active_o           (active_o),
+
+        .valid_i            (eng_valid_i),
+        .ready_o            (eng_ready_o),
+        .mode_i             (s_axis_tuser),
+        .alg_i              (1'b0),
+        .pt_i               (s_axis_tdata[2*WW-1:0]),
+        .key_i              (s_axis_tdata[(NKW+2)*WW-1:2*WW]),
+        .key_valid_i        (1'b0),
+        .key_ready_o        (),
+
+        .valid_o            (eng_valid_o),
+        .ready_i            (eng_ready_i),
+        .mode_o             (m_axis_tuser),
+        .alg_o              (),
+        .ct_o               (m_axis_tdata),
+        .rnd_i              ('0),
+
+        .stats_clr_i        (1'b0),
+        .stats_addr_i       ('0),
+        .stats_rdata_o      ()
+    );
+end
+
+// -- Assertion Properties ------------------------------------------------------------------------ //
+// synthesis translate_off
+assert property (@(posedge clk) disable iff(!arst_n)
+    s_axis_tvalid & eng_ready_o |-> last_ready) else $error("TLAST FIFO full while the engines can take a block");
+assert property (@(posedge clk) disable iff(!arst_n)
+    m_axis_tvalid |-> last_valid) else $error("result out without the TLAST of its block");
+// synthesis translate_on
+
+// -- Design Parameter Assertions ----------------------------------------------------------------- //
+// synthesis translate_off
+initial begin
+    #0 assert (N_ENGINES >= 1) else $error("Illegal N_ENGINES parameter value %0d -- must be >= 1", N_ENGINES);
+end
+// synthesis translate_on
+endmodule
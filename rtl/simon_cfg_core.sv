@@ -0,0 +1,225 @@
+/**
+ * @info NSA's Simon cipher core with a runtime configuration
+ *
+ * @author Anastasios Psarras (a.psarras4225@gmail.com)
+ *
+ * @license MIT license, check license.md
+ *
+ * @brief Same as simon_core (one round per cycle, no round key RAM), on a 2 x WW_MAX-bit text and NKW_MAX x WW_MAX-bit
+ *        key datapath hosting any Simon configuration (n, m) with n <= WW_MAX and m <= NKW_MAX, selected per block
+ *        through cfg_i (see simon_cfg_top). n-bit words sit in the low bits of the datapath words, with the upper
+ *        bits at zero.
+ *
+ * @param WW_MAX    Datapath word width (largest word size supported)
+ * @param NKW_MAX   Number of datapath key words (largest number of key words supported)
+ * @param DATA_RST  Sets whether the plaintext & key registers are resettable to zero (for testing reasons)
+ *                  Note that resettable data FFs will result to a higher area footprint
+ */
+
+module simon_cfg_core
+#(
+    parameter int   WW_MAX      = 64,
+    parameter int   NKW_MAX     = 4,
+    parameter logic DATA_RST    = 1'b0
+)
+(
+    input  logic                                    clk,            // clock, @posedge
+    input  logic                                    arst_n,         // async reset -- active low
+    //
+    input  logic[simon_const_pkg::SIMON_CFG_W-1:0]  cfg_i,          // configuration of the running block
+    input  logic                                    srst_i,         // reset LFSR & t sequence
+    input  logic                                    srst_mode_i,    // mode the LFSR & t sequence are reset to (the next block's)
+    input  logic[simon_const_pkg::SIMON_CFG_W-1:0]  srst_cfg_i,     // configuration the LFSR & t sequence are reset to (the next block's)
+    input  logic                                    mode_i,         // 0 for encrypt, 1 for decrypt
+
+    input  logic                                    pt_ld_en_i,     // load plaintext into registers (set pt_i and assert pt_ld_en_i for one cycle)
+    input  logic                                    pt_run_en_i,    // update plaintext registers (assert for as many cycles as the number of rounds)
+    input  logic[2-1:0][WW_MAX-1:0]                 pt_i,           // plaintext input (2 words)
+
+    input  logic                                    key_ld_en_i,    // load key into registers (set key_i and assert key_ld_en_i for one cycle)
+    input  logic                                    key_run_en_i,   // update key registers (assert for as many cycles as the number of rounds)
+    input  logic[NKW_MAX-1:0][WW_MAX-1:0]           key_i,          // key input (NKW_MAX words, the first m ones used)
+
+    output logic[2-1:0][WW_MAX-1:0]                 ct_o,           // current ciphertext (outputs plaintext regs)
+    output logic[2-1:0][WW_MAX-1:0]                 ct_nxt_o,       // ciphertext after the current round
+    output logic[WW_MAX-1:0]                        key_o           // current round key
+);
+// -- Constants ----------------------------------------------------------------------------------- //
+import simon_const_pkg::*;
+localparam int N_CFG_ENTRIES = 1 << SIMON_CFG_W;
+
+// word size selection of the round & key schedule (0: 16, 1: 24, 2: 32, 3: 48, 4: 64) of each configuration
+function automatic logic[N_CFG_ENTRIES-1:0][2:0] ww_sel_table();
+    logic[N_CFG_ENTRIES-1:0][2:0] tab;
+    tab = '0;
+    for (int c=0; c<SIMON_N_CFGS; c++) begin
+        case (simon_cfg_ww(c))
+            16:      tab[c] = 3'd0;
+            24:      tab[c] = 3'd1;
+            32:      tab[c] = 3'd2;
+            48:      tab[c] = 3'd3;
+            default: tab[c] = 3'd4;
+        endcase
+    end
+    return tab;
+endfunction
+
+function automatic logic[N_CFG_ENTRIES-1:0][2:0] nkw_table();
+    logic[N_CFG_ENTRIES-1:0][2:0] tab;
+    tab = '0;
+    for (int c=0; c<SIMON_N_CFGS; c++) begin
+        tab[c] = 3'(simon_cfg_nkw(c));
+    end
+    return tab;
+endfunction
+
+// C = 2^n - 4 of each configuration
+function automatic logic[N_CFG_ENTRIES-1:0][WW_MAX-1:0] c_table();
+    logic[N_CFG_ENTRIES-1:0][WW_MAX-1:0] tab;
+    tab = '0;
+    for (int c=0; c<SIMON_N_CFGS; c++) begin
+        for (int b=2; (b<simon_cfg_ww(c)) && (b<WW_MAX); b++) begin
+            tab[c][b] = 1'b1;
+        end
+    end
+    return tab;
+endfunction
+
+localparam logic[N_CFG_ENTRIES-1:0][2:0]        WW_SEL_TABLE    = ww_sel_table();
+localparam logic[N_CFG_ENTRIES-1:0][2:0]        NKW_TABLE       = nkw_table();
+localparam logic[N_CFG_ENTRIES-1:0][WW_MAX-1:0] C_TABLE         = c_table();
+
+// -- Signal Definitions -------------------------------------------------------------------------- //
+logic                               seq;
+logic[2:0]                          ww_sel;
+logic[2:0]                          nkw;
+logic[NKW_MAX-1:0][WW_MAX-1:0]      key_r;
+logic[NKW_MAX-1:0][WW_MAX-1:0]      key_nxt;
+logic[1:0][WW_MAX-1:0]              pt_r;
+logic[1:0][WW_MAX-1:0]              pt_nxt;
+logic[WW_MAX-1:0]                   c_xor_z;
+
+assign ww_sel   = WW_SEL_TABLE[cfg_i];
+assign nkw      = NKW_TABLE[cfg_i];
+
+// -- Data (plaintext & key) Registers ------------------------------------------------------------ //
+if (DATA_RST) begin: if_data_rst
+    // Resettable data FFs
+    always_ff @(posedge clk, negedge arst_n) begin: ff_key
+        if (!arst_n) begin
+            key_r <= '0;
+        end else begin
+            if (key_ld_en_i) begin
+                key_r <= key_i;
+            end else if (key_run_en_i) begin
+                key_r <= key_nxt;
+            end
+        end
+    end
+
+    always_ff @(posedge clk, negedge arst_n) begin: ff_pt
+        if (!arst_n) begin
+            pt_r  <= '0;
+        end else begin
+            if (pt_ld_en_i) begin
+                pt_r <= pt_i;
+            end else if (pt_run_en_i) begin
+                pt_r <= pt_nxt;
+            end
+        end
+    end
+end else begin: if_no_data_rst
+    // Non-resettable data FFs
+    always_ff @(posedge clk) begin: ff_key
+        if (key_ld_en_i) begin
+            key_r <= key_i;
+        end else if (key_run_en_i) begin
+            key_r <= key_nxt;
+        end
+    end
+
+    always_ff @(posedge clk) begin: ff_pt
+        if (pt_ld_en_i) begin
+            pt_r <= pt_i;
+        end else if (pt_run_en_i) begin
+            pt_r <= pt_nxt;
+        end
+    end
+end
+
+// -- Sequence Generator -------------------------------------------------------------------------- //
+simon_cfg_seq_gen i_seq_gen
+(
+    .clk        (clk),
+    .arst_n     (arst_n),
+
+    .mode_i     (mode_i),
+    .cfg_i      (cfg_i),
+
+    .rst_seqs_i (srst_i),
+    .rst_mode_i (srst_mode_i),
+    .rst_cfg_i  (srst_cfg_i),
+    .run_en_i   (key_run_en_i),
+
+    .seq_o      (seq)
+);
+
+// -- Key Schedule -------------------------------------------------------------------------------- //
+assign c_xor_z = C_TABLE[cfg_i] ^ seq;
+
+simon_cfg_key_schedule
+#(
+    .WW_MAX     (WW_MAX),
+    .NKW_MAX    (NKW_MAX)
+)
+i_key_schedule
+(
+    .ww_sel_i   (ww_sel),
+    .nkw_i      (nkw),
+    .mode_i     (mode_i),
+
+    .key_cur_i  (key_r),
+    .c_xor_z_i  (c_xor_z),
+
+    .key_nxt_o  (key_nxt)
+);
+
+// -- Round Function ------------------------------------------------------------------------------ //
+simon_cfg_round
+#(
+    .WW_MAX (WW_MAX)
+)
+i_round
+(
+    .ww_sel_i (ww_sel),
+
+    .key_i    (key_r[0]),
+
+    .x_i      (pt_r[1]),
+    .y_i      (pt_r[0]),
+
+    .x_o      (pt_nxt[1]),
+    .y_o      (pt_nxt[0])
+);
+
+// -- Outputs ------------------------------------------------------------------------------------- //
+assign ct_o     = pt_r;
+assign ct_nxt_o = pt_nxt;
+assign key_o    = key_r[0];
+
+// -- Design Parameter Assertions ----------------------------------------------------------------- //
+// synthesis translate_off
+initial begin
+    #0 assert (WW_MAX inside {16, 24, 32, 48, 64}) else $error("Illegal WW_MAX parameter value %0d -- legal values: 16, 24, 32, 48, 64", WW_MAX);
+    #0 assert (NKW_MAX inside {2, 3, 4}) else $error("Illegal NKW_MAX parameter value %0d -- legal values: 2, 3, 4", NKW_MAX);
+end
+// synthesis translate_on
+
+// -- Assertion Properties ------------------------------------------------------------------------ //
+// synthesis translate_off
+assert property (@(posedge clk) disable iff(!arst_n)
+    (pt_run_en_i | key_run_en_i) |-> (simon_cfg_ww(cfg_i) <= WW_MAX) && (simon_cfg_nkw(cfg_i) <= NKW_MAX) && (cfg_i < SIMON_N_CFGS))
+    else $error("Configuration %0d is not supported by the datapath (WW_MAX=%0d, NKW_MAX=%0d)", cfg_i, WW_MAX, NKW_MAX);
+// synthesis translate_on
+
+endmodule
@@ -0,0 +1,98 @@
+/**
+ * @info NSA's Simon key schedule algorithm with a runtime configuration (combinational logic)
+ *
+ * @author Anastasios Psarras (a.psarras4225@gmail.com)
+ *
+ * @license MIT license, check license.md
+ *
+ * @brief Same key schedule as simon_key_schedule, on NKW_MAX key words of WW_MAX bits hosting a word size n and a
+ *        number of key words m selected at runtime (see simon_cfg_top). n-bit words sit in the low bits of the
+ *        datapath words, with the upper bits at zero, and the rotations are masked to n bits. Only the first m key
+ *        words are used: the new key word goes to word m-1, and the words above it are don't care.
+ *
+ * @param WW_MAX    Datapath word width (largest word size supported)
+ * @param NKW_MAX   Number of datapath key words (largest number of key words supported)
+ */
+
+module simon_cfg_key_schedule
+#(
+    parameter int WW_MAX    = 64,
+    parameter int NKW_MAX   = 4
+)
+(
+    input  logic[2:0]                       ww_sel_i,   // word size n: 0: 16, 1: 24, 2: 32, 3: 48, 4: 64
+    input  logic[2:0]                       nkw_i,      // number of key words m (2..NKW_MAX)
+    input  logic                            mode_i,     // 0 for encryption, 1 for decryption
+    input  logic[NKW_MAX-1:0][WW_MAX-1:0]   key_cur_i,  // key word inputs
+    input  logic[WW_MAX-1:0]                c_xor_z_i,  // xor'ed outside (masked to n bits)
+
+    output logic[NKW_MAX-1:0][WW_MAX-1:0]   key_nxt_o   // key word outputs
+);
+
+// -- Constants ----------------------------------------------------------------------------------- //
+localparam int N_WW = 5;
+localparam int WWS[N_WW] = '{16, 24, 32, 48, 64};
+
+// -- Right Rotation on n bits handy function ----------------------------------------------------- //
+function automatic logic[WW_MAX-1:0] rot_right(input logic[WW_MAX-1:0] a, input int n, input logic[2:0] ww_sel);
+    logic[WW_MAX-1:0] res;
+    res = '0;
+    for (int w=0; w<N_WW; w++) begin
+        if ((WWS[w] <= WW_MAX) && (ww_sel == w)) begin
+            for (int b=0; b<WWS[w]; b++) begin
+                res[b] = a[(b + n) % WWS[w]];
+            end
+        end
+    end
+    return res;
+endfunction
+
+// -- Comb Logic ---------------------------------------------------------------------------------- //
+// m = 2:  k_rr3 = k1 >>> 3
+// m = 3:  k_rr3 = k2 >>> 3 (encryption) or k1 >>> 3 (decryption)
+// m = 4:  k_rr3 = (k3 >>> 3) ^ k1 (encryption) or (k1 >>> 3) ^ k3 (decryption)
+logic[WW_MAX-1:0] key_to_rot;
+logic[WW_MAX-1:0] key_to_xor;
+logic[WW_MAX-1:0] k_rr3;
+logic[WW_MAX-1:0] xor_all;
+
+always_comb begin: comb_key_sel
+    key_to_rot = key_cur_i[1];
+    key_to_xor = '0;
+    for (int m=2; m<=NKW_MAX; m++) begin
+        if (nkw_i == m) begin
+            if (!mode_i) begin
+                key_to_rot = key_cur_i[m-1];
+            end
+            if (m == 4) begin
+                key_to_xor = mode_i ? key_cur_i[m-1] : key_cur_i[1];
+            end
+        end
+    end
+end
+
+assign k_rr3    = rot_right(key_to_rot, 3, ww_sel_i) ^ key_to_xor;
+assign xor_all  = k_rr3 ^ key_cur_i[0] ^ rot_right(k_rr3, 1, ww_sel_i) ^ c_xor_z_i;
+
+// -- Outputs ------------------------------------------------------------------------------------- //
+always_comb begin: comb_key_nxt
+    for (int i=0; i<(NKW_MAX-1); i++) begin
+        key_nxt_o[i] = key_cur_i[i+1];
+    end
+    key_nxt_o[NKW_MAX-1] = key_cur_i[NKW_MAX-1];
+    for (int m=2; m<=NKW_MAX; m++) begin
+        if (nkw_i == m) begin
+            key_nxt_o[m-1] = xor_all;
+        end
+    end
+end
+
+// -- Design Parameter Assertions ----------------------------------------------------------------- //
+// synthesis translate_off
+initial begin
+    #0 assert (WW_MAX inside {16, 24, 32, 48, 64}) else $error("Illegal WW_MAX parameter value %0d -- legal values: 16, 24, 32, 48, 64", WW_MAX);
+    #0 assert (NKW_MAX inside {2, 3, 4}) else $error("Illegal NKW_MAX parameter value %0d -- legal values: 2, 3, 4", NKW_MAX);
+end
+// synthesis translate_on
+
+endmodule
@@ -0,0 +1,58 @@
+/**
+ * @info NSA's Simon round algorithm with a runtime word size (combinational logic)
+ *
+ * @author Anastasios Psarras (a.psarras4225@gmail.com)
+ *
+ * @license MIT license, check license.md
+ *
+ * @brief Same round as simon_round, on a fixed WW_MAX-bit datapath hosting a word size n selected at runtime
+ *        (see simon_cfg_top): n-bit words sit in the low bits of the datapath words, with the upper bits at zero,
+ *        and the rotations are masked to n bits.
+ *
+ * @param WW_MAX    Datapath word width (largest word size supported)
+ */
+
+module simon_cfg_round
+#(
+    parameter int WW_MAX    = 64
+)
+(
+    input  logic[2:0]           ww_sel_i,   // word size n: 0: 16, 1: 24, 2: 32, 3: 48, 4: 64
+
+    input  logic[WW_MAX-1:0]    key_i,
+    input  logic[WW_MAX-1:0]    x_i,
+    input  logic[WW_MAX-1:0]    y_i,
+
+    output logic[WW_MAX-1:0]    x_o,
+    output logic[WW_MAX-1:0]    y_o
+);
+
+// -- Constants ----------------------------------------------------------------------------------- //
+localparam int N_WW = 5;
+localparam int WWS[N_WW] = '{16, 24, 32, 48, 64};
+
+// -- Left Rotation on n bits handy function ------------------------------------------------------ //
+// only the word sizes that fit the datapath are selectable
+function automatic logic[WW_MAX-1:0] rot_left(input logic[WW_MAX-1:0] a, input int n, input logic[2:0] ww_sel);
+    logic[WW_MAX-1:0] res;
+    res = '0;
+    for (int w=0; w<N_WW; w++) begin
+        if ((WWS[w] <= WW_MAX) && (ww_sel == w)) begin
+            for (int b=0; b<WWS[w]; b++) begin
+                res[b] = a[(b + WWS[w] - n) % WWS[w]];
+            end
+        end
+    end
+    return res;
+endfunction
+
+// -- Outputs -- //
+assign y_o = x_i;
+assign x_o = y_i ^ (rot_left(x_i, 1, ww_sel_i) & rot_left(x_i, 8, ww_sel_i)) ^ rot_left(x_i, 2, ww_sel_i) ^ key_i;
+
+// synthesis translate_off
+initial begin
+    #0 assert (WW_MAX inside {16, 24, 32, 48, 64}) else $error("Illegal WW_MAX parameter value %0d -- legal values: 16, 24, 32, 48, 64", WW_MAX);
+end
+// synthesis translate_on
+endmodule
@@ -0,0 +1,124 @@
+/**
+ * @info NSA's Simon sequence generator with a runtime configuration
+ *
+ * @author Anastasios Psarras (a.psarras4225@gmail.com)
+ *
+ * @license MIT license, check license.md
+ *
+ * @brief Produces the z_j sequence of the configuration selected at runtime (see simon_cfg_top), one bit per
+ *        enabled cycle. Same scheme as simon_seq_gen, with a single LFSR holding all six matrices (U, V, W & their
+ *        reverse): the z sequence (and thus the matrix) follows cfg_i, and the LFSR & t sequence seeds follow
+ *        rst_cfg_i on a sequence reset -- the configuration of the next block, which may differ from the one of the
+ *        block in its last round (see simon_ctrl_fsm).
+ */
+
+module simon_cfg_seq_gen
+(
+    input  logic                                    clk,        // clock, @posedge
+    input  logic                                    arst_n,     // async reset -- active low
+
+    input  logic                                    mode_i,     // 0 for encrypt, 1 for decrypt
+    input  logic[simon_const_pkg::SIMON_CFG_W-1:0]  cfg_i,      // configuration of the running block
+
+    input  logic                                    rst_seqs_i, // resets sequences
+    input  logic                                    rst_mode_i, // mode the sequences are reset to (may differ from mode_i, see simon_ctrl_fsm)
+    input  logic[simon_const_pkg::SIMON_CFG_W-1:0]  rst_cfg_i,  // configuration the sequences are reset to (may differ from cfg_i)
+    input  logic                                    run_en_i,   // should be set to '1' when the algo is running (enables lfsr etc)
+
+    output logic                                    seq_o       // output sequence bit
+);
+
+// -- Module Self-Configuration ------------------------------------------------------------------- //
+import simon_const_pkg::*;
+localparam int                              LFSR_N          = SIMON_LFSR_N;
+localparam int                              LFSR_C          = 6;
+localparam int                              N_CFG_ENTRIES   = 1 << SIMON_CFG_W;
+// configuration c of the LFSR: c = vector (0: U, 1: V, 2: W) + 3*mode (see simon_const_pkg)
+localparam logic[LFSR_C-1:0][0:LFSR_N-1][0:LFSR_N-1]    LFSR_MATRICES = '{SIMON_LFSR_WR, SIMON_LFSR_VR, SIMON_LFSR_UR,
+                                                                          SIMON_LFSR_W,  SIMON_LFSR_V,  SIMON_LFSR_U};
+localparam logic[LFSR_N-1:0]                LFSR_SEQ_RST_ENC    = SIMON_LFSR_SEED;
+localparam logic                            T_SEQ_RST_ENC       = 1'b0;
+
+// Per-configuration tables (illegal configuration indices map to zeros)
+typedef struct packed {
+    logic[1:0]          vec;        // LFSR vector: 0: U (z0, z2), 1: V (z1, z3), 2: W (z4)
+    logic               t_en;       // z = LFSR ^ t (z2, z3, z4)
+    logic[LFSR_N-1:0]   lfsr_dec;   // decryption LFSR seed
+    logic               t_dec;      // decryption t seed (don't care without t)
+} cfg_seq_t;
+
+function automatic logic[N_CFG_ENTRIES-1:0][$bits(cfg_seq_t)-1:0] cfg_table();
+    logic[N_CFG_ENTRIES-1:0][$bits(cfg_seq_t)-1:0] tab;
+    cfg_seq_t e;
+    tab = '0;
+    for (int c=0; c<SIMON_N_CFGS; c++) begin
+        e.vec       = (simon_z_seq(simon_cfg_ww(c), simon_cfg_nkw(c)) == 4) ? 2'd2 : 2'(simon_z_seq(simon_cfg_ww(c), simon_cfg_nkw(c)) % 2);
+        e.t_en      = simon_z_seq(simon_cfg_ww(c), simon_cfg_nkw(c)) >= 2;
+        e.lfsr_dec  = simon_lfsr_seed_dec(simon_cfg_ww(c), simon_cfg_nkw(c));
+        e.t_dec     = simon_t_seed_dec(simon_cfg_ww(c), simon_cfg_nkw(c));
+        tab[c]      = e;
+    end
+    return tab;
+endfunction
+
+localparam logic[N_CFG_ENTRIES-1:0][$bits(cfg_seq_t)-1:0] CFG_TABLE = cfg_table();
+
+// -- Signals ------------------------------------------------------------------------------------- //
+cfg_seq_t           run_cfg;
+cfg_seq_t           rst_cfg;
+logic               lfsr_outp;
+logic[LFSR_C-1:0]   conf_sel;
+logic[LFSR_N-1:0]   seq_rst;
+logic               t_seq_r;
+
+assign run_cfg  = CFG_TABLE[cfg_i];
+assign rst_cfg  = CFG_TABLE[rst_cfg_i];
+
+// -- LFSR Instance ------------------------------------------------------------------------------- //
+assign conf_sel = 1 << (run_cfg.vec + (mode_i ? 3 : 0));
+assign seq_rst  = rst_mode_i ? rst_cfg.lfsr_dec : LFSR_SEQ_RST_ENC;
+lfsr_multi_config
+#(
+    .N              (LFSR_N),
+    .C              (LFSR_C),
+    .MATRICES       (LFSR_MATRICES),
+    .STEPS          (1)
+)
+i_lfsr
+(
+    .clk            (clk),
+    .arst_n         (arst_n),
+
+    .seq_ld_en_i    (rst_seqs_i),
+    .seq_i          (seq_rst),
+
+    .conf_sel_i     (conf_sel),
+
+    .run_en_i       (run_en_i),
+    .outp_o         (lfsr_outp)
+);
+
+// -- Output -------------------------------------------------------------------------------------- //
+// the LFSR output is XOR'ed with the period-2 t sequence t = 010101... for z2, z3 & z4
+always_ff @(posedge clk, negedge arst_n) begin: ff_t_seq
+    if (!arst_n) begin
+        t_seq_r <= 1'b0;
+    end else begin
+        if (rst_seqs_i) begin
+            t_seq_r <= rst_mode_i ? rst_cfg.t_dec : T_SEQ_RST_ENC;
+        end else if (run_en_i) begin
+            t_seq_r <= ~t_seq_r;
+        end
+    end
+end
+
+assign seq_o = lfsr_outp ^ (run_cfg.t_en & t_seq_r);
+
+// -- Assertion Properties ------------------------------------------------------------------------ //
+// synthesis translate_off
+assert property (@(posedge clk) disable iff(!arst_n)
+    !(rst_seqs_i & run_en_i)) else $error("Only one operation possible in each cycle, either sequence reset (rst_seqs_i=1) or enc/dec running (run_en_i=1), never both.");
+assert property (@(posedge clk) disable iff(!arst_n)
+    rst_seqs_i |-> (rst_cfg_i < SIMON_N_CFGS)) else $error("Illegal rst_cfg_i value %0d -- legal values: 0..%0d", rst_cfg_i, SIMON_N_CFGS-1);
+// synthesis translate_on
+endmodule
@@ -0,0 +1,335 @@
+/**
+ * @info NSA's Simon cipher top module with a runtime configuration
+ *
+ * @author Anastasios Psarras (a.psarras4225@gmail.com)
+ *
+ * @license MIT license, check license.md
+ *
+ * @brief Simon implementation whose configuration (n, m) is selected per block through cfg_i, instead of the WW and
+ *        NKW parameters of simon_top -- a single engine serving several configurations instead of one mostly idle
+ *        instance each. cfg_i is the index of the configuration in the table below (simon_const_pkg::simon_cfg_idx):
+ *
+ *              --------------------------------------------------------
+ *             |  cfg  |  block  |   key   |  word  |   key   | rounds |
+ *             |       | size 2n | size mn | size n | words m |   T    |
+ *             |--------------------------------------------------------|
+ *             |   0   |   32    |   64    |   16   |    4    |  32    |
+ *             |   1   |   48    |   72    |   24   |    3    |  36    |
+ *             |   2   |   48    |   96    |   24   |    4    |  36    |
+ *             |   3   |   64    |   96    |   32   |    3    |  42    |
+ *             |   4   |   64    |   128   |   32   |    4    |  44    |
+ *             |   5   |   96    |   96    |   48   |    2    |  52    |
+ *             |   6   |   96    |   144   |   48   |    3    |  54    |
+ *             |   7   |   128   |   128   |   64   |    2    |  68    |
+ *             |   8   |   128   |   192   |   64   |    3    |  69    |
+ *             |   9   |   128   |   256   |   64   |    4    |  72    |
+ *              --------------------------------------------------------
+ *
+ *        The datapath is WW_MAX bits wide with NKW_MAX key words: n-bit words are passed in the low bits of pt_i/key_i
+ *        words (upper bits at zero), the first m key words are used, and ct_o words have their upper bits at zero.
+ *        Configurations with n > WW_MAX or m > NKW_MAX are not supported. The rotations of the round & key schedule
+ *        are masked to n bits (simon_cfg_round, simon_cfg_key_schedule), the sequence generator selects the z
+ *        sequence, LFSR matrices & seeds per block (simon_cfg_seq_gen) and simon_ctrl_fsm takes the T of the block.
+ *
+ *        Same ready/valid interfaces, input staging & output holding registers and timing as simon_top with
+ *        UNROLL = 1 (the round counts of the configurations have no common divisor) and no key cache, session key or
+ *        round key RAM: T cycles per encryption, 2T+1 per decryption.
+ *
+ * @param WW_MAX    Datapath word width (largest word size supported)
+ * @param NKW_MAX   Number of datapath key words (largest number of key words supported)
+ * @param DATA_RST  Sets whether the plaintext & key registers are resettable to zero (for testability?)
+ *                  Note that resettable data FFs will result to a higher area footprint
+ */
+
+module simon_cfg_top
+#(
+    parameter int   WW_MAX      = 64,
+    parameter int   NKW_MAX     = 4,
+    parameter logic DATA_RST    = 1'b0
+)
+(
+    input  logic                                    clk,        // clock, @posedge
+    input  logic                                    arst_n,     // async reset -- active low
+    // Activity
+    output logic                                    active_o,   // indicates when there's activity in the block (for architectural clock gating perhaps?)
+    // Input Interface
+    input  logic                                    valid_i,    // when asserted, it indicates that input is valid and the block must start processing pt_i/key_i
+    output logic                                    ready_o,    // when asserted and valid_i is also asserted, the input has been accepted (input staging register is empty)
+    input  logic                                    mode_i,     // 0: encrypt / 1: decrypt (only matters when valid_i is asserted)
+    input  logic[simon_const_pkg::SIMON_CFG_W-1:0]  cfg_i,      // configuration index (only matters when valid_i is asserted)
+    input  logic[2-1:0][WW_MAX-1:0]                 pt_i,       // input plaintext
+    input  logic[NKW_MAX-1:0][WW_MAX-1:0]           key_i,      // input key
+    // Output Interface
+    output logic                                    valid_o,    // when asserted, a plaintext/ciphertext-key pair has been processed and ct_o contains valid data
+    input  logic                                    ready_i,    // when asserted and valid_o is also asserted, output ct_o is considered as read
+    output logic                                    mode_o,     // 0: encrypt / 1: decrypt (only matters when valid_o is asserted)
+    output logic[simon_const_pkg::SIMON_CFG_W-1:0]  cfg_o,      // configuration index of the output (only matters when valid_o is asserted)
+    output logic[2-1:0][WW_MAX-1:0]                 ct_o        // output ciphertext (on encryption mode), or plaintext (on decryption mode)
+);
+
+// -- Constants ----------------------------------------------------------------------------------- //
+import simon_const_pkg::*;
+// the FSM is sized for the largest configuration
+localparam int FSM_WW           = 64;
+localparam int FSM_NKW          = 4;
+localparam int RND_W            = simon_rounds_w(FSM_WW, FSM_NKW);
+localparam int N_CFG_ENTRIES    = 1 << SIMON_CFG_W;
+
+// number of rounds T of each configuration
+function automatic logic[N_CFG_ENTRIES-1:0][RND_W-1:0] rounds_table();
+    logic[N_CFG_ENTRIES-1:0][RND_W-1:0] tab;
+    tab = '0;
+    for (int c=0; c<SIMON_N_CFGS; c++) begin
+        tab[c] = RND_W'(simon_n_rounds(simon_cfg_ww(c), simon_cfg_nkw(c)));
+    end
+    return tab;
+endfunction
+
+localparam logic[N_CFG_ENTRIES-1:0][RND_W-1:0] ROUNDS_TABLE = rounds_table();
+
+// -- Signal Definitions -------------------------------------------------------------------------- //
+// FSM to Core signals
+logic                           fsm2core_srst;
+logic                           fsm2core_srst_mode;
+logic                           fsm2core_mode;
+logic                           fsm2core_pt_ld_en;
+logic                           fsm2core_pt_run_en;
+logic                           fsm2core_key_ld_en;
+logic                           fsm2core_key_run_en;
+logic[FSM_NKW-1:0]              fsm_key_reg_ld_en;
+logic                           fsm_key_reg_sel;
+logic[WW_MAX-1:0]               core_key;
+logic[NKW_MAX-1:0][WW_MAX-1:0]  dec_keys_r;
+logic[NKW_MAX-1:0][WW_MAX-1:0]  core_keys_to_load;
+logic[2-1:0][WW_MAX-1:0]        core_ct_nxt;
+// Configuration of the running block
+logic[SIMON_CFG_W-1:0]          run_cfg_r;
+// Input staging register
+logic                           in_valid_r;
+logic                           in_mode_r;
+logic[SIMON_CFG_W-1:0]          in_cfg_r;
+logic[2-1:0][WW_MAX-1:0]        in_pt_r;
+logic[NKW_MAX-1:0][WW_MAX-1:0]  in_key_r;
+logic                           in_ld_en;
+logic                           in_pop;         // from the FSM: the staged input has been loaded into the core
+// Output holding register
+logic                           out_valid_r;
+logic                           out_mode_r;
+logic[SIMON_CFG_W-1:0]          out_cfg_r;
+logic[2-1:0][WW_MAX-1:0]        out_ct_r;
+logic                           out_ld_en;
+logic                           fsm_out_valid;  // from the FSM: a result is on core_ct_nxt
+logic                           fsm_out_ready;  // to the FSM: the holding register is (or is about to be) empty
+logic                           fsm_out_mode;
+logic                           fsm_active;
+
+// -- Input Staging Register ---------------------------------------------------------------------- //
+assign ready_o  = ~in_valid_r;
+assign in_ld_en = valid_i & ~in_valid_r;
+
+always_ff @(posedge clk, negedge arst_n) begin: ff_in_valid
+    if (!arst_n) begin
+        in_valid_r <= 1'b0;
+    end else begin
+        if (in_ld_en) begin
+            in_valid_r <= 1'b1;
+        end else if (in_pop) begin
+            in_valid_r <= 1'b0;
+        end
+    end
+end
+
+// -- Output Holding Register --------------------------------------------------------------------- //
+assign fsm_out_ready    = ~out_valid_r | ready_i;
+assign out_ld_en        = fsm_out_valid & fsm_out_ready;
+
+always_ff @(posedge clk, negedge arst_n) begin: ff_out_valid
+    if (!arst_n) begin
+        out_valid_r <= 1'b0;
+    end else begin
+        if (out_ld_en) begin
+            out_valid_r <= 1'b1;
+        end else if (ready_i) begin
+            out_valid_r <= 1'b0;
+        end
+    end
+end
+
+assign valid_o  = out_valid_r;
+assign mode_o   = out_mode_r;
+assign cfg_o    = out_cfg_r;
+assign ct_o     = out_ct_r;
+assign active_o = fsm_active | out_valid_r | valid_i;
+
+// -- Control Registers --------------------------------------------------------------------------- //
+// The configuration of the running block follows the staged one each time the FSM (re)loads the core's keys: at the
+// start of a block, and at the start of a decryption's run -- after the last round of the previous block
+always_ff @(posedge clk, negedge arst_n) begin: ff_ctrl_regs
+    if (!arst_n) begin
+        in_mode_r   <= 1'b0;
+        in_cfg_r    <= '0;
+        run_cfg_r   <= '0;
+        out_mode_r  <= 1'b0;
+        out_cfg_r   <= '0;
+    end else begin
+        if (in_ld_en) begin
+            in_mode_r   <= mode_i;
+            in_cfg_r    <= cfg_i;
+        end
+        if (fsm2core_key_ld_en) begin
+            run_cfg_r   <= in_cfg_r;
+        end
+        if (out_ld_en) begin
+            out_mode_r  <= fsm_out_mode;
+            out_cfg_r   <= run_cfg_r;
+        end
+    end
+end
+
+// -- Control FSM --------------------------------------------------------------------------------- //
+simon_ctrl_fsm
+#(
+    .WW                 (FSM_WW),
+    .NKW                (FSM_NKW),
+    .UNROLL             (1),
+    .RK_RAM             (1'b0)
+)
+i_ctrl_fsm
+(
+    .clk                (clk),
+    .arst_n             (arst_n),
+
+    .active_o           (fsm_active),
+    .key_prep_o         (),
+
+    .valid_i            (in_valid_r),
+    .ready_o            (in_pop),
+    .mode_i             (in_mode_r),
+    .n_rounds_i         (ROUNDS_TABLE[run_cfg_r]),
+
+    .core_srst_o        (fsm2core_srst),
+    .core_srst_mode_o   (fsm2core_srst_mode),
+    .core_mode_o        (fsm2core_mode),
+    .core_pt_ld_en_o    (fsm2core_pt_ld_en),
+    .core_pt_run_en_o   (fsm2core_pt_run_en),
+    .core_key_ld_en_o   (fsm2core_key_ld_en),
+    .core_key_run_en_o  (fsm2core_key_run_en),
+    .core_rk_cnt_o      (),
+    .core_last_o        (),
+    .core_rnd_en_o      (),
+
+    .rk_hit_i           (1'b0),
+    .rk_wr_en_o         (),
+    .rk_rd_en_o         (),
+    .rk_tag_ld_o        (),
+    .rk_valid_set_o     (),
+
+    .key_reg_ld_en_o    (fsm_key_reg_ld_en),
+    .key_reg_sel_o      (fsm_key_reg_sel),
+    .key_hit_i          (1'b0),
+    .key_fill_o         (),
+
+    .valid_o            (fsm_out_valid),
+    .ready_i            (fsm_out_ready),
+    .mode_o             (fsm_out_mode)
+);
+
+// -- Data Registers ------------------------------------------------------------------------------ //
+// key reg i captures k_(T-1-i) of the running configuration (only the first m ones are used)
+if (DATA_RST) begin: g_if_data_rst
+    always_ff @(posedge clk, negedge arst_n) begin: ff_data_regs
+        if (!arst_n) begin
+            dec_keys_r  <= '0;
+            in_pt_r     <= '0;
+            in_key_r    <= '0;
+            out_ct_r    <= '0;
+        end else begin
+            for (int i=0; i<NKW_MAX; i++) begin
+                if (fsm_key_reg_ld_en[i]) begin
+                    dec_keys_r[i] <= core_key;
+                end
+            end
+            if (in_ld_en) begin
+                in_pt_r     <= pt_i;
+                in_key_r    <= key_i;
+            end
+            if (out_ld_en) begin
+                out_ct_r    <= core_ct_nxt;
+            end
+        end
+    end
+end else begin: g_if_not_data_rst
+    always_ff @(posedge clk) begin: ff_data_regs
+        for (int i=0; i<NKW_MAX; i++) begin
+            if (fsm_key_reg_ld_en[i]) begin
+                dec_keys_r[i] <= core_key;
+            end
+        end
+        if (in_ld_en) begin
+            in_pt_r     <= pt_i;
+            in_key_r    <= key_i;
+        end
+        if (out_ld_en) begin
+            out_ct_r    <= core_ct_nxt;
+        end
+    end
+end
+
+// -- Simon Core ---------------------------------------------------------------------------------- //
+assign core_keys_to_load = fsm_key_reg_sel ? dec_keys_r : in_key_r;
+
+simon_cfg_core
+#(
+    .WW_MAX             (WW_MAX),
+    .NKW_MAX            (NKW_MAX),
+    .DATA_RST           (DATA_RST)
+)
+i_core
+(
+    .clk                (clk),
+    .arst_n             (arst_n),
+
+    .cfg_i              (run_cfg_r),
+    .srst_i             (fsm2core_srst),
+    .srst_mode_i        (fsm2core_srst_mode),
+    .srst_cfg_i         (in_cfg_r),
+    .mode_i             (fsm2core_mode),
+
+    .pt_ld_en_i         (fsm2core_pt_ld_en),
+    .pt_run_en_i        (fsm2core_pt_run_en),
+    .pt_i               (in_pt_r),
+
+    .key_ld_en_i        (fsm2core_key_ld_en),
+    .key_run_en_i       (fsm2core_key_run_en),
+    .key_i              (core_keys_to_load),
+
+    .ct_o               (),
+    .ct_nxt_o           (core_ct_nxt),
+    .key_o              (core_key)
+);
+
+// -- Assertion Properties ------------------------------------------------------------------------ //
+// synthesis translate_off
+// input interface
+assert property (@(posedge clk) disable iff(!arst_n)
+    valid_i & ~ready_o |=> $stable({key_i, pt_i, cfg_i, mode_i})) else $error("mode_i, cfg_i, pt_i and key_i should remain stable when valid_i=1 and ready_o=0");
+assert property (@(posedge clk) disable iff(!arst_n)
+    valid_i & ~ready_o |=> valid_i) else $error("valid_i should remain HIGH while ready_o=0");
+assert property (@(posedge clk) disable iff(!arst_n)
+    valid_i |-> (cfg_i < SIMON_N_CFGS) && (simon_cfg_ww(cfg_i) <= WW_MAX) && (simon_cfg_nkw(cfg_i) <= NKW_MAX))
+    else $error("Configuration cfg_i=%0d is not supported (WW_MAX=%0d, NKW_MAX=%0d)", cfg_i, WW_MAX, NKW_MAX);
+// output interface
+assert property (@(posedge clk) disable iff(!arst_n)
+    valid_o & ~ready_i |=> $stable({ct_o, cfg_o, mode_o})) else $error("mode_o, cfg_o and ct_o should remain stable when valid_o=1 and ready_i=0");
+assert property (@(posedge clk) disable iff(!arst_n)
+    valid_o & ~ready_i |=> valid_o) else $error("valid_o should remain HIGH while ready_i=0");
+// synthesis translate_on
+
+// -- Design Parameter Assertions ----------------------------------------------------------------- //
+// synthesis translate_off
+initial begin
+    #0 assert (WW_MAX inside {16, 24, 32, 48, 64}) else $error("Illegal WW_MAX parameter value %0d -- legal values: 16, 24, 32, 48, 64", WW_MAX);
+    #0 assert (NKW_MAX inside {2, 3, 4}) else $error("Illegal NKW_MAX parameter value %0d -- legal values: 2, 3, 4", NKW_MAX);
+end
+// synthesis translate_on
+endmodule
@@ -12,4 +12,175 @@ package simon_const_pkg;
 localparam logic MODE_ENC = 1'b0;
 localparam logic MODE_DEC = 1'b1;
 
+// Block ciphers (see simon_top's SPECK)
+localparam logic ALG_SIMON = 1'b0;
+localparam logic ALG_SPECK = 1'b1;
+
+// Modes of operation (see simon_mode_top)
+localparam logic[1:0] OP_ECB = 2'd0;
+localparam logic[1:0] OP_CBC = 2'd1;
+localparam logic[1:0] OP_CTR = 2'd2;
+
+// Statistics registers (see simon_stats)
+localparam int          STATS_AW        = 4;
+localparam int          STATS_DW        = 32;
+localparam logic[3:0]   STATS_N_ENC     = 4'd0;     // encryptions handed out
+localparam logic[3:0]   STATS_N_DEC     = 4'd1;     // decryptions handed out
+localparam logic[3:0]   STATS_ACTIVE    = 4'd2;     // cycles with active_o asserted
+localparam logic[3:0]   STATS_STALL     = 4'd3;     // cycles with a result held back by ready_i
+localparam logic[3:0]   STATS_IDLE      = 4'd4;     // cycles with nothing to do, waiting for valid_i
+localparam logic[3:0]   STATS_KEY_RUN   = 4'd5;     // decryption key prepare cycles
+localparam logic[3:0]   STATS_LAT_MIN   = 4'd6;     // min latency, input to output handshake (cycles)
+localparam logic[3:0]   STATS_LAT_MAX   = 4'd7;     // max latency
+localparam logic[3:0]   STATS_LAT_SUM   = 4'd8;     // sum of the latencies (avg = sum / (N_ENC + N_DEC))
+
+// Number of rounds T of Simon 2n/mn, with n = ww and m = nkw (0 for illegal configurations)
+function automatic int simon_n_rounds(int ww, int nkw);
+    return (ww == 16) && (nkw == 4) ? 32 :
+           (ww == 24) && (nkw == 3) ? 36 :
+           (ww == 24) && (nkw == 4) ? 36 :
+           (ww == 32) && (nkw == 3) ? 42 :
+           (ww == 32) && (nkw == 4) ? 44 :
+           (ww == 48) && (nkw == 2) ? 52 :
+           (ww == 48) && (nkw == 3) ? 54 :
+           (ww == 64) && (nkw == 2) ? 68 :
+           (ww == 64) && (nkw == 3) ? 69 :
+           (ww == 64) && (nkw == 4) ? 72 :
+                                      0;
+endfunction
+
+// Number of rounds T of Speck 2n/mn, for the same (n, m) pairs (0 for illegal configurations) -- always below Simon's
+function automatic int speck_n_rounds(int ww, int nkw);
+    return (ww == 16) && (nkw == 4) ? 22 :
+           (ww == 24) && (nkw == 3) ? 22 :
+           (ww == 24) && (nkw == 4) ? 23 :
+           (ww == 32) && (nkw == 3) ? 26 :
+           (ww == 32) && (nkw == 4) ? 27 :
+           (ww == 48) && (nkw == 2) ? 28 :
+           (ww == 48) && (nkw == 3) ? 29 :
+           (ww == 64) && (nkw == 2) ? 32 :
+           (ww == 64) && (nkw == 3) ? 33 :
+           (ww == 64) && (nkw == 4) ? 34 :
+                                      0;
+endfunction
+
+// Number of run cycles of a block with unroll rounds per cycle (the last one runs the remaining T % unroll rounds,
+// if any), and width of the round counter
+function automatic int simon_n_cycles(int ww, int nkw, int unroll);
+    return (simon_n_rounds(ww, nkw) + unroll - 1) / unroll;
+endfunction
+
+function automatic int simon_cnt_w(int ww, int nkw, int unroll);
+    return simon_n_cycles(ww, nkw, unroll) > 1 ? $clog2(simon_n_cycles(ww, nkw, unroll)) : 1;
+endfunction
+
+// Width of a round count 0..T (0 for illegal configurations)
+function automatic int simon_rounds_w(int ww, int nkw);
+    return $clog2(simon_n_rounds(ww, nkw) + 1);
+endfunction
+
+// Runtime configurations (see simon_cfg_top): index c of Simon 2n/mn, in the order of the configuration table
+localparam int SIMON_N_CFGS = 10;
+localparam int SIMON_CFG_W  = 4;
+
+function automatic int simon_cfg_ww(int c);
+    return c == 0 ? 16 :
+           c <= 2 ? 24 :
+           c <= 4 ? 32 :
+           c <= 6 ? 48 :
+           c <= 9 ? 64 :
+                     0;
+endfunction
+
+function automatic int simon_cfg_nkw(int c);
+    return c == 0            ? 4 :
+           c == 1            ? 3 :
+           c == 2            ? 4 :
+           c == 3            ? 3 :
+           c == 4            ? 4 :
+           c == 5            ? 2 :
+           c == 6            ? 3 :
+           c == 7            ? 2 :
+           c == 8            ? 3 :
+           c == 9            ? 4 :
+                               0;
+endfunction
+
+// Index of the configuration of Simon 2n/mn (SIMON_N_CFGS for illegal configurations)
+function automatic int simon_cfg_idx(int ww, int nkw);
+    for (int c=0; c<SIMON_N_CFGS; c++) begin
+        if ((simon_cfg_ww(c) == ww) && (simon_cfg_nkw(c) == nkw)) begin
+            return c;
+        end
+    end
+    return SIMON_N_CFGS;
+endfunction
+
+// Constant sequences z0..z4 -- bit j of SIMON_Z[i] is z_i[j] (period 62)
+localparam logic[4:0][61:0] SIMON_Z = {62'h3dc94c3a046d678b,    // z4
+                                       62'h3c2ce51207a635db,    // z3
+                                       62'h3369f885192c0ef5,    // z2
+                                       62'h16864fb8ad0c9f71,    // z1
+                                       62'h19c3522fb386a45f};   // z0
+
+// Index i of the z_i sequence used by Simon 2n/mn, with n = ww and m = nkw
+function automatic int simon_z_seq(int ww, int nkw);
+    return (ww == 16 && nkw == 4) || (ww == 24 && nkw == 3)                         ? 0 :
+           (ww == 24 && nkw == 4)                                                   ? 1 :
+           (ww == 32 && nkw == 3) || (ww == 48 && nkw == 2) || (ww == 64 && nkw == 2) ? 2 :
+           (ww == 32 && nkw == 4) || (ww == 48 && nkw == 3) || (ww == 64 && nkw == 3) ? 3 :
+                                                                                      4;
+endfunction
+
+// Bit j of the z sequence used by Simon 2n/mn
+function automatic logic simon_z_bit(int ww, int nkw, int j);
+    return SIMON_Z[simon_z_seq(ww, nkw)][j % 62];
+endfunction
+
+// LFSR generating the u, v & w vectors of the z sequences (see simon_seq_gen & lfsr_multi_config for the matrix
+// convention): the reverse matrices step the same state backwards, i.e. M_R = M^-1
+localparam int                                          SIMON_LFSR_N    = 5;
+typedef logic[0:SIMON_LFSR_N-1][0:SIMON_LFSR_N-1]       simon_lfsr_mat_t;
+localparam simon_lfsr_mat_t                             SIMON_LFSR_U    = '{5'b01000, 5'b00100, 5'b10010, 5'b00001, 5'b10001};
+localparam simon_lfsr_mat_t                             SIMON_LFSR_V    = '{5'b01100, 5'b00100, 5'b10010, 5'b00001, 5'b10000};
+localparam simon_lfsr_mat_t                             SIMON_LFSR_W    = '{5'b01000, 5'b00100, 5'b10010, 5'b00001, 5'b10000};
+localparam simon_lfsr_mat_t                             SIMON_LFSR_UR   = '{5'b00011, 5'b10000, 5'b01000, 5'b00111, 5'b00010};
+localparam simon_lfsr_mat_t                             SIMON_LFSR_VR   = '{5'b00001, 5'b11000, 5'b01000, 5'b00101, 5'b00010};
+localparam simon_lfsr_mat_t                             SIMON_LFSR_WR   = '{5'b00001, 5'b10000, 5'b01000, 5'b00101, 5'b00010};
+localparam logic[SIMON_LFSR_N-1:0]                      SIMON_LFSR_SEED = 5'b10000; // outputs z_0 first, any vector
+
+// Forward LFSR matrix of the z sequence used by Simon 2n/mn
+function automatic simon_lfsr_mat_t simon_lfsr_matrix(int ww, int nkw);
+    case (simon_z_seq(ww, nkw))
+        0, 2:    return SIMON_LFSR_U;
+        1, 3:    return SIMON_LFSR_V;
+        default: return SIMON_LFSR_W;
+    endcase
+endfunction
+
+// Jump to state: the state of the LFSR of matrix m, k steps after state s
+function automatic logic[SIMON_LFSR_N-1:0] simon_lfsr_jump(simon_lfsr_mat_t m, logic[SIMON_LFSR_N-1:0] s, int k);
+    logic[SIMON_LFSR_N-1:0] nxt;
+    for (int n=0; n<k; n++) begin
+        for (int i=0; i<SIMON_LFSR_N; i++) begin
+            nxt[i] = 1'b0;
+            for (int j=0; j<SIMON_LFSR_N; j++) begin
+                nxt[i] = nxt[i] ^ (s[j] & m[j][i]);
+            end
+        end
+        s = nxt;
+    end
+    return s;
+endfunction
+
+// Decryption seeds of Simon 2n/mn: the key schedule runs backwards from round key T-1, whose update uses
+// z_(T-1-m), so the reverse LFSR starts at the forward state T-1-m steps after the seed (and t at t_(T-1-m))
+function automatic logic[SIMON_LFSR_N-1:0] simon_lfsr_seed_dec(int ww, int nkw);
+    return simon_lfsr_jump(simon_lfsr_matrix(ww, nkw), SIMON_LFSR_SEED, simon_n_rounds(ww, nkw) - 1 - nkw);
+endfunction
+
+function automatic logic simon_t_seed_dec(int ww, int nkw);
+    return 1'((simon_n_rounds(ww, nkw) - 1 - nkw) % 2);
+endfunction
+
 endpackage
\ No newline at end of file
@@ -34,49 +34,143 @@
  * @param NKW       Defines the number of key words (m in [ref]).
  * @param DATA_RST  Sets whether the plaintext & key registers are resettable to zero (for testing reasons)
  *                  Note that resettable data FFs will result to a higher area footprint
+ * @param UNROLL    Number of rounds performed per cycle: UNROLL round & key schedule stages are chained between the
+ *                  registers, so that a block takes ceil(T/UNROLL) cycles. If UNROLL does not divide the number of
+ *                  rounds T, the last cycle (last_i) runs the remaining T%UNROLL rounds only: ct_nxt_o is then taken
+ *                  at the output of stage T%UNROLL (a fixed tap, paid for by one 2:1 MUX on ct_nxt_o)
+ * @param RK_RAM    Adds a T x n round key register file: while rk_wr_en_i is asserted, the round keys produced by the key
+ *                  schedule are written at rounds rk_cnt_i*UNROLL+u, and while rk_rd_en_i is asserted the round
+ *                  functions use the stored keys instead -- forward for encryption, backward (k_(T-1-r)) for decryption,
+ *                  with the key registers, key schedule & LFSR left idle
+ * @param CLK_GATE  Clocks each register group (text, key, LFSR & t sequence, round key RAM) through its own clock gate
+ *                  (clk_gate), enabled with the group's load/run enables, instead of relying on the enables alone
+ * @param OP_ISO    Operand isolation: the round functions' round keys & text are forced to zero outside of the
+ *                  encryption/decryption runs (rnd_en_i), e.g. while the key schedule runs alone in a decryption key
+ *                  prepare, so that the round logic (through all UNROLL stages) does not toggle
+ * @param MASKED    First-order masking: the text & key registers hold 2 Boolean shares each, loaded from pt_i/pt_m_i
+ *                  and key_i/key_m_i (share 0 & share 1, masked by the caller with fresh randomness). The key schedule
+ *                  runs share-wise (it is linear, the constant goes to share 0), and the round function is a DOM AND
+ *                  whose cross-domain products are refreshed with rnd_i and registered (simon_round_masked): a round
+ *                  then takes 2 cycles -- pt_run_en_i must not be asserted in two consecutive cycles, nor in the cycle
+ *                  after a load. The shares are only recombined on ct_nxt_o in the last run cycle (last_i), each share
+ *                  gated before the XOR; ct_o and key_o are share 0 and key_m_o share 1. Requires UNROLL = 1 and no RK_RAM.
+ * @param SPECK     Adds Speck 2n/mn (same n & m) on the same text & key registers: alg_i selects, per block, the Simon
+ *                  or the Speck round & key schedule (speck_round, speck_key_schedule) at each stage's output. The
+ *                  Speck key schedule's step index is the round counter rk_cnt_i (counting down from T-2 for a
+ *                  decryption), and a decryption starts from all the key words of the last round, key_regs_o of the key
+ *                  prepare's last cycle. Requires UNROLL = 1, no RK_RAM and no MASKED.
  */
 
 module simon_core
 #(
     parameter int   WW          = 16,
     parameter int   NKW         = 4,
-    parameter logic DATA_RST    = 1'b0
+    parameter logic DATA_RST    = 1'b0,
+    parameter int   UNROLL      = 1,
+    parameter logic RK_RAM      = 1'b0,
+    parameter logic CLK_GATE    = 1'b0,
+    parameter logic OP_ISO      = 1'b0,
+    parameter logic MASKED      = 1'b0,
+    parameter logic SPECK       = 1'b0
 )
 (
     input  logic                    clk,            // clock, @posedge
     input  logic                    arst_n,         // async reset -- active low
     // 
     input  logic                    srst_i,         // reset LFSR & t sequence
+    input  logic                    srst_mode_i,    // mode the LFSR & t sequence are reset to (the next block's)
     input  logic                    mode_i,         // 0 for encrypt, 1 for decrypt
+    // verilator lint_off UNUSEDSIGNAL
+    input  logic                    alg_i,          // SPECK: cipher of the running block (ALG_SIMON or ALG_SPECK)
+    // verilator lint_on UNUSEDSIGNAL
     
     input  logic                    pt_ld_en_i,     // load plaintext into registers (set pt_i and assert pt_ld_en_i for one cycle)
     input  logic                    pt_run_en_i,    // update plaintext registers (assert for as many cycles as the number of rounds)
-    input  logic[2-1:0][WW-1:0]     pt_i,           // plaintext input (2 words)
+    input  logic[2-1:0][WW-1:0]     pt_i,           // plaintext input (2 words) -- share 0 with MASKED
+    // verilator lint_off UNUSEDSIGNAL
+    input  logic[2-1:0][WW-1:0]     pt_m_i,         // MASKED: plaintext input share 1
+    // verilator lint_on UNUSEDSIGNAL
     
     input  logic                    key_ld_en_i,    // load key into registers (set key_i and assert key_ld_en_i for one cycle)
     input  logic                    key_run_en_i,   // update key registers (assert for as many cycles as the number of rounds)
-    input  logic[NKW-1:0][WW-1:0]   key_i,          // key input (NKW words)
+    input  logic[NKW-1:0][WW-1:0]   key_i,          // key input (NKW words) -- share 0 with MASKED
+    // verilator lint_off UNUSEDSIGNAL
+    input  logic[NKW-1:0][WW-1:0]   key_m_i,        // MASKED: key input share 1
+    input  logic[WW-1:0]            rnd_i,          // MASKED: fresh random bits of the round function (every cycle)
+    // verilator lint_on UNUSEDSIGNAL
+    
+    // verilator lint_off UNUSEDSIGNAL
+    input  logic                    rk_wr_en_i,     // RK_RAM: store the current round keys (key_o)
+    input  logic                    rk_rd_en_i,     // RK_RAM: round functions use the stored round keys
+    input  logic[simon_const_pkg::simon_cnt_w(WW, NKW, UNROLL)-1:0] rk_cnt_i,   // RK_RAM & SPECK: run cycle of the current rounds (round counter)
+    input  logic                    last_i,         // last run cycle: ct_nxt_o is the result after the remaining T%UNROLL rounds
+    input  logic                    rnd_en_i,       // an encryption/decryption runs: round function outputs are used (OP_ISO)
+    // verilator lint_on UNUSEDSIGNAL
     
     output logic[2-1:0][WW-1:0]     ct_o,           // current ciphertext (outputs plaintext regs)
-    output logic[WW-1:0]            key_o           // current key (outputs key regs)
+    output logic[2-1:0][WW-1:0]     ct_nxt_o,       // ciphertext after the current cycle's rounds (next value of the plaintext regs when running)
+    output logic[UNROLL-1:0][WW-1:0] key_o,         // current round keys -- key_o[u] is the round key used by stage u
+    output logic[UNROLL-1:0][WW-1:0] key_m_o,       // MASKED: current round keys share 1 (key_o is share 0)
+    output logic[NKW-1:0][WW-1:0]   key_regs_o      // SPECK: current key registers (all NKW key words)
 );
 // -- Constants ----------------------------------------------------------------------------------- //
-localparam logic[WW-1:0] C_CONSTANT = (1 << WW) - 4;
+localparam logic[WW-1:0] C_CONSTANT = {{(WW-2){1'b1}}, 2'b00};   // 2^n - 4
+localparam int N_ROUNDS = simon_const_pkg::simon_n_rounds(WW, NKW);
+localparam int N_REM    = N_ROUNDS % UNROLL;    // rounds of the last cycle (0: UNROLL, all of them)
+localparam int N_ROUNDS_SPECK = simon_const_pkg::speck_n_rounds(WW, NKW);
 
 // -- Signal Definitions -------------------------------------------------------------------------- //
-logic                   seq;
-logic[NKW-1:0][WW-1:0]  key_r;
-logic[NKW-1:0][WW-1:0]  key_nxt;
-logic[1:0][WW-1:0]      pt_r;
-logic[1:0][WW-1:0]      pt_nxt;
-logic[WW-1:0]           c_xor_z;
+logic[UNROLL-1:0]                   seq;
+logic[NKW-1:0][WW-1:0]              key_r;
+logic[NKW-1:0][WW-1:0]              key_nxt;
+logic[1:0][WW-1:0]                  pt_r;
+logic[1:0][WW-1:0]                  pt_nxt;
+logic[UNROLL-1:0][WW-1:0]           c_xor_z;
+// each stage reads the previous stage's slice of the same vector (not a combinational loop)
+// verilator lint_off UNOPTFLAT
+logic[UNROLL:0][NKW-1:0][WW-1:0]    key_stage;  // key_stage[u]: key words at the input of stage u
+logic[UNROLL:0][1:0][WW-1:0]        pt_stage;   // pt_stage[u]: text words at the input of stage u
+// verilator lint_on UNOPTFLAT
+logic[UNROLL-1:0][WW-1:0]           round_key;  // round_key[u]: round key used by stage u
+logic[UNROLL-1:0][WW-1:0]           round_key_iso;  // round_key[u], isolated (OP_ISO)
+logic[1:0][WW-1:0]                  pt_iso;     // text at the input of stage 0, isolated (OP_ISO)
+logic                               clk_pt;     // register group clocks (gated with CLK_GATE)
+logic                               clk_key;
+logic                               clk_seq;
+logic                               clk_rk;
+logic                               clk_dom;    // clock of the masked rounds' cross-domain registers
+// MASKED: share 1 of the text & key (share 0 is the unmasked datapath above)
+logic[NKW-1:0][WW-1:0]              key_m_r;
+logic[1:0][WW-1:0]                  pt_m_r;
+// verilator lint_off UNOPTFLAT
+logic[UNROLL:0][NKW-1:0][WW-1:0]    key_m_stage;
+logic[UNROLL:0][1:0][WW-1:0]        pt_m_stage;
+// verilator lint_on UNOPTFLAT
+logic[UNROLL-1:0][WW-1:0]           round_key_m_iso;
+logic[1:0][WW-1:0]                  pt_m_iso;
+logic[WW-1:0]                       speck_cnt;  // SPECK: step index of the Speck key schedule
+
+// -- Clock Gates --------------------------------------------------------------------------------- //
+if (CLK_GATE) begin: g_if_clk_gate
+    clk_gate i_cg_pt  (.clk(clk), .en_i(pt_ld_en_i | pt_run_en_i),   .test_en_i(1'b0), .gclk_o(clk_pt));
+    clk_gate i_cg_key (.clk(clk), .en_i(key_ld_en_i | key_run_en_i), .test_en_i(1'b0), .gclk_o(clk_key));
+    clk_gate i_cg_seq (.clk(clk), .en_i(srst_i | key_run_en_i),      .test_en_i(1'b0), .gclk_o(clk_seq));
+    clk_gate i_cg_rk  (.clk(clk), .en_i(rk_wr_en_i),                 .test_en_i(1'b0), .gclk_o(clk_rk));
+    clk_gate i_cg_dom (.clk(clk), .en_i(rnd_en_i),                   .test_en_i(1'b0), .gclk_o(clk_dom));
+end else begin: g_if_no_clk_gate
+    assign clk_pt   = clk;
+    assign clk_key  = clk;
+    assign clk_seq  = clk;
+    assign clk_rk   = clk;
+    assign clk_dom  = clk;
+end
 
 // -- Data (plaintext & key) Registers ------------------------------------------------------------ //
 if (DATA_RST) begin: if_data_rst
     // Resettable data FFs
-    always_ff @(posedge clk, negedge arst_n) begin: ff_key
+    always_ff @(posedge clk_key, negedge arst_n) begin: ff_key
         if (!arst_n) begin
-            key_r <= '{WW{1'b0}};
+            key_r <= '0;
         end else begin
             if (key_ld_en_i) begin
                 key_r <= key_i;
@@ -86,9 +180,9 @@ if (DATA_RST) begin: if_data_rst
         end
     end
     
-    always_ff @(posedge clk, negedge arst_n) begin: ff_pt
+    always_ff @(posedge clk_pt, negedge arst_n) begin: ff_pt
         if (!arst_n) begin
-            pt_r  <= '{WW{1'b0}};
+            pt_r  <= '0;
         end else begin
             if (pt_ld_en_i) begin
                 pt_r <= pt_i;
@@ -99,7 +193,7 @@ if (DATA_RST) begin: if_data_rst
     end
 end else begin: if_no_data_rst
     // Non-resettable data FFs
-    always_ff @(posedge clk) begin: ff_key
+    always_ff @(posedge clk_key) begin: ff_key
         if (key_ld_en_i) begin
             key_r <= key_i;
         end else if (key_run_en_i) begin
@@ -107,7 +201,7 @@ end else begin: if_no_data_rst
         end
     end
     
-    always_ff @(posedge clk) begin: ff_pt
+    always_ff @(posedge clk_pt) begin: ff_pt
         if (pt_ld_en_i) begin
             pt_r <= pt_i;
         end else if (pt_run_en_i) begin
@@ -116,17 +210,73 @@ end else begin: if_no_data_rst
     end
 end
 
+// -- Share 1 Registers (MASKED) ------------------------------------------------------------------ //
+// same enables as the share 0 registers above
+if (MASKED) begin: g_if_masked_regs
+    if (DATA_RST) begin: g_if_data_rst
+        always_ff @(posedge clk_key, negedge arst_n) begin: ff_key_m
+            if (!arst_n) begin
+                key_m_r <= '0;
+            end else begin
+                if (key_ld_en_i) begin
+                    key_m_r <= key_m_i;
+                end else if (key_run_en_i) begin
+                    key_m_r <= key_m_stage[UNROLL];
+                end
+            end
+        end
+        
+        always_ff @(posedge clk_pt, negedge arst_n) begin: ff_pt_m
+            if (!arst_n) begin
+                pt_m_r <= '0;
+            end else begin
+                if (pt_ld_en_i) begin
+                    pt_m_r <= pt_m_i;
+                end else if (pt_run_en_i) begin
+                    pt_m_r <= pt_m_stage[UNROLL];
+                end
+            end
+        end
+    end else begin: g_if_no_data_rst
+        always_ff @(posedge clk_key) begin: ff_key_m
+            if (key_ld_en_i) begin
+                key_m_r <= key_m_i;
+            end else if (key_run_en_i) begin
+                key_m_r <= key_m_stage[UNROLL];
+            end
+        end
+        
+        always_ff @(posedge clk_pt) begin: ff_pt_m
+            if (pt_ld_en_i) begin
+                pt_m_r <= pt_m_i;
+            end else if (pt_run_en_i) begin
+                pt_m_r <= pt_m_stage[UNROLL];
+            end
+        end
+    end
+    
+    assign key_m_stage[0]   = key_m_r;
+    assign pt_m_stage[0]    = pt_m_iso;
+end else begin: g_if_no_masked_regs
+    assign key_m_r      = '0;
+    assign pt_m_r       = '0;
+    assign key_m_stage  = '0;
+    assign pt_m_stage   = '0;
+end
+
 // -- Sequence Generator -------------------------------------------------------------------------- //
 simon_seq_gen
 #(
     .WW         (WW ),
-    .NKW        (NKW)
+    .NKW        (NKW),
+    .UNROLL     (UNROLL)
 )
 i_seq_gen
 (
-    .clk        (clk),
+    .clk        (clk_seq),
     .arst_n     (arst_n),
     .rst_seqs_i (srst_i),
+    .rst_mode_i (srst_mode_i),
 
     .mode_i     (mode_i),
     
@@ -134,47 +284,235 @@ i_seq_gen
     .seq_o      (seq)
 );
 
-assign c_xor_z = C_CONSTANT ^ seq;
-
-// -- Key Schedule -------------------------------------------------------------------------------- //
-simon_key_schedule
-#(
-    .WW         (WW ),
-    .NKW        (NKW)
-)
-i_key_schedule
-(
-    .mode_i     (mode_i),
+// -- Round Stages -------------------------------------------------------------------------------- //
+// Stage u runs round r+u: its key schedule produces the key words of the next stage
+// and its round function uses the stage's current round key key_stage[u][0]
+assign key_stage[0] = key_r;
+assign pt_stage[0]  = pt_iso;
+// Speck (UNROLL = 1): a key prepare or an encryption steps forward from key step 0, a decryption back from step T-1
+assign speck_cnt    = (mode_i == simon_const_pkg::MODE_DEC) ? WW'(N_ROUNDS_SPECK-2) - WW'(rk_cnt_i) : WW'(rk_cnt_i);
+for (genvar u=0; u<UNROLL; u++) begin: g_for_stage
+    logic[NKW-1:0][WW-1:0]  key_simon_nxt;  // Simon key schedule & round outputs
+    logic[1:0][WW-1:0]      pt_simon_nxt;
     
-    .key_cur_i  (key_r),
-    .c_xor_z_i  (c_xor_z),
+    assign c_xor_z[u] = C_CONSTANT ^ WW'(seq[u]);
     
-    .key_nxt_o  (key_nxt)
-);
-// -- Round Function ------------------------------------------------------------------------------ //
-simon_round
-#(
-    .WW (WW)
-)
-i_round
-(
-    .key_i (key_r[0]),
+    // -- Key Schedule ---------------------------------------------------------------------------- //
+    simon_key_schedule
+    #(
+        .WW         (WW ),
+        .NKW        (NKW)
+    )
+    i_key_schedule
+    (
+        .mode_i     (mode_i),
+        
+        .key_cur_i  (key_stage[u]),
+        .c_xor_z_i  (c_xor_z[u]),
+        
+        .key_nxt_o  (key_simon_nxt)
+    );
+    // -- Round Function -------------------------------------------------------------------------- //
+    if (MASKED) begin: g_if_masked
+        logic[1:0][WW-1:0] key_sh;
+        logic[1:0][WW-1:0] x_sh;
+        logic[1:0][WW-1:0] y_sh;
+        logic[1:0][WW-1:0] x_nxt_sh;
+        logic[1:0][WW-1:0] y_nxt_sh;
+        
+        // share 1 key schedule -- the round constant only goes to share 0
+        simon_key_schedule
+        #(
+            .WW         (WW ),
+            .NKW        (NKW)
+        )
+        i_key_schedule_m
+        (
+            .mode_i     (mode_i),
+            
+            .key_cur_i  (key_m_stage[u]),
+            .c_xor_z_i  ('0),
+            
+            .key_nxt_o  (key_m_stage[u+1])
+        );
+        
+        assign key_sh   = {round_key_m_iso[u], round_key_iso[u]};
+        assign x_sh     = {pt_m_stage[u][1], pt_stage[u][1]};
+        assign y_sh     = {pt_m_stage[u][0], pt_stage[u][0]};
+        
+        simon_round_masked
+        #(
+            .WW         (WW),
+            .DATA_RST   (DATA_RST)
+        )
+        i_round
+        (
+            .clk        (clk_dom),
+            .arst_n     (arst_n),
+            
+            .key_i      (key_sh),
+            .x_i        (x_sh),
+            .y_i        (y_sh),
+            .rnd_i      (rnd_i),
+            
+            .x_o        (x_nxt_sh),
+            .y_o        (y_nxt_sh)
+        );
+        
+        assign {pt_m_stage[u+1][1], pt_simon_nxt[1]} = x_nxt_sh;
+        assign {pt_m_stage[u+1][0], pt_simon_nxt[0]} = y_nxt_sh;
+        assign key_m_o[u] = key_m_stage[u][0];
+    end else begin: g_if_not_masked
+        simon_round
+        #(
+            .WW (WW)
+        )
+        i_round
+        (
+            .key_i (round_key_iso[u]),
+            
+            .x_i   (pt_stage[u][1]),
+            .y_i   (pt_stage[u][0]),
+            
+            .x_o   (pt_simon_nxt[1]),
+            .y_o   (pt_simon_nxt[0])
+        );
+        
+        assign key_m_o[u] = '0;
+    end
+    
+    // -- Speck Round & Key Schedule (SPECK) ------------------------------------------------------ //
+    if (SPECK) begin: g_if_speck
+        logic[NKW-1:0][WW-1:0]  key_speck_nxt;
+        logic[1:0][WW-1:0]      pt_speck_nxt;
+        
+        speck_key_schedule
+        #(
+            .WW         (WW ),
+            .NKW        (NKW)
+        )
+        i_speck_key_schedule
+        (
+            .mode_i     (mode_i),
+            
+            .key_cur_i  (key_stage[u]),
+            .cnt_i      (speck_cnt),
+            
+            .key_nxt_o  (key_speck_nxt)
+        );
+        
+        speck_round
+        #(
+            .WW (WW)
+        )
+        i_speck_round
+        (
+            .mode_i (mode_i),
+            .key_i  (round_key_iso[u]),
+            
+            .x_i    (pt_stage[u][1]),
+            .y_i    (pt_stage[u][0]),
+            
+            .x_o    (pt_speck_nxt[1]),
+            .y_o    (pt_speck_nxt[0])
+        );
+        
+        assign key_stage[u+1]   = (alg_i == simon_const_pkg::ALG_SPECK) ? key_speck_nxt : key_simon_nxt;
+        assign pt_stage[u+1]    = (alg_i == simon_const_pkg::ALG_SPECK) ? pt_speck_nxt  : pt_simon_nxt;
+    end else begin: g_if_no_speck
+        assign key_stage[u+1]   = key_simon_nxt;
+        assign pt_stage[u+1]    = pt_simon_nxt;
+    end
     
-    .x_i   (pt_r[1]),
-    .y_i   (pt_r[0]),
+    assign key_o[u] = key_stage[u][0];
+end
+assign key_nxt  = key_stage[UNROLL];
 
-    .x_o   (pt_nxt[1]),
-    .y_o   (pt_nxt[0])
-);
+// -- Round Key RAM ------------------------------------------------------------------------------- //
+if (RK_RAM) begin: g_if_rk_ram
+    localparam int RK_W = $clog2(N_ROUNDS);
+    logic[N_ROUNDS-1:0][WW-1:0] rk_ram_r;
+    
+    if (DATA_RST) begin: g_if_data_rst
+        always_ff @(posedge clk_rk, negedge arst_n) begin: ff_rk_ram
+            if (!arst_n) begin
+                rk_ram_r <= '0;
+            end else begin
+                if (rk_wr_en_i) begin
+                    for (int u=0; u<UNROLL; u++) begin
+                        if (rk_cnt_i*UNROLL + u < N_ROUNDS) begin
+                            rk_ram_r[RK_W'(rk_cnt_i*UNROLL + u)] <= key_stage[u][0];
+                        end
+                    end
+                end
+            end
+        end
+    end else begin: g_if_no_data_rst
+        always_ff @(posedge clk_rk) begin: ff_rk_ram
+            if (rk_wr_en_i) begin
+                for (int u=0; u<UNROLL; u++) begin
+                    if (rk_cnt_i*UNROLL + u < N_ROUNDS) begin
+                        rk_ram_r[RK_W'(rk_cnt_i*UNROLL + u)] <= key_stage[u][0];
+                    end
+                end
+            end
+        end
+    end
+    
+    // in the last cycle, the stages past the remaining rounds read any key (their outputs are unused)
+    for (genvar u=0; u<UNROLL; u++) begin: g_for_rk_rd
+        logic[RK_W-1:0] rk_idx;
+        assign rk_idx       = (rk_cnt_i*UNROLL + u >= N_ROUNDS)       ? '0 :
+                              (mode_i == simon_const_pkg::MODE_ENC)    ? RK_W'(rk_cnt_i*UNROLL + u) : RK_W'(N_ROUNDS-1 - (rk_cnt_i*UNROLL + u));
+        assign round_key[u] = rk_rd_en_i ? rk_ram_r[rk_idx] : key_stage[u][0];
+    end
+end else begin: g_if_no_rk_ram
+    for (genvar u=0; u<UNROLL; u++) begin: g_for_rk
+        assign round_key[u] = key_stage[u][0];
+    end
+end
+assign pt_nxt   = pt_stage[UNROLL];
+
+// -- Operand Isolation --------------------------------------------------------------------------- //
+if (OP_ISO) begin: g_if_op_iso
+    assign round_key_iso    = rnd_en_i ? round_key : '0;
+    assign pt_iso           = rnd_en_i ? pt_r : '0;
+    for (genvar u=0; u<UNROLL; u++) begin: g_for_rk_m
+        assign round_key_m_iso[u] = rnd_en_i ? key_m_stage[u][0] : '0;
+    end
+    assign pt_m_iso         = rnd_en_i ? pt_m_r : '0;
+end else begin: g_if_no_op_iso
+    assign round_key_iso    = round_key;
+    assign pt_iso           = pt_r;
+    for (genvar u=0; u<UNROLL; u++) begin: g_for_rk_m
+        assign round_key_m_iso[u] = key_m_stage[u][0];
+    end
+    assign pt_m_iso         = pt_m_r;
+end
 
 // -- Outputs ------------------------------------------------------------------------------------- //
 assign ct_o     = pt_r;
-assign key_o    = key_r[0];
+assign key_regs_o = key_r;
+if (MASKED) begin: g_if_masked_out
+    // the shares only meet in the last run cycle, each one gated before the XOR (no unmasked intermediate state)
+    logic[1:0][WW-1:0] ct_sh0;
+    logic[1:0][WW-1:0] ct_sh1;
+    assign ct_sh0   = {2*WW{last_i}} & pt_nxt;
+    assign ct_sh1   = {2*WW{last_i}} & pt_m_stage[UNROLL];
+    assign ct_nxt_o = ct_sh0 ^ ct_sh1;
+end else if (N_REM > 0) begin: g_if_rem
+    assign ct_nxt_o = last_i ? pt_stage[N_REM] : pt_nxt;
+end else begin: g_if_no_rem
+    assign ct_nxt_o = pt_nxt;
+end
 
 // -- Design Parameter Assertions ----------------------------------------------------------------- //
 // synthesis translate_off
 initial begin
     #0 assert (WW inside {16, 24, 32, 48, 64}) else $error("Illegal WW parameter value %0d -- legal values: 16, 24, 32, 48, 64", WW);
+    #0 assert ((UNROLL >= 1) && (UNROLL <= N_ROUNDS)) else $error("Illegal UNROLL parameter value %0d -- must be in 1..%0d (the number of rounds)", UNROLL, N_ROUNDS);
+    #0 assert (!MASKED || ((UNROLL == 1) && !RK_RAM)) else $error("MASKED requires UNROLL = 1 (got %0d) and RK_RAM = 0 (got %0d)", UNROLL, RK_RAM);
+    #0 assert (!SPECK || ((UNROLL == 1) && !RK_RAM && !MASKED)) else $error("SPECK requires UNROLL = 1 (got %0d), RK_RAM = 0 (got %0d) and MASKED = 0 (got %0d)", UNROLL, RK_RAM, MASKED);
     
     if (WW == 16)
         #0 assert (NKW == 4) else $error("Illegal NKW parameter value %0d -- legal values for WW = %0d: 4", NKW, WW);
@@ -32,63 +32,100 @@
  *
  * @param WW        Defines the word size (n in [ref])
  * @param NKW       Defines the number of key words (m in [ref]).
+ * @param UNROLL    Number of rounds simon_core performs per cycle -- the round counter counts ceil(T/UNROLL) cycles,
+ *                  the last one of an encryption/decryption running the remaining T%UNROLL rounds (core_last_o)
+ * @param RK_RAM    simon_core stores the round keys: a block whose key hits (rk_hit_i) runs from the stored keys,
+ *                  either way (encryption or decryption) and without key prepare. Otherwise, an encryption stores
+ *                  the keys as it runs, and a decryption stores them in its key prepare, then reads them backward.
+ * @param MASKED    simon_core runs masked rounds, which take 2 cycles: each encryption/decryption run cycle is preceded
+ *                  by a wait cycle (phase_r = 0) in which the core registers the refreshed cross-domain products, and
+ *                  the round counter, text & key registers and the result only advance in the second one. An
+ *                  encryption then takes exactly 2T cycles (T extra), and a decryption 2T+1 after its key prepare,
+ *                  which is linear and still runs at one round per cycle (T cycles).
+ *
+ *        The number of rounds of the current block comes from n_rounds_i, tied to T for a fixed configuration; a
+ *        runtime-configurable top (simon_cfg_top) drives the T of the block it runs, up to the T of WW/NKW, and so
+ *        does simon_top with SPECK (Speck's T, below Simon's, for a Speck block).
+ *
+ *        The FSM sits between an input staging register and an output holding register (see simon_top). Its last
+ *        run cycle hands the result (core's ct_nxt_o) to the holding register and, in the same cycle, loads the next
+ *        staged input into the core, so a stream of encryptions takes exactly ceil(T/UNROLL) cycles per block (2T with
+ *        MASKED). The last round is stalled while the holding register is still occupied.
  */
 
 module simon_ctrl_fsm
 #(
     parameter int   WW          = 16,
-    parameter int   NKW         = 4
+    parameter int   NKW         = 4,
+    parameter int   UNROLL      = 1,
+    parameter logic RK_RAM      = 1'b0,
+    parameter logic MASKED      = 1'b0
 )
 (
     input  logic                    clk,                // clock, @posedge
     input  logic                    arst_n,             // async reset -- active low
     output logic                    active_o,           // asserted when not idle (used for architectural clock gating)
+    output logic                    key_prep_o,         // asserted during a decryption key prepare (S_DEC_KEY_RUN, for statistics)
     // Input Interface
-    input  logic                    valid_i,            // when asserted, the FSM will start its work
-    output logic                    ready_o,            // when asserted, and valid_i is asserted, the current input has been completely processed
+    input  logic                    valid_i,            // when asserted, the FSM will start its work (input staging register is full)
+    output logic                    ready_o,            // when asserted, and valid_i is asserted, the current input has been loaded into the core (combinational)
     input  logic                    mode_i,             // when valid_i is asserted, it defines the desired functionality: 0 for encrypton, 1 for decryption
+    input  logic[simon_const_pkg::simon_rounds_w(WW, NKW)-1:0] n_rounds_i, // number of rounds T of the current block (from its start until its result)
     // Control to core
     output logic                    core_srst_o,        // to simon_core: resets LFSR & sequences
+    output logic                    core_srst_mode_o,   // to simon_core: enc/dec mode the sequences are reset to
     output logic                    core_mode_o,        // to simon_core: enc/dec mode
     output logic                    core_pt_ld_en_o,    // to simon_core: load plaintext regs with input pt_i
     output logic                    core_pt_run_en_o,   // to simon_core: update plaintext regs
     output logic                    core_key_ld_en_o,   // to simon_core: load key regs with input key_i
     output logic                    core_key_run_en_o,  // to simon_core: update key regs
+    output logic[simon_const_pkg::simon_cnt_w(WW, NKW, UNROLL)-1:0] core_rk_cnt_o, // to simon_core: run cycle (round counter)
+    output logic                    core_last_o,        // to simon_core: last run cycle, the result is taken after the remaining rounds
+    output logic                    core_rnd_en_o,      // to simon_core: an encryption/decryption runs (round functions used, for operand isolation)
+    // Round Key RAM (RK_RAM)
+    input  logic                    rk_hit_i,           // the round keys of the input key (valid_i) are stored in the core
+    output logic                    rk_wr_en_o,         // to simon_core: store the round keys of the current cycle
+    output logic                    rk_rd_en_o,         // to simon_core: use the stored round keys
+    output logic                    rk_tag_ld_o,        // a key prepare starts: the stored round keys become those of the input key
+    output logic                    rk_valid_set_o,     // the key prepare is over (last write): the stored round keys are valid
     // Key Temp Registers
-    output logic[NKW-1:0]           key_reg_ld_en_o,    // one-hot signal, if bit i is asserted, load key reg i
+    output logic[NKW-1:0]           key_reg_ld_en_o,    // if bit i is asserted, load key reg i (from core stage (T-1-i)%UNROLL, see simon_top)
     output logic                    key_reg_sel_o,      // selects which keys will load the core's key regs: 0 for input (key_i), 1 for stored keys (see simon_top)
+    input  logic                    key_hit_i,          // the stored keys of the input key (valid_i) are available -- no key prepare needed
+    output logic                    key_fill_o,         // the key prepare is over: the stored keys become available for the input key
     // Output Interface
-    output logic                    valid_o,            // when asserted, a plaintext/ciphertext-key pair has been processed
-    input  logic                    ready_i,            // when asserted and valid_o is asserted, the output has successfully been transfered to the environment
+    output logic                    valid_o,            // when asserted, a plaintext/ciphertext-key pair has been processed and its result is on the core's ct_nxt_o
+    input  logic                    ready_i,            // when asserted and valid_o is asserted, the result is captured by the output holding register (see simon_top)
     output logic                    mode_o              // when valid_o is asserted, it indicates whether the output is the result of an encryption (0) or decryption
 );
 // -- Constants ----------------------------------------------------------------------------------- //
 // mode global constant values (0: encryption, 1: decryption)
 import simon_const_pkg::MODE_ENC;
 import simon_const_pkg::MODE_DEC;
-// number of rounds, depending on the configuration
-localparam int N_ROUNDS = (WW == 16) && (NKW == 2) ? 32 :
-                          (WW == 24) && (NKW == 3) ? 36 :
-                          (WW == 24) && (NKW == 4) ? 36 :
-                          (WW == 32) && (NKW == 3) ? 42 :
-                          (WW == 32) && (NKW == 4) ? 44 :
-                          (WW == 48) && (NKW == 2) ? 52 :
-                          (WW == 48) && (NKW == 3) ? 54 :
-                          (WW == 64) && (NKW == 2) ? 68 :
-                          (WW == 64) && (NKW == 3) ? 69 :
-                          (WW == 64) && (NKW == 4) ? 72 :
-                                                     0;
+// number of rounds, depending on the configuration, and resulting number of run cycles
+localparam int N_ROUNDS = simon_const_pkg::simon_n_rounds(WW, NKW);
+localparam int CNT_W    = simon_const_pkg::simon_cnt_w(WW, NKW, UNROLL);
+localparam int RND_W    = simon_const_pkg::simon_rounds_w(WW, NKW);
 // FSM states
-typedef enum {S_IDLE,
-              S_ENC_PRE, S_ENC_RUN, 
-              S_DEC_PRE_KEY, S_DEC_KEY_RUN, S_DEC_PRE, S_DEC_RUN,
-              S_OUTPUT} fsm_state_t;
+typedef enum {S_IDLE, S_ENC_RUN,
+              S_DEC_KEY_RUN, S_DEC_PRE, S_DEC_RUN} fsm_state_t;
 fsm_state_t state_cur;
 fsm_state_t state_nxt;
 // round counter signals
-logic[$clog2(N_ROUNDS)-1:0] round_cnt_r;
+logic[RND_W-1:0]            n_cycles;       // run cycles of the current block (ceil(T/UNROLL))
+logic[CNT_W-1:0]            round_cnt_r;
 logic                       round_cnt_rst;
 logic                       round_cnt_incr;
+logic                       round_last;     // last run cycle of the current state
+logic                       run_out;        // an encryption/decryption is in its last cycle: its result is on the core's ct_nxt_o
+logic                       start;          // start the next input (either from idle, or chained to the current result)
+logic                       start_hit;      // start a decryption whose keys are already stored
+logic                       rk_hit;         // RK_RAM: the round keys of the input key are stored
+logic                       start_rk;       // start a block running from the stored round keys
+logic                       rk_use_r;       // the current block runs from the stored round keys
+logic                       rnd_run;        // an encryption/decryption runs (the round functions are used)
+logic                       phase_r;        // MASKED: second cycle of the round (the masked round's result is valid)
+logic                       step;           // the current run cycle advances (always, unless MASKED in the first cycle)
 
 // -- Round Counter ------------------------------------------------------------------------------- //
 // reset counter when loading in progress
@@ -107,6 +144,41 @@ always_ff @(posedge clk, negedge arst_n) begin: ff_round_cnt
     end
 end
 
+assign n_cycles     = RND_W'((n_rounds_i + UNROLL - 1) / UNROLL);
+assign round_last   = (round_cnt_r == CNT_W'(n_cycles-1));
+assign rnd_run      = (state_cur == S_ENC_RUN) || (state_cur == S_DEC_RUN);
+assign step         = !MASKED || !rnd_run || phase_r;
+assign run_out      = rnd_run && round_last && step;
+// The next input starts when the FSM is idle, or in the same cycle the current result is handed to the output
+// register -- so that back-to-back blocks run without any bubble between them
+assign start        = valid_i && ((state_cur == S_IDLE) || (run_out && ready_i));
+assign start_hit    = start && (mode_i == MODE_DEC) && key_hit_i;
+assign rk_hit       = RK_RAM && rk_hit_i;
+assign start_rk     = start && rk_hit;
+
+always_ff @(posedge clk, negedge arst_n) begin: ff_rk_use
+    if (!arst_n) begin
+        rk_use_r <= 1'b0;
+    end else begin
+        if (start) begin
+            rk_use_r <= rk_hit;
+        end else if (state_cur == S_DEC_PRE) begin
+            rk_use_r <= RK_RAM;
+        end
+    end
+end
+
+// -- Masked Round Phase -------------------------------------------------------------------------- //
+// 0 in the first cycle of every round, 1 in the second -- held while the last round's result waits for the holding
+// register (the text registers are stable, so the masked round's result stays valid)
+always_ff @(posedge clk, negedge arst_n) begin: ff_phase
+    if (!arst_n) begin
+        phase_r <= 1'b0;
+    end else begin
+        phase_r <= MASKED && rnd_run && (!phase_r || (run_out && !ready_i));
+    end
+end
+
 // -- FSM ----------------------------------------------------------------------------------------- //
 always_ff @(posedge clk, negedge arst_n) begin: ff_fsm
     if (!arst_n) begin
@@ -119,122 +191,88 @@ end
 always_comb begin: comb_fsm_nxt
     state_nxt = state_cur;
     
+    // Encryption/Decryption done -- the result is handed to the output register (waiting while it is occupied)
+    // and the FSM either moves on to the next input or goes idle
+    if (run_out && ready_i) begin
+        state_nxt = S_IDLE;
+    end
+    // Start -- resets sequences and loads key (& plaintext, for encryption or stored decryption keys)
+    // then moves to Encryption, Decryption Key Prepare or directly Decryption (stored keys) depending on mode_i
+    if (start) begin
+        state_nxt = (mode_i == MODE_ENC)    ? S_ENC_RUN     :
+                    key_hit_i || rk_hit     ? S_DEC_RUN     :
+                                              S_DEC_KEY_RUN;
+    end
+    
     case (state_cur)
-        // Idle -- does nothing, only waits for input valid
-        // when input valid is asserted, will move to Encryption or Decryption cycle depending on mode_i
-        S_IDLE: begin
-            if (valid_i && (mode_i == MODE_ENC)) begin
-                state_nxt = S_ENC_PRE;
-            end else if (valid_i && (mode_i == MODE_DEC)) begin
-                state_nxt = S_DEC_PRE_KEY;
-            end
-        end
-        
-        // Pre-Encryption -- resets sequences and loads key & plaintext
-        S_ENC_PRE: begin
-            state_nxt = S_ENC_RUN;
-        end
-        
-        // Encryption -- runs for T rounds until final ciphertext is generated
-        S_ENC_RUN: begin
-            if (round_cnt_r == (N_ROUNDS-1)) begin
-                state_nxt = S_OUTPUT;
-            end
-        end
-        
-        // Pre-Decryption Key Prepare -- resets sequences and loads key
-        S_DEC_PRE_KEY: begin
-            state_nxt = S_DEC_KEY_RUN;
-        end
-        
         // Decryption Key Prepare -- runs for T rounds until the last Keys are generated
         S_DEC_KEY_RUN: begin
-            if (round_cnt_r == (N_ROUNDS-1)) begin
+            if (round_last) begin
                 state_nxt = S_DEC_PRE;
             end
         end
         
-        // Pre-decryption --  resets sequences and loads key & plaintext
+        // Pre-decryption --  resets sequences and loads the last keys (unless stored in the RK_RAM) & ciphertext
         S_DEC_PRE: begin
             state_nxt = S_DEC_RUN;
         end
         
-        // Decryption -- runs for T rounds until final plaintext is generated
-        S_DEC_RUN: begin
-            if (round_cnt_r == (N_ROUNDS-1)) begin
-                state_nxt = S_OUTPUT;
-            end
-        end
-        
-        // Output -- asserts valid and sets ouputs
-        S_OUTPUT: begin
-            if (ready_i) begin
-                state_nxt = S_IDLE;
-            end
-        end
+        // Idle, Encryption & Decryption -- handled above (start & run_out)
+        default: ;
     endcase
 end
 
 // -- Signals to the core ------------------------------------------------------------------------- //
-assign core_srst_o          = (state_cur == S_ENC_PRE) | (state_cur == S_DEC_PRE_KEY) | (state_cur == S_DEC_PRE);
+// In the chained cycle the last round(s) still produce the current result (on ct_nxt_o) in the current mode, while
+// the sequences are reset for the next input -- which always starts with an encryption or a key prepare.
+// Blocks running from the stored round keys leave the key regs & sequences untouched
+assign core_srst_o          = (start & ~rk_hit) | ((state_cur == S_DEC_PRE) & ~RK_RAM);
+assign core_srst_mode_o     = (state_cur == S_DEC_PRE) || start_hit ? MODE_DEC : MODE_ENC;
 assign core_mode_o          = (state_cur == S_DEC_RUN) || (state_cur == S_DEC_PRE) ? MODE_DEC : MODE_ENC;
-assign core_pt_ld_en_o      = (state_cur == S_ENC_PRE) | (state_cur == S_DEC_PRE);
-assign core_pt_run_en_o     = (state_cur == S_ENC_RUN) | (state_cur == S_DEC_RUN);
-assign core_key_ld_en_o     = (state_cur == S_ENC_PRE) | (state_cur == S_DEC_PRE_KEY) | (state_cur == S_DEC_PRE);
-assign core_key_run_en_o    = (state_cur == S_ENC_RUN) | (state_cur == S_DEC_KEY_RUN) | (state_cur == S_DEC_RUN);
-assign key_reg_sel_o        = (state_cur == S_DEC_PRE);
+assign core_pt_ld_en_o      = (start && (mode_i == MODE_ENC)) | start_hit | start_rk | (state_cur == S_DEC_PRE);
+assign core_pt_run_en_o     = rnd_run & step & ~round_last;
+assign core_key_ld_en_o     = core_srst_o;
+assign core_key_run_en_o    = ((rnd_run & step & ~rk_use_r) | (state_cur == S_DEC_KEY_RUN)) & ~round_last;
+assign core_rk_cnt_o        = round_cnt_r;
+assign core_last_o          = run_out;
+assign core_rnd_en_o        = rnd_run;
+assign key_reg_sel_o        = (state_cur == S_DEC_PRE) | start_hit;
+assign key_fill_o           = (state_cur == S_DEC_PRE) & ~RK_RAM;
 
-if (NKW == 4) begin: g_if_nkw_eq_4
-    assign key_reg_ld_en_o = (state_cur == S_DEC_KEY_RUN) && (round_cnt_r == (N_ROUNDS-1-3)) ? (1 << 3) :
-                             (state_cur == S_DEC_KEY_RUN) && (round_cnt_r == (N_ROUNDS-1-2)) ? (1 << 2) :
-                             (state_cur == S_DEC_KEY_RUN) && (round_cnt_r == (N_ROUNDS-1-1)) ? (1 << 1) :
-                             (state_cur == S_DEC_KEY_RUN) && (round_cnt_r == (N_ROUNDS-1  )) ? (1     ) :
-                                                                                               '0;
-end else if (NKW == 3) begin:g_if_nkw_eq_3
-    assign key_reg_ld_en_o = (state_cur == S_DEC_KEY_RUN) && (round_cnt_r == (N_ROUNDS-1-2)) ? (1 << 2) :
-                             (state_cur == S_DEC_KEY_RUN) && (round_cnt_r == (N_ROUNDS-1-1)) ? (1 << 1) :
-                             (state_cur == S_DEC_KEY_RUN) && (round_cnt_r == (N_ROUNDS-1  )) ? (1     ) :
-                                                                                               '0;
-end else if (NKW == 2) begin:g_if_nkw_eq_2
-    assign key_reg_ld_en_o = (state_cur == S_DEC_KEY_RUN) && (round_cnt_r == (N_ROUNDS-1-1)) ? (1 << 1) :
-                             (state_cur == S_DEC_KEY_RUN) && (round_cnt_r == (N_ROUNDS-1  )) ? (1     ) :
-                                                                                               '0;
+// Key k_(T-1-i) is captured into key reg i: it is the round key of stage (T-1-i)%UNROLL in run cycle (T-1-i)/UNROLL
+// (not needed with RK_RAM: the decryption reads all the stored keys backward)
+for (genvar i=0; i<NKW; i++) begin: g_for_key_reg
+    assign key_reg_ld_en_o[i] = !RK_RAM && (state_cur == S_DEC_KEY_RUN) && (round_cnt_r == CNT_W'((n_rounds_i-1-i) / UNROLL));
 end
 
+// -- Round Key RAM ------------------------------------------------------------------------------- //
+assign rk_rd_en_o       = rk_use_r;
+assign rk_wr_en_o       = RK_RAM && (((state_cur == S_ENC_RUN) && !rk_use_r) || (state_cur == S_DEC_KEY_RUN));
+assign rk_tag_ld_o      = RK_RAM && start && !rk_hit_i;
+assign rk_valid_set_o   = rk_wr_en_o && round_last;
+
 // -- Output -------------------------------------------------------------------------------------- //
-always_ff @(posedge clk, negedge arst_n) begin: ff_ready_o
-    if (!arst_n) begin
-        ready_o <= 0;
-    end else begin
-        if ( (state_cur == S_ENC_PRE) || (state_cur == S_DEC_PRE) ) begin
-            ready_o <= 1;
-        end else begin
-            ready_o <= 0;
-        end
-    end
-end
+// the input is consumed once its plaintext/ciphertext is loaded (a decryption keeps it during the key prepare)
+assign ready_o  = core_pt_ld_en_o;
 
-always_ff @(posedge clk, negedge arst_n) begin: ff_mode_o
-    if (!arst_n) begin
-        mode_o <= 0;
-    end else begin
-        if (state_nxt == S_OUTPUT) begin
-            if (state_cur == S_ENC_RUN) begin
-                mode_o <= MODE_ENC;
-            end else begin // S_DEC_RUN
-                mode_o <= MODE_DEC;
-            end
-        end
-    end
-end
+assign valid_o  = run_out;
+assign mode_o   = (state_cur == S_DEC_RUN) ? MODE_DEC : MODE_ENC;
+assign active_o = (state_cur != S_IDLE) | valid_i;
+assign key_prep_o = (state_cur == S_DEC_KEY_RUN);
 
-assign valid_o = (state_cur == S_OUTPUT) ? 1'b1 : 1'b0;
-assign active_o = (state_cur == S_IDLE) ? 1'b0 : 1'b1;
+// -- Assertion Properties ------------------------------------------------------------------------ //
+// synthesis translate_off
+assert property (@(posedge clk) disable iff(!arst_n)
+    active_o |-> (n_rounds_i <= N_ROUNDS) && (n_rounds_i % UNROLL == N_ROUNDS % UNROLL) && (n_rounds_i > NKW))
+    else $error("n_rounds_i=%0d should not exceed %0d, have the same remainder modulo UNROLL (the core's remainder path) and exceed NKW", n_rounds_i, N_ROUNDS);
+// synthesis translate_on
 
 // -- Design Parameter Assertions ----------------------------------------------------------------- //
 // synthesis translate_off
 initial begin
     #0 assert (WW inside {16, 24, 32, 48, 64}) else $error("Illegal WW parameter value %0d -- legal values: 16, 24, 32, 48, 64", WW);
+    #0 assert ((UNROLL >= 1) && (UNROLL <= N_ROUNDS)) else $error("Illegal UNROLL parameter value %0d -- must be in 1..%0d (the number of rounds)", UNROLL, N_ROUNDS);
+    #0 assert (!MASKED || ((UNROLL == 1) && !RK_RAM)) else $error("MASKED requires UNROLL = 1 (got %0d) and RK_RAM = 0 (got %0d)", UNROLL, RK_RAM);
     
     if (WW == 16)
         #0 assert (NKW == 4) else $error("Illegal NKW parameter value %0d -- legal values for WW = %0d: 4", NKW, WW);
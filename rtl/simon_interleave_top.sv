@@ -0,0 +1,352 @@
+/**
+ * @info NSA's Simon cipher interleaved top module
+ *
+ * @author Anastasios Psarras (a.psarras4225@gmail.com)
+ *
+ * @license MIT license, check license.md
+ *
+ * @brief Simon generic implementation with a fixed word size n and number of keywords m [ref], interleaving P blocks
+ *        [ref] R. Beaulieu, D. Shors, J. Smith, S. Treatman-Clark, B. Weeks, L. Wingers, "The Simon and Speck Families of Lightweight Block Ciphers", DAC 2015
+ *        Same configurations (see simon_top) and same ready/valid interfaces as simon_top. The round feedback loop holds
+ *        INTERLEAVE (P) contexts in a ring of P registers, and one simon_round + simon_key_schedule sits between the
+ *        last and the first ring register. Each context (text, key words, mode, round counter & z bit) advances one
+ *        round each time it goes through the datapath, i.e. every P cycles, so P independent blocks share the datapath
+ *        round-robin, at one round per cycle in total. The P-1 extra registers of the loop are meant to be retimed
+ *        into the round & key schedule logic, for a higher clock rate than simon_top's single-register loop.
+ *        The z bit of each round comes from a constant table indexed by the context's round counter, one round ahead,
+ *        instead of a per-context LFSR state.
+ *
+ *        A context is loaded from the input when it passes through an empty slot. Decryptions first run T-m key
+ *        expansion passes (no round, as in simon_pipe_top), then reverse their key words and run the T rounds with the
+ *        inverse key schedule. As with simon_top, the input/output words of a decryption are swapped (see tb_top).
+ *        Results leave in input order: a finished context whose turn has not come yet keeps its slot, and goes on the
+ *        next time it passes through the datapath. A 2-entry output FIFO decouples the ring from ready_i.
+ *
+ *        Throughput: P blocks per P*T cycles (P*(2T-m) for decryptions) with all P contexts busy, i.e. one round per
+ *        cycle, as simon_top, at the clock rate the retimed loop allows. Mixed encryptions/decryptions lose some of it,
+ *        since a finished block waiting for an older one holds its context.
+ *
+ * @param WW            Defines the word size (n in [ref])
+ * @param NKW           Defines the number of key words (m in [ref]).
+ * @param DATA_RST      Sets whether the data registers are resettable to zero (for testability?)
+ *                      Note that resettable data FFs will result to a higher area footprint
+ * @param INTERLEAVE    Number P of interleaved contexts (ring registers in the round loop)
+ */
+
+module simon_interleave_top
+#(
+    parameter int   WW          = 16,
+    parameter int   NKW         = 4,
+    parameter logic DATA_RST    = 1'b0,
+    parameter int   INTERLEAVE  = 4
+)
+(
+    input  logic                    clk,        // clock, @posedge
+    input  logic                    arst_n,     // async reset -- active low
+    // Activity
+    output logic                    active_o,   // indicates when there's activity in the block (for architectural clock gating perhaps?)
+    // Input Interface
+    input  logic                    valid_i,    // when asserted, it indicates that input is valid and the block must start processing pt_i/key_i
+    output logic                    ready_o,    // when asserted and valid_i is also asserted, the input has been loaded into a context
+    input  logic                    mode_i,     // 0: encrypt / 1: decrypt (only matters when valid_i is asserted)
+    input  logic[2-1:0][WW-1:0]     pt_i,       // input plaintext
+    input  logic[NKW-1:0][WW-1:0]   key_i,      // input key
+    // Output Interface
+    output logic                    valid_o,    // when asserted, a plaintext/ciphertext-key pair has been processed and ct_o contains valid data
+    input  logic                    ready_i,    // when asserted and valid_o is also asserted, output ct_o is considered as read
+    output logic                    mode_o,     // 0: encrypt / 1: decrypt (only matters when valid_o is asserted)
+    output logic[2-1:0][WW-1:0]     ct_o        // output ciphertext (on encryption mode), or plaintext (on decryption mode)
+);
+
+// -- Constants ----------------------------------------------------------------------------------- //
+import simon_const_pkg::*;
+localparam int              N_ROUNDS    = simon_n_rounds(WW, NKW);
+localparam int              N_PRE       = N_ROUNDS - NKW;                       // key expansion passes of decryptions
+localparam int              P           = INTERLEAVE;
+localparam int              RC_W        = $clog2(N_ROUNDS);                     // round counter width
+localparam int              ORD_W       = $clog2(P) + 1;                        // input order tag width (> P blocks in flight)
+localparam logic[WW-1:0]    C_CONSTANT  = (1 << WW) - 4;
+
+// z bit of round/key expansion step r: forward (encryption & key expansion) and inverse key schedule (decryption)
+function automatic logic[N_ROUNDS-1:0] z_enc_table();
+    logic[N_ROUNDS-1:0] tab;
+    for (int r=0; r<N_ROUNDS; r++) begin
+        tab[r] = simon_z_bit(WW, NKW, r);
+    end
+    return tab;
+endfunction
+
+function automatic logic[N_ROUNDS-1:0] z_dec_table();
+    logic[N_ROUNDS-1:0] tab;
+    for (int r=0; r<N_ROUNDS; r++) begin
+        tab[r] = (N_ROUNDS-1-r-NKW >= 0) ? simon_z_bit(WW, NKW, N_ROUNDS-1-r-NKW) : 1'b0;
+    end
+    return tab;
+endfunction
+
+localparam logic[N_ROUNDS-1:0] Z_ENC = z_enc_table();
+localparam logic[N_ROUNDS-1:0] Z_DEC = z_dec_table();
+
+// -- Signal Definitions -------------------------------------------------------------------------- //
+// context ring registers -- ring_*_r[P-1] goes through the datapath into ring_*_r[0]
+logic                                   ring_valid_r[P];
+logic                                   ring_done_r [P];    // finished, waiting for its turn to the output
+logic                                   ring_run_r  [P];    // 0: key expansion (decryptions), 1: rounds
+logic                                   ring_mode_r [P];
+logic[ORD_W-1:0]                        ring_ord_r  [P];
+logic[RC_W-1:0]                         ring_cnt_r  [P];
+logic                                   ring_z_r    [P];
+logic[1:0][WW-1:0]                      ring_pt_r   [P];
+logic[NKW-1:0][WW-1:0]                  ring_key_r  [P];
+// datapath (context at ring_*_r[P-1])
+logic                                   h_valid, h_done, h_run, h_mode, h_z;
+logic[ORD_W-1:0]                        h_ord;
+logic[RC_W-1:0]                         h_cnt;
+logic[1:0][WW-1:0]                      h_pt;
+logic[NKW-1:0][WW-1:0]                  h_key;
+logic[1:0][WW-1:0]                      rnd_pt;
+logic[NKW-1:0][WW-1:0]                  ks_key;
+logic                                   last_pre;
+logic                                   last_run;
+// next context into ring_*_r[0]
+logic                                   n_valid, n_done, n_run, n_mode, n_z;
+logic[ORD_W-1:0]                        n_ord;
+logic[RC_W-1:0]                         n_cnt;
+logic[1:0][WW-1:0]                      n_pt;
+logic[NKW-1:0][WW-1:0]                  n_key;
+// slot control
+logic[ORD_W-1:0]                        in_ord_r;           // order tag of the next input
+logic[ORD_W-1:0]                        out_ord_r;          // order tag of the next output
+logic                                   retire;             // the context leaves for the output FIFO
+logic                                   load;               // a new block is loaded into the slot
+logic                                   fifo_ready;
+logic[1:0][WW-1:0]                      retire_ct;
+
+// -- Datapath ------------------------------------------------------------------------------------ //
+assign h_valid  = ring_valid_r[P-1];
+assign h_done   = ring_done_r[P-1];
+assign h_run    = ring_run_r[P-1];
+assign h_mode   = ring_mode_r[P-1];
+assign h_ord    = ring_ord_r[P-1];
+assign h_cnt    = ring_cnt_r[P-1];
+assign h_z      = ring_z_r[P-1];
+assign h_pt     = ring_pt_r[P-1];
+assign h_key    = ring_key_r[P-1];
+
+simon_key_schedule
+#(
+    .WW         (WW ),
+    .NKW        (NKW)
+)
+i_key_schedule
+(
+    .mode_i     ((h_mode == MODE_DEC) && h_run ? MODE_DEC : MODE_ENC),
+
+    .key_cur_i  (h_key),
+    .c_xor_z_i  (C_CONSTANT ^ h_z),
+
+    .key_nxt_o  (ks_key)
+);
+
+simon_round
+#(
+    .WW (WW)
+)
+i_round
+(
+    .key_i (h_key[0]),
+
+    .x_i   (h_pt[1]),
+    .y_i   (h_pt[0]),
+
+    .x_o   (rnd_pt[1]),
+    .y_o   (rnd_pt[0])
+);
+
+assign last_pre = !h_run && (h_cnt == N_PRE-1);
+assign last_run =  h_run && (h_cnt == N_ROUNDS-1);
+
+// -- Slot Control -------------------------------------------------------------------------------- //
+// a finished context (just now, or in a previous pass) retires when it is the oldest one & the FIFO has room
+assign retire       = h_valid && (h_done || last_run) && (h_ord == out_ord_r) && fifo_ready;
+assign retire_ct    = h_done ? h_pt : rnd_pt;
+assign ready_o      = !h_valid || retire;
+assign load         = valid_i && ready_o;
+
+always_comb begin: comb_next_ctx
+    // default: the context goes round unchanged (empty, or finished & waiting)
+    n_valid = h_valid && !retire;
+    n_done  = h_done;
+    n_run   = h_run;
+    n_mode  = h_mode;
+    n_ord   = h_ord;
+    n_cnt   = h_cnt;
+    n_z     = h_z;
+    n_pt    = h_pt;
+    n_key   = h_key;
+
+    if (load) begin
+        // new block: encryptions start with their rounds, decryptions with the key expansion
+        n_valid = 1'b1;
+        n_done  = 1'b0;
+        n_run   = (mode_i == MODE_ENC);
+        n_mode  = mode_i;
+        n_ord   = in_ord_r;
+        n_cnt   = '0;
+        n_z     = Z_ENC[0];
+        n_pt    = pt_i;
+        n_key   = key_i;
+    end else if (h_valid && !h_done && !retire) begin
+        // one round (or key expansion step)
+        n_done  = last_run;
+        n_run   = h_run || last_pre;
+        n_cnt   = last_pre ? '0 : h_cnt + 1;
+        n_pt    = h_run ? rnd_pt : h_pt;
+        if (last_pre) begin
+            // expanded decryption keys k_(T-m)..k_(T-1) are reversed for the inverse key schedule
+            for (int i=0; i<NKW; i++) begin
+                n_key[i] = ks_key[NKW-1-i];
+            end
+        end else begin
+            n_key   = ks_key;
+        end
+        // z bit of the next step, computed a round ahead
+        if (last_run) begin
+            n_z = 1'b0;
+        end else if ((h_mode == MODE_DEC) && n_run) begin
+            n_z = Z_DEC[n_cnt];
+        end else begin
+            n_z = Z_ENC[n_cnt];
+        end
+    end
+end
+
+always_ff @(posedge clk, negedge arst_n) begin: ff_ord
+    if (!arst_n) begin
+        in_ord_r    <= '0;
+        out_ord_r   <= '0;
+    end else begin
+        if (load) begin
+            in_ord_r    <= in_ord_r + 1;
+        end
+        if (retire) begin
+            out_ord_r   <= out_ord_r + 1;
+        end
+    end
+end
+
+// -- Context Ring -------------------------------------------------------------------------------- //
+for (genvar p=0; p<P; p++) begin: g_for_ring
+    localparam int PREV = (p + P - 1) % P;
+
+    // control registers -- always resettable
+    always_ff @(posedge clk, negedge arst_n) begin: ff_ctrl
+        if (!arst_n) begin
+            ring_valid_r[p] <= 1'b0;
+            ring_done_r[p]  <= 1'b0;
+            ring_run_r[p]   <= 1'b0;
+            ring_mode_r[p]  <= 1'b0;
+            ring_ord_r[p]   <= '0;
+            ring_cnt_r[p]   <= '0;
+            ring_z_r[p]     <= 1'b0;
+        end else begin
+            if (p == 0) begin
+                ring_valid_r[p] <= n_valid;
+                ring_done_r[p]  <= n_done;
+                ring_run_r[p]   <= n_run;
+                ring_mode_r[p]  <= n_mode;
+                ring_ord_r[p]   <= n_ord;
+                ring_cnt_r[p]   <= n_cnt;
+                ring_z_r[p]     <= n_z;
+            end else begin
+                ring_valid_r[p] <= ring_valid_r[PREV];
+                ring_done_r[p]  <= ring_done_r[PREV];
+                ring_run_r[p]   <= ring_run_r[PREV];
+                ring_mode_r[p]  <= ring_mode_r[PREV];
+                ring_ord_r[p]   <= ring_ord_r[PREV];
+                ring_cnt_r[p]   <= ring_cnt_r[PREV];
+                ring_z_r[p]     <= ring_z_r[PREV];
+            end
+        end
+    end
+
+    if (DATA_RST) begin: g_if_data_rst
+        always_ff @(posedge clk, negedge arst_n) begin: ff_data
+            if (!arst_n) begin
+                ring_pt_r[p]    <= '0;
+                ring_key_r[p]   <= '0;
+            end else begin
+                ring_pt_r[p]    <= (p == 0) ? n_pt  : ring_pt_r[PREV];
+                ring_key_r[p]   <= (p == 0) ? n_key : ring_key_r[PREV];
+            end
+        end
+    end else begin: g_if_no_data_rst
+        always_ff @(posedge clk) begin: ff_data
+            ring_pt_r[p]    <= (p == 0) ? n_pt  : ring_pt_r[PREV];
+            ring_key_r[p]   <= (p == 0) ? n_key : ring_key_r[PREV];
+        end
+    end
+end
+
+// -- Output FIFO --------------------------------------------------------------------------------- //
+sync_fifo
+#(
+    .WIDTH      (1 + 2*WW),
+    .DEPTH      (2),
+    .DATA_RST   (DATA_RST)
+)
+i_out_fifo
+(
+    .clk        (clk),
+    .arst_n     (arst_n),
+    .clr_i      (1'b0),
+
+    .valid_i    (retire),
+    .ready_o    (fifo_ready),
+    .data_i     ({h_mode, retire_ct}),
+
+    .valid_o    (valid_o),
+    .ready_i    (ready_i),
+    .data_o     ({mode_o, ct_o}),
+
+    .count_o    ()
+);
+
+always_comb begin: comb_active
+    active_o = valid_o;
+    for (int p=0; p<P; p++) begin
+        active_o = active_o | ring_valid_r[p];
+    end
+end
+
+// -- Assertion Properties ------------------------------------------------------------------------ //
+// synthesis translate_off
+// input interface
+assert property (@(posedge clk) disable iff(!arst_n)
+    valid_i & ~ready_o |=> $stable({key_i, pt_i, mode_i})) else $error("mode_i, pt_i and key_i should remain stable when valid_i=1 and ready_o=0");
+assert property (@(posedge clk) disable iff(!arst_n)
+    valid_i & ~ready_o |=> valid_i) else $error("valid_i should remain HIGH while ready_o=0");
+// output interface
+assert property (@(posedge clk) disable iff(!arst_n)
+    valid_o & ~ready_i |=> $stable({ct_o, mode_o})) else $error("mode_o and ct_o should remain stable when valid_o=1 and ready_i=0");
+assert property (@(posedge clk) disable iff(!arst_n)
+    valid_o & ~ready_i |=> valid_o) else $error("valid_o should remain HIGH while ready_i=0");
+// synthesis translate_on
+
+// -- Design Parameter Assertions ----------------------------------------------------------------- //
+// synthesis translate_off
+initial begin
+    #0 assert (WW inside {16, 24, 32, 48, 64}) else $error("Illegal WW parameter value %0d -- legal values: 16, 24, 32, 48, 64", WW);
+    #0 assert (INTERLEAVE >= 1) else $error("Illegal INTERLEAVE parameter value %0d -- must be >= 1", INTERLEAVE);
+
+    if (WW == 16)
+        #0 assert (NKW == 4) else $error("Illegal NKW parameter value %0d -- legal values for WW = %0d: 4", NKW, WW);
+    else if ((WW == 24) || (WW == 32))
+        #0 assert (NKW inside {3, 4}) else $error("Illegal NKW parameter value %0d -- legal values for WW = %0d: 3, 4", NKW, WW);
+    else if (WW == 48)
+        #0 assert (NKW inside {2, 3}) else $error("Illegal NKW parameter value %0d -- legal values for WW = %0d: 2, 3", NKW, WW);
+    else if (WW == 64)
+        #0 assert (NKW inside {2, 3, 4}) else $error("Illegal NKW parameter value %0d -- legal values for WW = %0d: 2, 3, 4", NKW, WW);
+end
+// synthesis translate_on
+endmodule
@@ -40,7 +40,9 @@ module simon_key_schedule
     parameter int NKW   = 4   // NKW: Number of Key Words (m) -- Legal values: see 'm' in above table
 )
 (
+    // verilator lint_off UNUSEDSIGNAL
     input  logic                    mode_i,     // 0 for encryption, 1 for decryption
+    // verilator lint_on UNUSEDSIGNAL
     input  logic[NKW-1:0][WW-1:0]   key_cur_i,  // key word inputs
     input  logic[WW-1:0]            c_xor_z_i,  // xor'ed outside
     
@@ -0,0 +1,349 @@
+/**
+ * @info NSA's Simon cipher mode-of-operation top module
+ *
+ * @author Anastasios Psarras (a.psarras4225@gmail.com)
+ *
+ * @license MIT license, check license.md
+ *
+ * @brief ECB, CBC & CTR modes of operation around a simon_top engine (KEY_PERSIST session key mode), so that a
+ *        stream of blocks is chained in hardware, without software in the per-block path.
+ *        -- Session: cfg_valid_i/cfg_ready_o loads the mode of operation (op_i, see simon_const_pkg::OP_*), the
+ *           direction (dir_i) and the IV / initial counter (iv_i), and hands key_i to the engine as its session key.
+ *           A session is accepted once no block is in flight (it drops any keystream prepared for the previous one).
+ *        -- Data: valid_i/ready_o/data_i in, valid_o/ready_i/data_o out, in order. Blocks are in the layout of
+ *           simon_top's encryption input/output both ways -- the word swap of simon_top's decryptions is internal.
+ *
+ *        The chaining value register holds the IV, then:
+ *        -- ECB:         blocks go straight through the engine (dir_i = encrypt / decrypt).
+ *        -- CBC encrypt: C_i = E(P_i ^ C_(i-1)), the chaining value is the last ciphertext. Each block depends on the
+ *                        previous result, so one block is in flight at a time (ceil(T/UNROLL) + 3 cycles per block).
+ *        -- CBC decrypt: P_i = D(C_i) ^ C_(i-1), the chaining value is the last ciphertext in. Blocks are independent:
+ *                        the previous ciphertext of each one waits in a FIFO for its result, and the engine runs
+ *                        back-to-back.
+ *        -- CTR:         O_i = D_i ^ E(IV + i) both ways, the chaining value is the counter (2n-bit, wrapping). The
+ *                        counters are encrypted as soon as possible, without waiting for data: up to KS_DEPTH
+ *                        keystream blocks are produced ahead, and each data block is then XOR'ed with the oldest one
+ *                        as it goes through (valid_o/ready_o combinationally follow valid_i/ready_i).
+ *        Not supported yet: XTS, which needs a second key and a GF(2^2n) tweak multiplier (standard reduction
+ *        polynomials only exist for some of the Simon block sizes).
+ *
+ * @param WW        Defines the word size (n in [ref], see simon_top)
+ * @param NKW       Defines the number of key words (m in [ref]).
+ * @param DATA_RST  Sets whether the data registers are resettable to zero
+ * @param UNROLL    Number of rounds performed per cycle by the engine (see simon_top)
+ * @param DEC_KEY_CACHE_DEPTH   Decryption key cache entries of the engine (see simon_top)
+ * @param KS_DEPTH  CTR: number of keystream blocks produced ahead of the data
+ */
+
+module simon_mode_top
+#(
+    parameter int   WW          = 16,
+    parameter int   NKW         = 4,
+    parameter logic DATA_RST    = 1'b0,
+    parameter int   UNROLL      = 1,
+    parameter int   DEC_KEY_CACHE_DEPTH = 1,
+    parameter int   KS_DEPTH    = 4
+)
+(
+    input  logic                    clk,        // clock, @posedge
+    input  logic                    arst_n,     // async reset -- active low
+    // Activity
+    output logic                    active_o,   // indicates when there's activity in the block (for architectural clock gating perhaps?)
+    // Session Interface
+    input  logic                    cfg_valid_i,// when asserted, op_i/dir_i/iv_i/key_i start a new session
+    output logic                    cfg_ready_o,// when asserted and cfg_valid_i is also asserted, the session has been loaded (no block in flight)
+    input  logic[1:0]               op_i,       // mode of operation: OP_ECB / OP_CBC / OP_CTR
+    input  logic                    dir_i,      // 0: encrypt / 1: decrypt
+    input  logic[2-1:0][WW-1:0]     iv_i,       // IV (CBC) or initial counter (CTR)
+    input  logic[NKW-1:0][WW-1:0]   key_i,      // session key
+    // Input Interface
+    input  logic                    valid_i,    // when asserted, data_i is the next block of the session
+    output logic                    ready_o,    // when asserted and valid_i is also asserted, the block has been accepted
+    input  logic[2-1:0][WW-1:0]     data_i,     // input block (plaintext to encrypt, ciphertext to decrypt)
+    // Output Interface
+    output logic                    valid_o,    // when asserted, data_o contains the next result of the session
+    input  logic                    ready_i,    // when asserted and valid_o is also asserted, data_o is considered as read
+    output logic[2-1:0][WW-1:0]     data_o      // output block
+);
+
+// -- Constants ----------------------------------------------------------------------------------- //
+import simon_const_pkg::*;
+// CBC decryption: blocks held by the engine (staged, running, finished)
+localparam int CBC_DEPTH    = 3;
+localparam int FLIGHT_W     = $clog2((KS_DEPTH > CBC_DEPTH ? KS_DEPTH : CBC_DEPTH) + 1);
+
+// -- Handy Functions ----------------------------------------------------------------------------- //
+// simon_top's decryptions take and produce their words swapped
+function automatic logic[1:0][WW-1:0] swap(input logic[1:0][WW-1:0] a);
+    return {a[0], a[1]};
+endfunction
+
+// -- Signal Definitions -------------------------------------------------------------------------- //
+// session
+logic                   op_cbc_r, op_ctr_r;
+logic                   dir_r;
+logic                   cfg_hs;
+logic[1:0][WW-1:0]      chain_r;        // chaining value: IV, last ciphertext (CBC) or counter (CTR)
+// engine interfaces
+logic                   eng_active;
+logic                   eng_key_ready;
+logic                   eng_valid_i;
+logic                   eng_ready_o;
+logic                   eng_mode_i;
+logic[1:0][WW-1:0]      eng_pt_i;
+logic                   eng_valid_o;
+logic                   eng_ready_i;
+logic[1:0][WW-1:0]      eng_ct_o;
+logic                   eng_in_hs;
+logic                   eng_out_hs;
+logic[FLIGHT_W-1:0]     n_flight_r;     // blocks in the engine
+// CBC decryption: previous ciphertexts
+logic                   prev_ready;
+logic                   prev_valid;
+logic[1:0][WW-1:0]      prev_ct;
+// CTR: keystream
+logic                   ks_ready;
+logic                   ks_valid;
+logic[1:0][WW-1:0]      ks;
+logic[$clog2(KS_DEPTH+1)-1:0] ks_count;
+logic                   ks_pop;
+
+// -- Session ------------------------------------------------------------------------------------- //
+assign cfg_ready_o  = (n_flight_r == '0);
+assign cfg_hs       = cfg_valid_i & cfg_ready_o;
+
+always_ff @(posedge clk, negedge arst_n) begin: ff_session
+    if (!arst_n) begin
+        op_cbc_r    <= 1'b0;
+        op_ctr_r    <= 1'b0;
+        dir_r       <= MODE_ENC;
+    end else begin
+        if (cfg_hs) begin
+            op_cbc_r    <= (op_i == OP_CBC);
+            op_ctr_r    <= (op_i == OP_CTR);
+            dir_r       <= dir_i;
+        end
+    end
+end
+
+// -- Engine Input -------------------------------------------------------------------------------- //
+always_comb begin: comb_eng_in
+    // ECB & CBC: the input block goes in with its direction
+    eng_valid_i = valid_i;
+    eng_mode_i  = dir_r;
+    eng_pt_i    = (dir_r == MODE_DEC) ? swap(data_i) : data_i;
+    ready_o     = eng_ready_o;
+
+    if (op_cbc_r && (dir_r == MODE_ENC)) begin
+        // CBC encryption: one block at a time, chained to the last ciphertext
+        eng_valid_i = valid_i && (n_flight_r == '0);
+        eng_pt_i    = data_i ^ chain_r;
+        ready_o     = eng_ready_o && (n_flight_r == '0);
+    end else if (op_cbc_r) begin
+        // CBC decryption: the previous ciphertext waits for the block's result
+        eng_valid_i = valid_i && prev_ready;
+        ready_o     = eng_ready_o && prev_ready;
+    end else if (op_ctr_r) begin
+        // CTR: counters go in while the keystream has room, the data only meets the keystream at the output
+        eng_valid_i = (n_flight_r + ks_count) < KS_DEPTH;
+        eng_mode_i  = MODE_ENC;
+        eng_pt_i    = chain_r;
+        ready_o     = ks_valid && ready_i;
+    end
+
+    // nothing goes into the engine while a new session is loaded
+    if (cfg_hs) begin
+        eng_valid_i = 1'b0;
+        ready_o     = ready_o && op_ctr_r;
+    end
+end
+
+assign eng_in_hs    = eng_valid_i & eng_ready_o;
+assign eng_out_hs   = eng_valid_o & eng_ready_i;
+
+always_ff @(posedge clk, negedge arst_n) begin: ff_flight
+    if (!arst_n) begin
+        n_flight_r <= '0;
+    end else begin
+        if (eng_in_hs && !eng_out_hs) begin
+            n_flight_r <= n_flight_r + 1;
+        end else if (eng_out_hs && !eng_in_hs) begin
+            n_flight_r <= n_flight_r - 1;
+        end
+    end
+end
+
+// -- Chaining Value ------------------------------------------------------------------------------ //
+if (DATA_RST) begin: g_if_data_rst
+    always_ff @(posedge clk, negedge arst_n) begin: ff_chain
+        if (!arst_n) begin
+            chain_r <= '0;
+        end else begin
+            if (cfg_hs) begin
+                chain_r <= iv_i;
+            end else if (op_ctr_r && eng_in_hs) begin
+                chain_r <= chain_r + 1;
+            end else if (op_cbc_r && (dir_r == MODE_DEC) && eng_in_hs) begin
+                chain_r <= data_i;
+            end else if (op_cbc_r && (dir_r == MODE_ENC) && eng_out_hs) begin
+                chain_r <= eng_ct_o;
+            end
+        end
+    end
+end else begin: g_if_not_data_rst
+    always_ff @(posedge clk) begin: ff_chain
+        if (cfg_hs) begin
+            chain_r <= iv_i;
+        end else if (op_ctr_r && eng_in_hs) begin
+            chain_r <= chain_r + 1;
+        end else if (op_cbc_r && (dir_r == MODE_DEC) && eng_in_hs) begin
+            chain_r <= data_i;
+        end else if (op_cbc_r && (dir_r == MODE_ENC) && eng_out_hs) begin
+            chain_r <= eng_ct_o;
+        end
+    end
+end
+
+// -- Engine -------------------------------------------------------------------------------------- //
+simon_top
+#(
+    .WW                 (WW),
+    .NKW                (NKW),
+    .DATA_RST           (DATA_RST),
+    .UNROLL             (UNROLL),
+    .DEC_KEY_CACHE_DEPTH(DEC_KEY_CACHE_DEPTH),
+    .KEY_PERSIST        (1'b1),
+    .RK_RAM             (1'b0),
+    .STATS              (1'b0)
+)
+i_eng
+(
+    .clk                (clk),
+    .arst_n             (arst_n),
+
+    .active_o           (eng_active),
+
+    .valid_i            (eng_valid_i),
+    .ready_o            (eng_ready_o),
+    .mode_i             (eng_mode_i),
+    .alg_i              (1'b0),
+    .pt_i               (eng_pt_i),
+    .key_i              (key_i),
+    .key_valid_i        (cfg_hs),
+    .key_ready_o        (eng_key_ready),
+
+    .valid_o            (eng_valid_o),
+    .ready_i            (eng_ready_i),
+    .mode_o             (),
+    .alg_o              (),
+    .ct_o               (eng_ct_o),
+    .rnd_i              ('0),
+
+    .stats_clr_i        (1'b0),
+    .stats_addr_i       ('0),
+    .stats_rdata_o      ()
+);
+
+// -- CBC Decryption: Previous Ciphertexts -------------------------------------------------------- //
+sync_fifo
+#(
+    .WIDTH      (2*WW),
+    .DEPTH      (CBC_DEPTH),
+    .DATA_RST   (DATA_RST)
+)
+i_prev_fifo
+(
+    .clk        (clk),
+    .arst_n     (arst_n),
+    .clr_i      (1'b0),
+
+    .valid_i    (op_cbc_r && (dir_r == MODE_DEC) && eng_in_hs),
+    .ready_o    (prev_ready),
+    .data_i     (chain_r),
+
+    .valid_o    (prev_valid),
+    .ready_i    (op_cbc_r && (dir_r == MODE_DEC) && eng_out_hs),
+    .data_o     (prev_ct),
+
+    .count_o    ()
+);
+
+// -- CTR: Keystream ------------------------------------------------------------------------------ //
+sync_fifo
+#(
+    .WIDTH      (2*WW),
+    .DEPTH      (KS_DEPTH),
+    .DATA_RST   (DATA_RST)
+)
+i_ks_fifo
+(
+    .clk        (clk),
+    .arst_n     (arst_n),
+    .clr_i      (cfg_hs),
+
+    .valid_i    (op_ctr_r && eng_out_hs),
+    .ready_o    (ks_ready),
+    .data_i     (eng_ct_o),
+
+    .valid_o    (ks_valid),
+    .ready_i    (ks_pop),
+    .data_o     (ks),
+
+    .count_o    (ks_count)
+);
+
+assign ks_pop = op_ctr_r & valid_i & ready_i;
+
+// -- Output -------------------------------------------------------------------------------------- //
+always_comb begin: comb_out
+    valid_o     = eng_valid_o;
+    data_o      = (dir_r == MODE_DEC) ? swap(eng_ct_o) : eng_ct_o;
+    eng_ready_i = ready_i;
+
+    if (op_cbc_r && (dir_r == MODE_DEC)) begin
+        data_o      = swap(eng_ct_o) ^ prev_ct;
+    end else if (op_ctr_r) begin
+        valid_o     = valid_i && ks_valid;
+        data_o      = data_i ^ ks;
+        eng_ready_i = ks_ready;
+    end
+end
+
+assign active_o = eng_active | (n_flight_r != '0) | ks_valid | valid_i | cfg_valid_i;
+
+// -- Assertion Properties ------------------------------------------------------------------------ //
+// synthesis translate_off
+// session interface
+assert property (@(posedge clk) disable iff(!arst_n)
+    cfg_valid_i & ~cfg_ready_o |=> $stable({key_i, iv_i, dir_i, op_i})) else $error("op_i, dir_i, iv_i and key_i should remain stable when cfg_valid_i=1 and cfg_ready_o=0");
+assert property (@(posedge clk) disable iff(!arst_n)
+    cfg_valid_i & ~cfg_ready_o |=> cfg_valid_i) else $error("cfg_valid_i should remain HIGH while cfg_ready_o=0");
+assert property (@(posedge clk) disable iff(!arst_n)
+    cfg_valid_i |-> (op_i inside {OP_ECB, OP_CBC, OP_CTR})) else $error("Illegal op_i value %0d", op_i);
+// the engine is empty when a session is loaded, so it always takes the session key
+assert property (@(posedge clk) disable iff(!arst_n)
+    cfg_hs |-> eng_key_ready) else $error("session loaded while the engine could not take its key");
+// input interface
+assert property (@(posedge clk) disable iff(!arst_n)
+    valid_i & ~ready_o |=> $stable(data_i)) else $error("data_i should remain stable when valid_i=1 and ready_o=0");
+assert property (@(posedge clk) disable iff(!arst_n)
+    valid_i & ~ready_o |=> valid_i) else $error("valid_i should remain HIGH while ready_o=0");
+// output interface
+assert property (@(posedge clk) disable iff(!arst_n)
+    valid_o & ~ready_i |=> $stable(data_o)) else $error("data_o should remain stable when valid_o=1 and ready_i=0");
+assert property (@(posedge clk) disable iff(!arst_n)
+    valid_o & ~ready_i |=> valid_o) else $error("valid_o should remain HIGH while ready_i=0");
+// the previous ciphertext & keystream FIFOs never limit the engine's output
+assert property (@(posedge clk) disable iff(!arst_n)
+    op_cbc_r && (dir_r == MODE_DEC) && eng_valid_o |-> prev_valid) else $error("CBC decryption result without its previous ciphertext");
+assert property (@(posedge clk) disable iff(!arst_n)
+    op_ctr_r && eng_valid_o |-> ks_ready) else $error("CTR keystream FIFO full with a keystream block in the engine");
+// synthesis translate_on
+
+// -- Design Parameter Assertions ----------------------------------------------------------------- //
+// synthesis translate_off
+initial begin
+    #0 assert (KS_DEPTH >= 1) else $error("Illegal KS_DEPTH parameter value %0d -- must be >= 1", KS_DEPTH);
+end
+// synthesis translate_on
+endmodule
@@ -0,0 +1,214 @@
+/**
+ * @info NSA's Simon cipher -- multi-engine top module
+ *
+ * @author Anastasios Psarras (a.psarras4225@gmail.com)
+ *
+ * @license MIT license, check license.md
+ *
+ * @brief N_ENGINES simon_top engines behind a single ready/valid interface (same as simon_top's, except for the
+ *        per-engine active_o), for a throughput that scales with the number of engines where simon_pipe_top is
+ *        too big.
+ *        -- Dispatch: each block goes to an engine able to take it (input staging register empty), chosen
+ *           round-robin, starting after the engine granted last.
+ *        -- Reassembly: the index of the engine of each dispatched block is pushed into an order FIFO. Output
+ *           is only taken from the engine at the head of that FIFO, so results leave in input order. Each
+ *           engine processes its own blocks in order, and keeps a finished result in its output holding
+ *           register (stalling) until it is its turn -- which is the reorder buffer.
+ *        An engine holds up to 3 blocks (staged, running, finished) plus its FIFOs' entries, so the order FIFO has
+ *        (3+IN_FIFO_DEPTH+OUT_FIFO_DEPTH)*N_ENGINES entries and never limits dispatch. With engine FIFOs, dispatch
+ *        accepts a burst of blocks every cycle, and the engines keep running while the head of the order waits.
+ *
+ * @param WW        Defines the word size (n in [ref], see simon_top)
+ * @param NKW       Defines the number of key words (m in [ref]).
+ * @param DATA_RST  Sets whether the data registers are resettable to zero
+ * @param UNROLL    Number of rounds performed per cycle by each engine (see simon_top)
+ * @param DEC_KEY_CACHE_DEPTH   Decryption key cache entries of each engine (see simon_top)
+ * @param RK_RAM    Round key RAM mode of each engine (see simon_top)
+ * @param N_ENGINES Number of simon_top engines
+ * @param IN_FIFO_DEPTH     Input FIFO depth of each engine (see simon_top)
+ * @param OUT_FIFO_DEPTH    Output FIFO depth of each engine (see simon_top)
+ */
+
+module simon_multi_top
+#(
+    parameter int   WW          = 16,
+    parameter int   NKW         = 4,
+    parameter logic DATA_RST    = 1'b0,
+    parameter int   UNROLL      = 1,
+    parameter int   DEC_KEY_CACHE_DEPTH = 1,
+    parameter logic RK_RAM      = 1'b0,
+    parameter int   N_ENGINES   = 2,
+    parameter int   IN_FIFO_DEPTH   = 0,
+    parameter int   OUT_FIFO_DEPTH  = 0
+)
+(
+    input  logic                    clk,        // clock, @posedge
+    input  logic                    arst_n,     // async reset -- active low
+    // Activity
+    output logic[N_ENGINES-1:0]     active_o,   // per-engine activity (for architectural clock gating of each engine)
+    // Input Interface
+    input  logic                    valid_i,    // when asserted, it indicates that input is valid and the block must start processing pt_i/key_i
+    output logic                    ready_o,    // when asserted and valid_i is also asserted, the input has been accepted by an engine
+    input  logic                    mode_i,     // 0: encrypt / 1: decrypt (only matters when valid_i is asserted)
+    input  logic[2-1:0][WW-1:0]     pt_i,       // input plaintext
+    input  logic[NKW-1:0][WW-1:0]   key_i,      // input key
+    // Output Interface
+    output logic                    valid_o,    // when asserted, a plaintext/ciphertext-key pair has been processed and ct_o contains valid data
+    input  logic                    ready_i,    // when asserted and valid_o is also asserted, output ct_o is considered as read
+    output logic                    mode_o,     // 0: encrypt / 1: decrypt (only matters when valid_o is asserted)
+    output logic[2-1:0][WW-1:0]     ct_o        // output ciphertext (on encryption mode), or plaintext (on decryption mode), in input order
+);
+
+// -- Constants ----------------------------------------------------------------------------------- //
+localparam int ENG_W        = N_ENGINES > 1 ? $clog2(N_ENGINES) : 1;
+localparam int ORDER_DEPTH  = (3 + IN_FIFO_DEPTH + OUT_FIFO_DEPTH) * N_ENGINES;
+
+// -- Signal Definitions -------------------------------------------------------------------------- //
+// per-engine interfaces
+logic[N_ENGINES-1:0]                eng_valid_i;
+logic[N_ENGINES-1:0]                eng_ready_o;
+logic[N_ENGINES-1:0]                eng_valid_o;
+logic[N_ENGINES-1:0]                eng_ready_i;
+logic[N_ENGINES-1:0]                eng_mode_o;
+logic[N_ENGINES-1:0][1:0][WW-1:0]   eng_ct_o;
+// dispatch
+logic[ENG_W-1:0]                    rr_ptr_r;       // engine granted last
+logic                               disp_found;
+logic[ENG_W-1:0]                    disp_idx;
+logic                               disp_hs;
+// order FIFO
+logic                               order_ready;
+logic                               order_valid;
+logic[ENG_W-1:0]                    order_head;
+logic                               out_hs;
+
+// -- Dispatch ------------------------------------------------------------------------------------ //
+// first engine able to take a block, starting after the one granted last
+always_comb begin: comb_dispatch
+    disp_found  = 1'b0;
+    disp_idx    = '0;
+    for (int i=1; i<=N_ENGINES; i++) begin
+        if (!disp_found && eng_ready_o[(rr_ptr_r + i) % N_ENGINES]) begin
+            disp_found  = 1'b1;
+            disp_idx    = (rr_ptr_r + i) % N_ENGINES;
+        end
+    end
+end
+
+assign ready_o  = disp_found & order_ready;
+assign disp_hs  = valid_i & ready_o;
+
+always_ff @(posedge clk, negedge arst_n) begin: ff_rr_ptr
+    if (!arst_n) begin
+        rr_ptr_r <= ENG_W'(N_ENGINES-1); // engine 0 first
+    end else begin
+        if (disp_hs) begin
+            rr_ptr_r <= disp_idx;
+        end
+    end
+end
+
+for (genvar e=0; e<N_ENGINES; e++) begin: g_for_eng_valid
+    assign eng_valid_i[e] = valid_i & order_ready & disp_found & (disp_idx == e);
+end
+
+// -- Order FIFO ---------------------------------------------------------------------------------- //
+sync_fifo
+#(
+    .WIDTH      (ENG_W),
+    .DEPTH      (ORDER_DEPTH),
+    .DATA_RST   (DATA_RST)
+)
+i_order_fifo
+(
+    .clk        (clk),
+    .arst_n     (arst_n),
+    .clr_i      (1'b0),
+
+    .valid_i    (disp_hs),
+    .ready_o    (order_ready),
+    .data_i     (disp_idx),
+
+    .valid_o    (order_valid),
+    .ready_i    (out_hs),
+    .data_o     (order_head),
+
+    .count_o    ()
+);
+
+// -- Engines ------------------------------------------------------------------------------------- //
+for (genvar e=0; e<N_ENGINES; e++) begin: g_for_eng
+    simon_top
+    #(
+        .WW                 (WW),
+        .NKW                (NKW),
+        .DATA_RST           (DATA_RST),
+        .UNROLL             (UNROLL),
+        .DEC_KEY_CACHE_DEPTH(DEC_KEY_CACHE_DEPTH),
+        .KEY_PERSIST        (1'b0),
+        .RK_RAM             (RK_RAM),
+        .STATS              (1'b0),
+        .IN_FIFO_DEPTH      (IN_FIFO_DEPTH),
+        .OUT_FIFO_DEPTH     (OUT_FIFO_DEPTH)
+    )
+    i_eng
+    (
+        .clk                (clk),
+        .arst_n             (arst_n),
+
+        .active_o           (active_o[e]),
+
+        .valid_i            (eng_valid_i[e]),
+        .ready_o            (eng_ready_o[e]),
+        .mode_i             (mode_i),
+        .alg_i              (1'b0),
+        .pt_i               (pt_i),
+        .key_i              (key_i),
+        .key_valid_i        (1'b0),
+        .key_ready_o        (),
+
+        .valid_o            (eng_valid_o[e]),
+        .ready_i            (eng_ready_i[e]),
+        .mode_o             (eng_mode_o[e]),
+        .alg_o              (),
+        .ct_o               (eng_ct_o[e]),
+        .rnd_i              ('0),
+
+        .stats_clr_i        (1'b0),
+        .stats_addr_i       ('0),
+        .stats_rdata_o      ()
+    );
+
+    assign eng_ready_i[e] = ready_i & order_valid & (order_head == e);
+end
+
+// -- Output -------------------------------------------------------------------------------------- //
+assign valid_o  = order_valid & eng_valid_o[order_head];
+assign mode_o   = eng_mode_o[order_head];
+assign ct_o     = eng_ct_o[order_head];
+assign out_hs   = valid_o & ready_i;
+
+// -- Assertion Properties ------------------------------------------------------------------------ //
+// synthesis translate_off
+// input interface
+assert property (@(posedge clk) disable iff(!arst_n)
+    valid_i & ~ready_o |=> $stable({key_i, pt_i, mode_i})) else $error("mode_i, pt_i and key_i should remain stable when valid_i=1 and ready_o=0");
+assert property (@(posedge clk) disable iff(!arst_n)
+    valid_i & ~ready_o |=> valid_i) else $error("valid_i should remain HIGH while ready_o=0");
+// output interface
+assert property (@(posedge clk) disable iff(!arst_n)
+    valid_o & ~ready_i |=> $stable({ct_o, mode_o})) else $error("mode_o and ct_o should remain stable when valid_o=1 and ready_i=0");
+assert property (@(posedge clk) disable iff(!arst_n)
+    valid_o & ~ready_i |=> valid_o) else $error("valid_o should remain HIGH while ready_i=0");
+// the order FIFO can only be full when every engine is full, i.e. when no engine can take a block
+assert property (@(posedge clk) disable iff(!arst_n)
+    disp_found |-> order_ready) else $error("order FIFO full while an engine can take a block");
+// synthesis translate_on
+
+// -- Design Parameter Assertions ----------------------------------------------------------------- //
+// synthesis translate_off
+initial begin
+    #0 assert (N_ENGINES >= 1) else $error("Illegal N_ENGINES parameter value %0d -- must be >= 1", N_ENGINES);
+end
+// synthesis translate_on
+endmodule
@@ -0,0 +1,273 @@
+/**
+ * @info NSA's Simon cipher fully pipelined top module
+ *
+ * @author Anastasios Psarras (a.psarras4225@gmail.com)
+ *
+ * @license MIT license, check license.md
+ *
+ * @brief Simon generic implementation with a fixed word size n and number of keywords m [ref], fully unrolled & pipelined
+ *        [ref] R. Beaulieu, D. Shors, J. Smith, S. Treatman-Clark, B. Weeks, L. Wingers, "The Simon and Speck Families of Lightweight Block Ciphers", DAC 2015
+ *        Same configurations (see simon_top) and same ready/valid interfaces as simon_top, but a new block can be accepted
+ *        every cycle: T stages of simon_round + simon_key_schedule are separated by registers, and each stage carries its
+ *        own text, key words & mode, so that mixed-key, mixed-mode traffic flows without stalls.
+ *        The z sequence is hardwired per stage (no LFSR), since each stage always runs the same round.
+ *
+ *        Decryption needs the last m round keys first: with DEC_SUPPORT=1, T-m key expansion stages precede the round
+ *        stages. They expand the key of decryptions (encryptions pass through), whose key words are then reversed,
+ *        so that the round stages run the inverse key schedule. Latency is T-m+T cycles (T without DEC_SUPPORT).
+ *        As with simon_top, the input/output words of a decryption are swapped (see tb_top).
+ *
+ *        Backpressure: all stages advance together while the 2-entry output skid buffer is not full; ready_o and the
+ *        stage enables only depend on registers, so there is no combinational path from ready_i to ready_o.
+ *
+ * @param WW            Defines the word size (n in [ref])
+ * @param NKW           Defines the number of key words (m in [ref]).
+ * @param DATA_RST      Sets whether the data registers are resettable to zero (for testability?)
+ *                      Note that resettable data FFs will result to a higher area footprint
+ * @param DEC_SUPPORT   Adds the key expansion stages required for decryption (encryption-only pipeline if 0)
+ */
+
+module simon_pipe_top
+#(
+    parameter int   WW          = 16,
+    parameter int   NKW         = 4,
+    parameter logic DATA_RST    = 1'b0,
+    parameter logic DEC_SUPPORT = 1'b1
+)
+(
+    input  logic                    clk,        // clock, @posedge
+    input  logic                    arst_n,     // async reset -- active low
+    // Activity
+    output logic                    active_o,   // indicates when there's activity in the block (any stage or output buffer occupied)
+    // Input Interface
+    input  logic                    valid_i,    // when asserted, it indicates that input is valid and the block must start processing pt_i/key_i
+    output logic                    ready_o,    // when asserted and valid_i is also asserted, the input has been accepted
+    input  logic                    mode_i,     // 0: encrypt / 1: decrypt (only matters when valid_i is asserted)
+    input  logic[2-1:0][WW-1:0]     pt_i,       // input plaintext
+    input  logic[NKW-1:0][WW-1:0]   key_i,      // input key
+    // Output Interface
+    output logic                    valid_o,    // when asserted, a plaintext/ciphertext-key pair has been processed and ct_o contains valid data
+    input  logic                    ready_i,    // when asserted and valid_o is also asserted, output ct_o is considered as read
+    output logic                    mode_o,     // 0: encrypt / 1: decrypt (only matters when valid_o is asserted)
+    output logic[2-1:0][WW-1:0]     ct_o        // output ciphertext (on encryption mode), or plaintext (on decryption mode)
+);
+// -- Constants ----------------------------------------------------------------------------------- //
+import simon_const_pkg::*;
+localparam int              N_ROUNDS    = simon_n_rounds(WW, NKW);
+localparam int              N_PRE       = DEC_SUPPORT ? N_ROUNDS - NKW : 0;    // key expansion stages
+localparam int              N_STAGES    = N_PRE + N_ROUNDS;
+localparam logic[WW-1:0]    C_CONSTANT  = (1 << WW) - 4;
+
+// -- Signal Definitions -------------------------------------------------------------------------- //
+// stage s inputs: stg_*[s] -- stg_*[0] is the module input, stg_*[s+1] the registers of stage s
+logic                                   stg_valid   [N_STAGES+1];
+logic                                   stg_mode    [N_STAGES+1];
+logic[1:0][WW-1:0]                      stg_pt      [N_STAGES+1];
+logic[NKW-1:0][WW-1:0]                  stg_key     [N_STAGES+1];
+// stage s combinational outputs
+logic[1:0][WW-1:0]                      stg_pt_nxt  [N_STAGES];
+logic[NKW-1:0][WW-1:0]                  stg_key_nxt [N_STAGES];
+// stage s registers
+logic                                   valid_r     [N_STAGES];
+logic                                   mode_r      [N_STAGES];
+logic[1:0][WW-1:0]                      pt_r        [N_STAGES];
+logic[NKW-1:0][WW-1:0]                  key_r       [N_STAGES];
+// pipeline enable
+logic                                   pipe_en;
+// output skid buffer
+logic[1:0]                              skid_valid_r;
+logic[1:0]                              skid_mode_r;
+logic[1:0][1:0][WW-1:0]                 skid_ct_r;
+logic                                   skid_wr_ptr_r;
+logic                                   skid_rd_ptr_r;
+logic                                   skid_push;
+logic                                   skid_pop;
+
+// -- Pipeline Input ------------------------------------------------------------------------------ //
+assign stg_valid[0] = valid_i;
+assign stg_mode[0]  = mode_i;
+assign stg_pt[0]    = pt_i;
+assign stg_key[0]   = key_i;
+
+// -- Stages -------------------------------------------------------------------------------------- //
+for (genvar s=0; s<N_STAGES; s++) begin: g_for_stage
+    if (s < N_PRE) begin: g_if_key_exp
+        // -- Key Expansion Stage: computes k_(s+m) for decryptions ---------------------------------- //
+        logic[NKW-1:0][WW-1:0] key_fwd;
+        simon_key_schedule
+        #(
+            .WW         (WW ),
+            .NKW        (NKW)
+        )
+        i_key_schedule
+        (
+            .mode_i     (MODE_ENC),
+
+            .key_cur_i  (stg_key[s]),
+            .c_xor_z_i  (C_CONSTANT ^ simon_z_bit(WW, NKW, s)),
+
+            .key_nxt_o  (key_fwd)
+        );
+        assign stg_key_nxt[s] = (stg_mode[s] == MODE_DEC) ? key_fwd : stg_key[s];
+        assign stg_pt_nxt[s]  = stg_pt[s];
+    end else begin: g_if_round
+        // -- Round Stage: runs round r -------------------------------------------------------------- //
+        localparam int          R       = s - N_PRE;
+        localparam int          Z_DEC   = N_ROUNDS - 1 - R - NKW;   // z index of the inverse key schedule (<0: key unused)
+        localparam logic        Z_ENC_B = simon_z_bit(WW, NKW, R);
+        localparam logic        Z_DEC_B = Z_DEC >= 0 ? simon_z_bit(WW, NKW, Z_DEC) : 1'b0;
+        logic[NKW-1:0][WW-1:0]  key_cur;
+        logic                   z;
+
+        if (DEC_SUPPORT && (R == 0)) begin: g_if_first
+            // expanded decryption keys k_(T-m)..k_(T-1) are reversed for the inverse key schedule
+            for (genvar i=0; i<NKW; i++) begin: g_for_i
+                assign key_cur[i] = (stg_mode[s] == MODE_DEC) ? stg_key[s][NKW-1-i] : stg_key[s][i];
+            end
+        end else begin: g_if_not_first
+            assign key_cur = stg_key[s];
+        end
+        assign z = (stg_mode[s] == MODE_DEC) ? Z_DEC_B : Z_ENC_B;
+
+        simon_key_schedule
+        #(
+            .WW         (WW ),
+            .NKW        (NKW)
+        )
+        i_key_schedule
+        (
+            .mode_i     (stg_mode[s]),
+
+            .key_cur_i  (key_cur),
+            .c_xor_z_i  (C_CONSTANT ^ z),
+
+            .key_nxt_o  (stg_key_nxt[s])
+        );
+
+        simon_round
+        #(
+            .WW (WW)
+        )
+        i_round
+        (
+            .key_i (key_cur[0]),
+
+            .x_i   (stg_pt[s][1]),
+            .y_i   (stg_pt[s][0]),
+
+            .x_o   (stg_pt_nxt[s][1]),
+            .y_o   (stg_pt_nxt[s][0])
+        );
+    end
+
+    // -- Stage Registers ----------------------------------------------------------------------- //
+    always_ff @(posedge clk, negedge arst_n) begin: ff_valid
+        if (!arst_n) begin
+            valid_r[s] <= 1'b0;
+        end else if (pipe_en) begin
+            valid_r[s] <= stg_valid[s];
+        end
+    end
+
+    if (DATA_RST) begin: g_if_data_rst
+        always_ff @(posedge clk, negedge arst_n) begin: ff_data
+            if (!arst_n) begin
+                mode_r[s]   <= 1'b0;
+                pt_r[s]     <= '0;
+                key_r[s]    <= '0;
+            end else if (pipe_en && stg_valid[s]) begin
+                mode_r[s]   <= stg_mode[s];
+                pt_r[s]     <= stg_pt_nxt[s];
+                key_r[s]    <= stg_key_nxt[s];
+            end
+        end
+    end else begin: g_if_no_data_rst
+        always_ff @(posedge clk) begin: ff_data
+            if (pipe_en && stg_valid[s]) begin
+                mode_r[s]   <= stg_mode[s];
+                pt_r[s]     <= stg_pt_nxt[s];
+                key_r[s]    <= stg_key_nxt[s];
+            end
+        end
+    end
+    
+    assign stg_valid[s+1]   = valid_r[s];
+    assign stg_mode[s+1]    = mode_r[s];
+    assign stg_pt[s+1]      = pt_r[s];
+    assign stg_key[s+1]     = key_r[s];
+end
+
+// -- Output Skid Buffer -------------------------------------------------------------------------- //
+// The pipeline advances while the buffer has a free entry (at most one entry is added per cycle)
+assign pipe_en      = ~(skid_valid_r[0] & skid_valid_r[1]);
+assign skid_push    = pipe_en & stg_valid[N_STAGES];
+assign skid_pop     = valid_o & ready_i;
+
+always_ff @(posedge clk, negedge arst_n) begin: ff_skid_ctrl
+    if (!arst_n) begin
+        skid_valid_r    <= '0;
+        skid_wr_ptr_r   <= 1'b0;
+        skid_rd_ptr_r   <= 1'b0;
+    end else begin
+        if (skid_push) begin
+            skid_valid_r[skid_wr_ptr_r] <= 1'b1;
+            skid_wr_ptr_r               <= ~skid_wr_ptr_r;
+        end
+        if (skid_pop) begin
+            skid_valid_r[skid_rd_ptr_r] <= 1'b0;
+            skid_rd_ptr_r               <= ~skid_rd_ptr_r;
+        end
+    end
+end
+
+always_ff @(posedge clk) begin: ff_skid_data
+    if (skid_push) begin
+        skid_mode_r[skid_wr_ptr_r]  <= stg_mode[N_STAGES];
+        skid_ct_r[skid_wr_ptr_r]    <= stg_pt[N_STAGES];
+    end
+end
+
+// -- Outputs ------------------------------------------------------------------------------------- //
+assign ready_o  = pipe_en;
+assign valid_o  = skid_valid_r[skid_rd_ptr_r];
+assign mode_o   = skid_mode_r[skid_rd_ptr_r];
+assign ct_o     = skid_ct_r[skid_rd_ptr_r];
+always_comb begin: comb_active
+    active_o = |skid_valid_r;
+    for (int s=0; s<N_STAGES; s++) begin
+        active_o = active_o | valid_r[s];
+    end
+end
+
+// -- Assertion Properties ------------------------------------------------------------------------ //
+// synthesis translate_off
+// input interface
+assert property (@(posedge clk) disable iff(!arst_n)
+    valid_i & ~ready_o |=> $stable({key_i, pt_i, mode_i})) else $error("mode_i, pt_i and key_i should remain stable when valid_i=1 and ready_o=0");
+assert property (@(posedge clk) disable iff(!arst_n)
+    valid_i & ~ready_o |=> valid_i) else $error("valid_i should remain HIGH while ready_o=0");
+assert property (@(posedge clk) disable iff(!arst_n)
+    valid_i |-> (DEC_SUPPORT || (mode_i == MODE_ENC))) else $error("decryption requested (mode_i=1) but DEC_SUPPORT=0");
+// output interface
+assert property (@(posedge clk) disable iff(!arst_n)
+    valid_o & ~ready_i |=> $stable({ct_o, mode_o})) else $error("mode_o and ct_o should remain stable when valid_o=1 and ready_i=0");
+assert property (@(posedge clk) disable iff(!arst_n)
+    valid_o & ~ready_i |=> valid_o) else $error("valid_o should remain HIGH while ready_i=0");
+// synthesis translate_on
+
+// -- Design Parameter Assertions ----------------------------------------------------------------- //
+// synthesis translate_off
+initial begin
+    #0 assert (WW inside {16, 24, 32, 48, 64}) else $error("Illegal WW parameter value %0d -- legal values: 16, 24, 32, 48, 64", WW);
+
+    if (WW == 16)
+        #0 assert (NKW == 4) else $error("Illegal NKW parameter value %0d -- legal values for WW = %0d: 4", NKW, WW);
+    else if ((WW == 24) || (WW == 32))
+        #0 assert (NKW inside {3, 4}) else $error("Illegal NKW parameter value %0d -- legal values for WW = %0d: 3, 4", NKW, WW);
+    else if (WW == 48)
+        #0 assert (NKW inside {2, 3}) else $error("Illegal NKW parameter value %0d -- legal values for WW = %0d: 2, 3", NKW, WW);
+    else if (WW == 64)
+        #0 assert (NKW inside {2, 3, 4}) else $error("Illegal NKW parameter value %0d -- legal values for WW = %0d: 2, 3, 4", NKW, WW);
+end
+// synthesis translate_on
+endmodule
@@ -0,0 +1,84 @@
+/**
+ * @info NSA's Simon round algorithm -- first-order masked (2 shares)
+ *
+ * @author Anastasios Psarras (a.psarras4225@gmail.com)
+ *
+ * @license MIT license, check license.md
+ *
+ * @brief Simon round on Boolean shares (x = x_i[0] ^ x_i[1], same for y and the round key), with the only non-linear
+ *        operation, the AND of f(x) = (x <<< 1) & (x <<< 8), computed as a Domain-Oriented Masking (DOM-indep) AND:
+ *        -- inner-domain products (a_s & b_s) only combine bits of the same share, and stay combinational
+ *        -- cross-domain products (a_0 & b_1, a_1 & b_0) are refreshed with the fresh random word rnd_i and
+ *           registered before they meet the other domain's terms, so that glitches cannot recombine the shares
+ *        All the other operations (rotations, XORs with y and the round key) are linear and are applied share-wise.
+ *        Timing: the cross-domain register is loaded every cycle, so x_o/y_o are valid in the second cycle of stable
+ *        x_i (i.e. a round takes 2 cycles: the text registers must not be written in two consecutive cycles).
+ *        rnd_i must be fresh uniform random bits in every cycle.
+ *
+ * @param WW        Defines the word size (n in [ref], see simon_round)
+ * @param DATA_RST  Sets whether the cross-domain register is resettable to zero
+ */
+
+module simon_round_masked
+#(
+    parameter int   WW          = 16,
+    parameter logic DATA_RST    = 1'b0
+)
+(
+    input  logic                clk,        // clock, @posedge
+    input  logic                arst_n,     // async reset -- active low
+
+    input  logic[1:0][WW-1:0]   key_i,      // round key shares
+    input  logic[1:0][WW-1:0]   x_i,        // x shares
+    input  logic[1:0][WW-1:0]   y_i,        // y shares
+    input  logic[WW-1:0]        rnd_i,      // fresh randomness (one bit per AND)
+
+    output logic[1:0][WW-1:0]   x_o,        // x shares after the round (valid in the 2nd cycle of stable inputs)
+    output logic[1:0][WW-1:0]   y_o         // y shares after the round
+);
+
+// -- Left Rotation handy function ---------------------------------------------------------------- //
+function logic[WW-1:0] rot_left(input logic[WW-1:0] a, input int n);
+    return (a << n) | (a >> (WW-n));
+endfunction
+
+// -- Signal Definitions -------------------------------------------------------------------------- //
+logic[1:0][WW-1:0]  a;          // x <<< 1 shares
+logic[1:0][WW-1:0]  b;          // x <<< 8 shares
+logic[1:0][WW-1:0]  cross_nxt;  // refreshed cross-domain products: share s holds a_s & b_(1-s)
+logic[1:0][WW-1:0]  cross_r;
+
+for (genvar s=0; s<2; s++) begin: g_for_share
+    assign a[s]         = rot_left(x_i[s], 1);
+    assign b[s]         = rot_left(x_i[s], 8);
+    assign cross_nxt[s] = (a[s] & b[1-s]) ^ rnd_i;
+end
+
+// -- Cross-Domain Register ----------------------------------------------------------------------- //
+if (DATA_RST) begin: g_if_data_rst
+    always_ff @(posedge clk, negedge arst_n) begin: ff_cross
+        if (!arst_n) begin
+            cross_r <= '0;
+        end else begin
+            cross_r <= cross_nxt;
+        end
+    end
+end else begin: g_if_no_data_rst
+    always_ff @(posedge clk) begin: ff_cross
+        cross_r <= cross_nxt;
+    end
+end
+
+// -- Outputs ------------------------------------------------------------------------------------- //
+// x_o[0] ^ x_o[1] = y ^ (a & b) ^ (x <<< 2) ^ key, as (a & b) = a_0 b_0 ^ a_1 b_1 ^ a_0 b_1 ^ a_1 b_0
+for (genvar s=0; s<2; s++) begin: g_for_out
+    assign y_o[s] = x_i[s];
+    assign x_o[s] = y_i[s] ^ (a[s] & b[s]) ^ cross_r[s] ^ rot_left(x_i[s], 2) ^ key_i[s];
+end
+
+// synthesis translate_off
+initial begin
+    #0 assert (WW inside {16, 24, 32, 48, 64}) else $error("Illegal WW parameter value %0d -- legal values: 16, 24, 32, 48, 64", WW);
+end
+// synthesis translate_on
+endmodule
@@ -33,12 +33,14 @@
  *
  * @param WW        Defines the word size (n in [ref])
  * @param NKW       Defines the number of key words (m in [ref]).
+ * @param UNROLL    Number of z_j bits produced per enabled cycle (seq_o[0] is z_j, seq_o[1] is z_j+1 etc)
  */
 
 module simon_seq_gen
 #(
     parameter int WW    = 16, // WW: Word Width (n) -- Legal values: see 'n' in above table
-    parameter int NKW   = 4   // NKW: Number of Key Words (m) -- Legal values: see 'm' in above table
+    parameter int NKW   = 4,  // NKW: Number of Key Words (m) -- Legal values: see 'm' in above table
+    parameter int UNROLL= 1   // UNROLL: sequence bits per cycle
 )
 (
     input  logic                clk,        // clock, @posedge
@@ -47,51 +49,28 @@ module simon_seq_gen
     input  logic                mode_i,     // 0 for encrypt, 1 for decrypt
     
     input  logic                rst_seqs_i, // resets sequences
+    input  logic                rst_mode_i, // mode the sequences are reset to (may differ from mode_i, see simon_ctrl_fsm)
     input  logic                run_en_i,   // should be set to '1' when the algo is running (enables lfsr etc)
     
-    output logic                seq_o       // output sequence
+    output logic[UNROLL-1:0]    seq_o       // output sequence -- UNROLL consecutive bits
 );
-// -- UNVERIFIED CONFIGS -- //
-initial begin
-    #0 assert (WW inside {32, 64}) else $error("ONLY WW=32, 64 have been verified using official NSA code! PROCEED AT YOUR OWN RISK");
-end
-// -- UNVERIFIED CONFIGS -- //
-
 // -- Module Self-Configuration ------------------------------------------------------------------- //
-localparam int                              LFSR_N          = 5;
+import simon_const_pkg::*;
+localparam int                              LFSR_N          = SIMON_LFSR_N;
 localparam int                              LFSR_C          = 2;
-// U, V, R & their reverse
-localparam logic[0:LFSR_N-1][0:LFSR_N-1]    LFSR_MATRIX_U   = '{5'b01000, 5'b00100, 5'b10010, 5'b00001, 5'b10001};
-localparam logic[0:LFSR_N-1][0:LFSR_N-1]    LFSR_MATRIX_V   = '{5'b01100, 5'b00100, 5'b10010, 5'b00001, 5'b10000};
-localparam logic[0:LFSR_N-1][0:LFSR_N-1]    LFSR_MATRIX_W   = '{5'b01000, 5'b00100, 5'b10010, 5'b00001, 5'b10000};
-localparam logic[0:LFSR_N-1][0:LFSR_N-1]    LFSR_MATRIX_UR  = '{5'b00011, 5'b10000, 5'b01000, 5'b00111, 5'b00010};
-localparam logic[0:LFSR_N-1][0:LFSR_N-1]    LFSR_MATRIX_VR  = '{5'b00001, 5'b11000, 5'b01000, 5'b00101, 5'b00010};
-localparam logic[0:LFSR_N-1][0:LFSR_N-1]    LFSR_MATRIX_WR  = '{5'b00001, 5'b10000, 5'b01000, 5'b00101, 5'b00010};
-// Starting LFSR sequences
-localparam logic[LFSR_N-1:0]                LFSR_SEQ_RST_ENC            = 5'b10000;
-localparam logic[LFSR_N-1:0]                LFSR_SEQ_RST_DEC_32_64      = 5'b01011; // <-- UNVERIFIED
-localparam logic[LFSR_N-1:0]                LFSR_SEQ_RST_DEC_48_72      = 5'b10001; // <-- UNVERIFIED
-localparam logic[LFSR_N-1:0]                LFSR_SEQ_RST_DEC_48_96      = 5'b10000; // <-- UNVERIFIED
-localparam logic[LFSR_N-1:0]                LFSR_SEQ_RST_DEC_64_96      = 5'b00011;
-localparam logic[LFSR_N-1:0]                LFSR_SEQ_RST_DEC_64_128     = 5'b11101;
-localparam logic[LFSR_N-1:0]                LFSR_SEQ_RST_DEC_96_96      = 5'b11000; // <-- UNVERIFIED
-localparam logic[LFSR_N-1:0]                LFSR_SEQ_RST_DEC_96_144     = 5'b10011; // <-- UNVERIFIED
-localparam logic[LFSR_N-1:0]                LFSR_SEQ_RST_DEC_128_128    = 5'b10111;
-localparam logic[LFSR_N-1:0]                LFSR_SEQ_RST_DEC_128_192    = 5'b01101;
-localparam logic[LFSR_N-1:0]                LFSR_SEQ_RST_DEC_128_256    = 5'b10010;
-
-// Number of rounds (used for T sequence reset value)
-localparam logic T_SEQ_RST_ENC                              = 1'b0;
-// localparam logic T_SEQ_RST_DEC_32_64                        = 1'bx; // <-- no t sequence for 32/64
-// localparam logic T_SEQ_RST_DEC_48_72                        = 1'bx; // <-- no t sequence for 48/72
-// localparam logic T_SEQ_RST_DEC_48_96                        = 1'bx; // <-- no t sequence for 48/96
-localparam logic T_SEQ_RST_DEC_96_96                        = 1'b1; // <-- UNVERIFIED
-localparam logic T_SEQ_RST_DEC_96_144                       = 1'b0; // <-- UNVERIFIED
-localparam logic T_SEQ_RST_DEC_64_96                        = 1'b0;
-localparam logic T_SEQ_RST_DEC_64_128                       = 1'b1;
-localparam logic T_SEQ_RST_DEC_128_128                      = 1'b1;
-localparam logic T_SEQ_RST_DEC_128_192                      = 1'b1;
-localparam logic T_SEQ_RST_DEC_128_256                      = 1'b1;
+// U, V, R & their reverse (see simon_const_pkg)
+localparam logic[0:LFSR_N-1][0:LFSR_N-1]    LFSR_MATRIX_U   = SIMON_LFSR_U;
+localparam logic[0:LFSR_N-1][0:LFSR_N-1]    LFSR_MATRIX_V   = SIMON_LFSR_V;
+localparam logic[0:LFSR_N-1][0:LFSR_N-1]    LFSR_MATRIX_W   = SIMON_LFSR_W;
+localparam logic[0:LFSR_N-1][0:LFSR_N-1]    LFSR_MATRIX_UR  = SIMON_LFSR_UR;
+localparam logic[0:LFSR_N-1][0:LFSR_N-1]    LFSR_MATRIX_VR  = SIMON_LFSR_VR;
+localparam logic[0:LFSR_N-1][0:LFSR_N-1]    LFSR_MATRIX_WR  = SIMON_LFSR_WR;
+// Starting LFSR & t sequences: the decryption ones are computed by jumping the encryption LFSR T-1-m steps ahead,
+// so the reverse sequence is seeded directly, with no forward pre-run (see simon_const_pkg::simon_lfsr_seed_dec)
+localparam logic[LFSR_N-1:0]                LFSR_SEQ_RST_ENC    = SIMON_LFSR_SEED;
+localparam logic[LFSR_N-1:0]                LFSR_SEQ_RST_DEC    = simon_lfsr_seed_dec(WW, NKW);
+localparam logic                            T_SEQ_RST_ENC       = 1'b0;
+localparam logic                            T_SEQ_RST_DEC       = simon_t_seed_dec(WW, NKW);
 // ------------------------------------------------------------------------------------------------ //
 // Determine whether an LFSR for the corresponding vector (U, V, W) will be instantiated.
 // This depends on the z sequence that will be required for the specific config:
@@ -118,42 +97,23 @@ localparam logic                            GEN_LFSR_W  = Z_SEQ == 4;
 localparam logic[LFSR_C-1:0][0:LFSR_N-1][0:LFSR_N-1]    LFSR_MATRICES   = GEN_LFSR_U ? '{LFSR_MATRIX_UR, LFSR_MATRIX_U} :
                                                                           GEN_LFSR_V ? '{LFSR_MATRIX_VR, LFSR_MATRIX_V} :
                                                                                        '{LFSR_MATRIX_WR, LFSR_MATRIX_W};
-localparam logic[LFSR_C-1:0][LFSR_N-1:0]                LFSR_SEQ_RSTS   = (WW == 16) && (NKW == 2) ? {LFSR_SEQ_RST_DEC_32_64,   LFSR_SEQ_RST_ENC} :
-                                                                          (WW == 24) && (NKW == 3) ? {LFSR_SEQ_RST_DEC_48_72,   LFSR_SEQ_RST_ENC} :
-                                                                          (WW == 24) && (NKW == 4) ? {LFSR_SEQ_RST_DEC_48_96,   LFSR_SEQ_RST_ENC} :
-                                                                          (WW == 32) && (NKW == 3) ? {LFSR_SEQ_RST_DEC_64_96,   LFSR_SEQ_RST_ENC} :
-                                                                          (WW == 32) && (NKW == 4) ? {LFSR_SEQ_RST_DEC_64_128,  LFSR_SEQ_RST_ENC} :
-                                                                          (WW == 48) && (NKW == 2) ? {LFSR_SEQ_RST_DEC_96_96,   LFSR_SEQ_RST_ENC} :
-                                                                          (WW == 48) && (NKW == 3) ? {LFSR_SEQ_RST_DEC_96_144,  LFSR_SEQ_RST_ENC} :
-                                                                          (WW == 64) && (NKW == 2) ? {LFSR_SEQ_RST_DEC_128_128, LFSR_SEQ_RST_ENC} :
-                                                                          (WW == 64) && (NKW == 3) ? {LFSR_SEQ_RST_DEC_128_192, LFSR_SEQ_RST_ENC} :
-                                                                          (WW == 64) && (NKW == 4) ? {LFSR_SEQ_RST_DEC_128_256, LFSR_SEQ_RST_ENC} :
-                                                                                                     { {LFSR_N{1'b0}}, {LFSR_N{1'b0}}};
-localparam logic[1:0]                                   T_SEQ_RSTS      = (WW == 16) && (NKW == 2) ? 'x :
-                                                                          (WW == 24) && (NKW == 3) ? 'x :
-                                                                          (WW == 24) && (NKW == 4) ? 'x :
-                                                                          (WW == 32) && (NKW == 3) ? {T_SEQ_RST_DEC_64_96,   T_SEQ_RST_ENC} :
-                                                                          (WW == 32) && (NKW == 4) ? {T_SEQ_RST_DEC_64_128,  T_SEQ_RST_ENC} :
-                                                                          (WW == 48) && (NKW == 2) ? {T_SEQ_RST_DEC_96_96,   T_SEQ_RST_ENC} :
-                                                                          (WW == 48) && (NKW == 3) ? {T_SEQ_RST_DEC_96_144,  T_SEQ_RST_ENC} :
-                                                                          (WW == 64) && (NKW == 2) ? {T_SEQ_RST_DEC_128_128, T_SEQ_RST_ENC} :
-                                                                          (WW == 64) && (NKW == 3) ? {T_SEQ_RST_DEC_128_192, T_SEQ_RST_ENC} :
-                                                                          (WW == 64) && (NKW == 4) ? {T_SEQ_RST_DEC_128_256, T_SEQ_RST_ENC} :
-                                                                                                      0;
+localparam logic[LFSR_C-1:0][LFSR_N-1:0]                LFSR_SEQ_RSTS   = {LFSR_SEQ_RST_DEC, LFSR_SEQ_RST_ENC};
+localparam logic[1:0]                                   T_SEQ_RSTS      = {T_SEQ_RST_DEC,    T_SEQ_RST_ENC};
 
 // -- Signals ------------------------------------------------------------------------------------- //
-logic               lfsr_outp;
+logic[UNROLL-1:0]  lfsr_outp;
 logic[LFSR_C-1:0]   conf_sel;
 logic[LFSR_N-1:0]   seq_rst;
 
 // -- LFSR Instance ------------------------------------------------------------------------------- //
-assign conf_sel = 1 << mode_i;
-assign seq_rst  = LFSR_SEQ_RSTS[mode_i];
+assign conf_sel = LFSR_C'(1) << mode_i;
+assign seq_rst  = LFSR_SEQ_RSTS[rst_mode_i];
 lfsr_multi_config
 #(
     .N              (LFSR_N),
     .C              (LFSR_C),
-    .MATRICES       (LFSR_MATRICES)
+    .MATRICES       (LFSR_MATRICES),
+    .STEPS          (UNROLL)
 )
 i_lfsr_u
 (
@@ -176,26 +136,32 @@ if (Z_SEQ == 0 || Z_SEQ == 1) begin: g_if_z_eq_0_1
     assign seq_o = lfsr_outp;
 end else begin: g_if_z_gt_1
     // LFSR output is XOR'ed with the period-2 t sequence t = 010101...
-    logic t_seq_r;
+    // t_seq_r holds t for the first bit of the cycle, the following bits alternate
+    logic               t_seq_r;
+    logic[UNROLL-1:0]   t_seq;
     always_ff @(posedge clk, negedge arst_n) begin: ff_t_seq
         if (!arst_n) begin
             t_seq_r <= 1'b0;
         end else begin
             if (rst_seqs_i) begin
-                t_seq_r <= T_SEQ_RSTS[mode_i];
+                t_seq_r <= T_SEQ_RSTS[rst_mode_i];
             end else if (run_en_i) begin
-                t_seq_r <= ~t_seq_r;
+                t_seq_r <= t_seq_r ^ (UNROLL % 2 == 1);
             end
         end
     end
     
-    assign seq_o = lfsr_outp ^ t_seq_r;
+    for (genvar u=0; u<UNROLL; u++) begin: g_for_u
+        assign t_seq[u] = t_seq_r ^ (u % 2 == 1);
+    end
+    assign seq_o = lfsr_outp ^ t_seq;
 end
 
 // -- Design Parameter Assertions ----------------------------------------------------------------- //
 // synthesis translate_off
 initial begin
     #0 assert (WW inside {16, 24, 32, 48, 64}) else $error("Illegal WW parameter value %0d -- legal values: 16, 24, 32, 48, 64", WW);
+    #0 assert (UNROLL >= 1) else $error("Illegal UNROLL parameter value %0d -- must be at least 1", UNROLL);
     
     if (WW == 16)
         #0 assert (NKW == 4) else $error("Illegal NKW parameter value %0d -- legal values for WW = %0d: 4", NKW, WW);
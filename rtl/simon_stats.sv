@@ -0,0 +1,175 @@
+/**
+ * @info Statistics block of the Simon tops
+ *
+ * @author Anastasios Psarras (a.psarras4225@gmail.com)
+ *
+ * @license MIT license, check license.md
+ *
+ * @brief Performance counters, read through a register interface (rdata_o is register addr_i, see
+ *        simon_const_pkg::STATS_*), to observe the utilisation of an engine in the field:
+ *        -- blocks encrypted, decrypted (at the output handshake)
+ *        -- active cycles, cycles stalled on ready_i, cycles idle waiting for valid_i, decryption key prepare cycles
+ *        -- min, max & sum of the latencies from input handshake to output handshake (avg = sum / blocks)
+ *        The input handshake times of the blocks in flight (up to MAX_FLIGHT, in order) are kept in a FIFO, against
+ *        a free-running cycle counter. All counters saturate, and clr_i clears them (min back to its max value).
+ *
+ * @param CNT_W         Width of the counters (and of rdata_o)
+ * @param MAX_FLIGHT    Max number of blocks between the input and the output handshakes
+ */
+
+module simon_stats
+#(
+    parameter int   CNT_W       = 32,
+    parameter int   MAX_FLIGHT  = 3
+)
+(
+    input  logic                                clk,        // clock, @posedge
+    input  logic                                arst_n,     // async reset -- active low
+    input  logic                                clr_i,      // clears the counters
+    // Events
+    input  logic                                active_i,   // the engine is active
+    input  logic                                in_hs_i,    // input handshake
+    input  logic                                out_hs_i,   // output handshake
+    input  logic                                out_mode_i, // mode of the output (0: encryption, 1: decryption)
+    input  logic                                stall_i,    // a result is held back by the output
+    input  logic                                idle_i,     // nothing to do, waiting for the input
+    input  logic                                key_run_i,  // decryption key prepare
+    // Register Interface
+    input  logic[simon_const_pkg::STATS_AW-1:0] addr_i,     // register address
+    output logic[CNT_W-1:0]                     rdata_o     // register addr_i
+);
+
+// -- Constants ----------------------------------------------------------------------------------- //
+import simon_const_pkg::*;
+localparam logic[CNT_W-1:0] CNT_MAX = '1;
+
+// -- Handy Functions ----------------------------------------------------------------------------- //
+function automatic logic[CNT_W-1:0] sat_add(input logic[CNT_W-1:0] a, input logic[CNT_W-1:0] b);
+    logic[CNT_W:0] sum;
+    sum = a + b;
+    return sum[CNT_W] ? CNT_MAX : sum[CNT_W-1:0];
+endfunction
+
+// -- Signal Definitions -------------------------------------------------------------------------- //
+logic[CNT_W-1:0]    now_r;          // free-running cycle counter
+logic[CNT_W-1:0]    n_enc_r;
+logic[CNT_W-1:0]    n_dec_r;
+logic[CNT_W-1:0]    n_active_r;
+logic[CNT_W-1:0]    n_stall_r;
+logic[CNT_W-1:0]    n_idle_r;
+logic[CNT_W-1:0]    n_key_run_r;
+logic[CNT_W-1:0]    lat_min_r;
+logic[CNT_W-1:0]    lat_max_r;
+logic[CNT_W-1:0]    lat_sum_r;
+logic[CNT_W-1:0]    in_time;        // input handshake time of the block at the output
+logic[CNT_W-1:0]    lat;
+
+// -- Input Handshake Times ----------------------------------------------------------------------- //
+sync_fifo
+#(
+    .WIDTH      (CNT_W),
+    .DEPTH      (MAX_FLIGHT),
+    .DATA_RST   (1'b0)
+)
+i_time_fifo
+(
+    .clk        (clk),
+    .arst_n     (arst_n),
+    .clr_i      (1'b0),
+
+    .valid_i    (in_hs_i),
+    .ready_o    (),
+    .data_i     (now_r),
+
+    .valid_o    (),
+    .ready_i    (out_hs_i),
+    .data_o     (in_time),
+
+    .count_o    ()
+);
+
+assign lat = now_r - in_time;
+
+// -- Counters ------------------------------------------------------------------------------------ //
+always_ff @(posedge clk, negedge arst_n) begin: ff_now
+    if (!arst_n) begin
+        now_r <= '0;
+    end else begin
+        now_r <= now_r + 1;
+    end
+end
+
+always_ff @(posedge clk, negedge arst_n) begin: ff_counters
+    if (!arst_n) begin
+        n_enc_r     <= '0;
+        n_dec_r     <= '0;
+        n_active_r  <= '0;
+        n_stall_r   <= '0;
+        n_idle_r    <= '0;
+        n_key_run_r <= '0;
+        lat_min_r   <= CNT_MAX;
+        lat_max_r   <= '0;
+        lat_sum_r   <= '0;
+    end else begin
+        if (clr_i) begin
+            n_enc_r     <= '0;
+            n_dec_r     <= '0;
+            n_active_r  <= '0;
+            n_stall_r   <= '0;
+            n_idle_r    <= '0;
+            n_key_run_r <= '0;
+            lat_min_r   <= CNT_MAX;
+            lat_max_r   <= '0;
+            lat_sum_r   <= '0;
+        end else begin
+            n_enc_r     <= sat_add(n_enc_r,     CNT_W'(out_hs_i && (out_mode_i == MODE_ENC)));
+            n_dec_r     <= sat_add(n_dec_r,     CNT_W'(out_hs_i && (out_mode_i == MODE_DEC)));
+            n_active_r  <= sat_add(n_active_r,  CNT_W'(active_i));
+            n_stall_r   <= sat_add(n_stall_r,   CNT_W'(stall_i));
+            n_idle_r    <= sat_add(n_idle_r,    CNT_W'(idle_i));
+            n_key_run_r <= sat_add(n_key_run_r, CNT_W'(key_run_i));
+            if (out_hs_i) begin
+                if (lat < lat_min_r) begin
+                    lat_min_r   <= lat;
+                end
+                if (lat > lat_max_r) begin
+                    lat_max_r   <= lat;
+                end
+                lat_sum_r   <= sat_add(lat_sum_r, lat);
+            end
+        end
+    end
+end
+
+// -- Register Interface -------------------------------------------------------------------------- //
+always_comb begin: comb_rdata
+    case (addr_i)
+        STATS_N_ENC:    rdata_o = n_enc_r;
+        STATS_N_DEC:    rdata_o = n_dec_r;
+        STATS_ACTIVE:   rdata_o = n_active_r;
+        STATS_STALL:    rdata_o = n_stall_r;
+        STATS_IDLE:     rdata_o = n_idle_r;
+        STATS_KEY_RUN:  rdata_o = n_key_run_r;
+        STATS_LAT_MIN:  rdata_o = lat_min_r;
+        STATS_LAT_MAX:  rdata_o = lat_max_r;
+        STATS_LAT_SUM:  rdata_o = lat_sum_r;
+        default:        rdata_o = '0;
+    endcase
+end
+
+// -- Assertion Properties ------------------------------------------------------------------------ //
+// synthesis translate_off
+assert property (@(posedge clk) disable iff(!arst_n)
+    out_hs_i |-> i_time_fifo.valid_o) else $error("output handshake without a block in flight");
+assert property (@(posedge clk) disable iff(!arst_n)
+    in_hs_i |-> i_time_fifo.ready_o) else $error("more than MAX_FLIGHT=%0d blocks in flight", MAX_FLIGHT);
+// synthesis translate_on
+
+// -- Design Parameter Assertions ----------------------------------------------------------------- //
+// synthesis translate_off
+initial begin
+    #0 assert (CNT_W >= 8) else $error("Illegal CNT_W parameter value %0d -- must be >= 8", CNT_W);
+    #0 assert (MAX_FLIGHT >= 1) else $error("Illegal MAX_FLIGHT parameter value %0d -- must be >= 1", MAX_FLIGHT);
+end
+// synthesis translate_on
+endmodule
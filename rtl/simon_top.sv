@@ -34,13 +34,69 @@
  * @param NKW       Defines the number of key words (m in [ref]).
  * @param DATA_RST  Sets whether the plaintext & key registers are resettable to zero (for testability?)
  *                  Note that resettable data FFs will result to a higher area footprint
+ * @param UNROLL    Number of rounds performed per cycle: a block takes ceil(T/UNROLL) cycles instead of T, at the
+ *                  cost of UNROLL round & key schedule stages in series. If UNROLL does not divide T (e.g. the 69
+ *                  rounds of Simon 128/192), the last cycle runs the remaining rounds only (see simon_core)
+ * @param DEC_KEY_CACHE_DEPTH   Number of decryption key sets kept, tagged with the input key they were derived from
+ *                  (0 disables the cache). A decryption whose key_i hits skips the ceil(T/UNROLL) cycles key prepare
+ *                  and takes as long as an encryption. Entries are replaced round-robin.
+ * @param RK_RAM    Round key RAM mode: the core stores the T round keys of the last prepared key (tagged with it).
+ *                  Blocks with that key, encryptions and decryptions, then run from the stored keys with the key
+ *                  schedule & LFSR idle, and decryptions have no pre-run. Supersedes the decryption key cache.
+ * @param KEY_PERSIST   Session key mode: key_i is loaded through the key_valid_i/key_ready_o side channel and held,
+ *                  and every following block (valid_i/ready_o, pt_i only) uses it. The held copy is also what the
+ *                  core reloads for each block. A key is accepted once no block is staged, so it applies to all the
+ *                  blocks accepted after it (including one accepted in the same cycle).
+ * @param STATS     Adds a statistics block (simon_stats) read through stats_addr_i/stats_rdata_o: blocks encrypted &
+ *                  decrypted, active cycles, cycles stalled on ready_i or idle waiting for valid_i, decryption key
+ *                  prepare cycles and min/max/sum of the latencies from input to output handshake. Without it,
+ *                  stats_rdata_o is tied to zero.
+ * @param IN_FIFO_DEPTH     Depth of an input FIFO (sync_fifo) in front of the staging register (0: none). It accepts a
+ *                  burst of up to IN_FIFO_DEPTH blocks back-to-back, one per cycle, whatever the core is doing. With
+ *                  KEY_PERSIST, the session key is accepted once the FIFO is empty as well (it only holds pt_i & mode_i).
+ * @param OUT_FIFO_DEPTH    Depth of an output FIFO (sync_fifo) after the holding register (0: none). It keeps up to
+ *                  OUT_FIFO_DEPTH results while ready_i is low, so that the core keeps running, and hands them out
+ *                  in a burst, one per cycle. Each FIFO adds a cycle of latency.
+ * @param CLK_GATE  Low power: clock gates (clk_gate) on the core's register groups (text, key, LFSR, round key RAM, see
+ *                  simon_core) and on the decryption key cache, enabled only in the cycles they are written
+ * @param OP_ISO    Low power: operand isolation of the core's round functions outside of the encryption/decryption
+ *                  runs (see simon_core)
+ * @param MASKED    First-order masking of the core against power analysis (see simon_core & simon_round_masked): the
+ *                  text and key (and the decryption key cache) are held as 2 Boolean shares, masked when loaded into the
+ *                  core with the fresh random bits of rnd_i, and the round function is a DOM AND. Each round takes 2
+ *                  cycles: an encryption takes exactly 2T cycles per block, a decryption key prepare is unchanged (T+1).
+ *                  The interface registers (input FIFO, staging register, key cache tags) still hold pt_i/key_i in the
+ *                  clear, as they come in. Requires UNROLL = 1 and RK_RAM = 0.
+ * @param SPECK     Adds Speck 2n/mn, for the same n/m, on the same engine: alg_i selects the cipher of each block
+ *                  (simon_const_pkg::ALG_SIMON/ALG_SPECK, returned on alg_o with its result), and the core switches its
+ *                  round & key schedule stage (see simon_core). The interfaces, staging & holding registers, FIFOs, FSM,
+ *                  key registers and decryption key cache (tagged with the cipher as well) are shared. A Speck block
+ *                  takes the T of Speck (22 to 34 rounds) instead. Requires UNROLL = 1, RK_RAM = 0 and MASKED = 0.
+ *                  Without it, alg_i is ignored and alg_o is ALG_SIMON.
+ *
+ *        An input staging register accepts the next block while the current one is running, and an output holding
+ *        register keeps the result until it is read: the FSM loads the next block in the very cycle it produces the
+ *        current result, so a stream of encryptions is processed at exactly ceil(T/UNROLL) cycles per block (at least 2 --
+ *        the staging register can only be refilled the cycle after it is emptied), or 2T with MASKED (Speck's T for the
+ *        Speck blocks, with SPECK).
  */
 
 module simon_top
 #(
     parameter int   WW          = 16,
     parameter int   NKW         = 4,
-    parameter logic DATA_RST    = 1'b0
+    parameter logic DATA_RST    = 1'b0,
+    parameter int   UNROLL      = 1,
+    parameter int   DEC_KEY_CACHE_DEPTH = 1,
+    parameter logic KEY_PERSIST = 1'b0,
+    parameter logic RK_RAM      = 1'b0,
+    parameter logic STATS       = 1'b0,
+    parameter int   IN_FIFO_DEPTH   = 0,
+    parameter int   OUT_FIFO_DEPTH  = 0,
+    parameter logic CLK_GATE    = 1'b0,
+    parameter logic OP_ISO      = 1'b0,
+    parameter logic MASKED      = 1'b0,
+    parameter logic SPECK       = 1'b0
 )
 (
     input  logic                    clk,        // clock, @posedge
@@ -48,21 +104,47 @@ module simon_top
     // Activity
     output logic                    active_o,   // indicates when there's activity in the block (for architectural clock gating perhaps?)
     // Input Interface
-    input  logic                    valid_i,    // when asserted, it indicates that input is valid and the block must start processing pt_i/key_i
-    output logic                    ready_o,    // when asserted and valid_i is also asserted, the input has been processed
+    input  logic                    valid_i,    // when asserted, it indicates that input is valid and the block must start processing pt_i/key_i (pt_i only with KEY_PERSIST)
+    output logic                    ready_o,    // when asserted and valid_i is also asserted, the input has been accepted (input staging register is empty)
     input  logic                    mode_i,     // 0: encrypt / 1: decrypt (only matters when valid_i is asserted)
+    input  logic                    alg_i,      // SPECK: 0: Simon / 1: Speck (only matters when valid_i is asserted)
     input  logic[2-1:0][WW-1:0]     pt_i,       // input plaintext
-    input  logic[NKW-1:0][WW-1:0]   key_i,      // input key
+    input  logic[NKW-1:0][WW-1:0]   key_i,      // input key (with KEY_PERSIST, only matters when key_valid_i is asserted)
+    // Session Key Interface (KEY_PERSIST only)
+    // verilator lint_off UNUSEDSIGNAL
+    input  logic                    key_valid_i,// when asserted, key_i is a new session key
+    // verilator lint_on UNUSEDSIGNAL
+    output logic                    key_ready_o,// when asserted and key_valid_i is also asserted, key_i has been loaded (tied low without KEY_PERSIST)
     // Output Interface
     output logic                    valid_o,    // when asserted, a plaintext/ciphertext-key pair has been processed and ct_o contains valid data
     input  logic                    ready_i,    // when asserted and valid_o is also asserted, output ct_o is considered as read
     output logic                    mode_o,     // 0: encrypt / 1: decrypt (only matters when valid_o is asserted)
-    output logic[2-1:0][WW-1:0]     ct_o        // output ciphertext (on encryption mode), or plaintext (on decryption mode)
+    output logic                    alg_o,      // 0: Simon / 1: Speck (only matters when valid_o is asserted)
+    output logic[2-1:0][WW-1:0]     ct_o,       // output ciphertext (on encryption mode), or plaintext (on decryption mode)
+    // Randomness (MASKED only)
+    // verilator lint_off UNUSEDSIGNAL
+    input  logic[(3+NKW)*WW-1:0]    rnd_i,      // fresh uniform random bits, every cycle: {key mask, text mask, round function}
+    // verilator lint_on UNUSEDSIGNAL
+    // Statistics Interface (STATS only)
+    // verilator lint_off UNUSEDSIGNAL
+    input  logic                    stats_clr_i,    // clears the statistics counters
+    input  logic[simon_const_pkg::STATS_AW-1:0] stats_addr_i,   // statistics register address (see simon_const_pkg::STATS_*)
+    // verilator lint_on UNUSEDSIGNAL
+    output logic[simon_const_pkg::STATS_DW-1:0] stats_rdata_o   // statistics register stats_addr_i
 );
 
+// -- Constants ----------------------------------------------------------------------------------- //
+localparam int N_ROUNDS = simon_const_pkg::simon_n_rounds(WW, NKW);
+localparam int N_ROUNDS_SPECK = simon_const_pkg::speck_n_rounds(WW, NKW);
+localparam int RND_W    = simon_const_pkg::simon_rounds_w(WW, NKW);
+// decryption key cache entries (a single, untagged, entry without cache) & entry index width
+localparam int KC_N     = DEC_KEY_CACHE_DEPTH > 0 ? DEC_KEY_CACHE_DEPTH : 1;
+localparam int KC_W     = KC_N > 1 ? $clog2(KC_N) : 1;
+
 // -- Signal Definitions -------------------------------------------------------------------------- //
 // FSM to Core signals
 logic                   fsm2core_srst;
+logic                   fsm2core_srst_mode;
 logic                   fsm2core_mode;
 logic                   fsm2core_pt_ld_en;
 logic                   fsm2core_pt_run_en;
@@ -70,69 +152,522 @@ logic                   fsm2core_key_ld_en;
 logic                   fsm2core_key_run_en;
 logic[NKW-1:0]          fsm_key_reg_ld_en;
 logic                   fsm_key_reg_sel;
-logic[WW-1:0]           core_key;
-logic[NKW-1:0][WW-1:0]  dec_keys_r;
+logic[UNROLL-1:0][WW-1:0] core_key;
+logic[KC_N-1:0][NKW-1:0][WW-1:0] dec_keys_r;
+// Decryption key cache
+// verilator lint_off UNUSEDSIGNAL
+logic[KC_N-1:0][NKW-1:0][WW-1:0] kc_tag_r;     // input key each entry of dec_keys_r was derived from
+logic[KC_N-1:0]         kc_valid_r;
+// verilator lint_on UNUSEDSIGNAL
+logic[KC_W-1:0]         kc_fill_ptr_r;          // entry written by the next key prepare
+logic                   kc_hit;
+logic[KC_W-1:0]         kc_hit_idx;
+logic[KC_W-1:0]         kc_ld_idx;              // entry loaded into the core
+logic                   fsm_key_cache_fill;
+// Round key RAM (RK_RAM)
+logic[simon_const_pkg::simon_cnt_w(WW, NKW, UNROLL)-1:0] fsm2core_rk_cnt;
+logic                   fsm2core_rk_wr_en;
+logic                   fsm2core_rk_rd_en;
+logic                   fsm2core_last;
+logic                   fsm2core_rnd_en;
+logic                   clk_kc;         // clock of the decryption key cache (gated with CLK_GATE)
+logic                   fsm_rk_tag_ld;
+logic                   fsm_rk_valid_set;
+logic                   rk_hit;
 logic[NKW-1:0][WW-1:0]  core_keys_to_load;
+logic[2-1:0][WW-1:0]    core_ct_nxt;
+// Masking (MASKED)
+// verilator lint_off UNUSEDSIGNAL
+logic[UNROLL-1:0][WW-1:0] core_key_m;           // core round keys share 1
+// verilator lint_on UNUSEDSIGNAL
+logic[WW-1:0]           rnd_round;              // fresh random bits of the round functions
+logic[2-1:0][WW-1:0]    pt_mask;                // fresh mask of the text loaded into the core
+logic[NKW-1:0][WW-1:0]  key_mask;               // fresh mask of the key loaded into the core
+logic[2-1:0][WW-1:0]    core_pt;                // text loaded into the core (share 0 with MASKED)
+logic[2-1:0][WW-1:0]    core_pt_m;              // share 1
+logic[NKW-1:0][WW-1:0]  core_key_ld;            // key loaded into the core (share 0 with MASKED)
+logic[NKW-1:0][WW-1:0]  core_key_ld_m;          // share 1
+// Cipher selection (SPECK)
+logic                   blk_alg;
+logic                   in_alg_r;               // cipher of the staged block
+logic                   run_alg_r;              // cipher of the block running in the core
+logic                   out_alg_r;              // cipher of the held result
+// verilator lint_off UNUSEDSIGNAL
+logic[KC_N-1:0]         kc_alg_r;               // cipher each entry of dec_keys_r was prepared for
+logic[NKW-1:0][WW-1:0]  core_key_regs;          // core key registers (a Speck decryption's keys)
+// verilator lint_on UNUSEDSIGNAL
+logic[NKW-1:0]          kc_key_ld_en;           // dec_keys_r word load enables & data
+logic[NKW-1:0][WW-1:0]  kc_key_in;
+// Input FIFO (the block offered to the staging register)
+logic                   blk_valid;
+logic                   blk_mode;
+logic[2-1:0][WW-1:0]    blk_pt;
+logic[NKW-1:0][WW-1:0]  blk_key;
+logic                   in_fifo_busy;   // blocks are queued in the input FIFO
+// Input staging register
+logic                   in_valid_r;
+logic                   in_mode_r;
+logic[2-1:0][WW-1:0]    in_pt_r;
+logic[NKW-1:0][WW-1:0]  in_key_r;       // key of the staged block (the session key with KEY_PERSIST)
+logic                   in_key_ld_en;
+logic                   in_ld_en;
+logic                   in_pop;         // from the FSM: the staged input has been loaded into the core
+// Output holding register
+logic                   out_valid_r;
+logic                   out_mode_r;
+logic[2-1:0][WW-1:0]    out_ct_r;
+logic                   out_ld_en;
+logic                   hold_ready;     // the holding register is read (ready_i, or the output FIFO not full)
+logic                   fsm_out_valid;  // from the FSM: a result is on core_ct_nxt
+logic                   fsm_out_ready;  // to the FSM: the holding register is (or is about to be) empty
+logic                   fsm_out_mode;
+logic                   fsm_active;
+// verilator lint_off UNUSEDSIGNAL
+logic                   fsm_key_prep;
+// verilator lint_on UNUSEDSIGNAL
+
+// -- Input FIFO ---------------------------------------------------------------------------------- //
+// the key is queued with its block, except with KEY_PERSIST (the session key goes straight to in_key_r), and the
+// cipher bit only with SPECK (the top bit of a block, dropped & zero-extended by the casts otherwise)
+if (IN_FIFO_DEPTH > 0) begin: g_if_in_fifo
+    localparam int IN_BLK_W  = 2 + 2*WW + (KEY_PERSIST ? 0 : NKW*WW);
+    localparam int IN_FIFO_W = IN_BLK_W - (SPECK ? 0 : 1);
+    logic[IN_FIFO_W-1:0] in_fifo_wdata;
+    logic[IN_FIFO_W-1:0] in_fifo_rdata;
+    
+    if (KEY_PERSIST) begin: g_if_key_persist
+        assign in_fifo_wdata                = IN_FIFO_W'({alg_i, mode_i, pt_i});
+        assign {blk_alg, blk_mode, blk_pt}  = IN_BLK_W'(in_fifo_rdata);
+        assign blk_key                      = key_i;
+    end else begin: g_if_not_key_persist
+        assign in_fifo_wdata                        = IN_FIFO_W'({alg_i, mode_i, pt_i, key_i});
+        assign {blk_alg, blk_mode, blk_pt, blk_key} = IN_BLK_W'(in_fifo_rdata);
+    end
+    
+    sync_fifo
+    #(
+        .WIDTH      (IN_FIFO_W),
+        .DEPTH      (IN_FIFO_DEPTH),
+        .DATA_RST   (DATA_RST)
+    )
+    i_in_fifo
+    (
+        .clk        (clk),
+        .arst_n     (arst_n),
+        .clr_i      (1'b0),
+        
+        .valid_i    (valid_i),
+        .ready_o    (ready_o),
+        .data_i     (in_fifo_wdata),
+        
+        .valid_o    (blk_valid),
+        .ready_i    (~in_valid_r),
+        .data_o     (in_fifo_rdata),
+        
+        .count_o    ()
+    );
+    
+    assign in_fifo_busy = blk_valid;
+end else begin: g_if_no_in_fifo
+    assign blk_valid    = valid_i;
+    assign ready_o      = ~in_valid_r;
+    assign blk_alg      = SPECK & alg_i;
+    assign blk_mode     = mode_i;
+    assign blk_pt       = pt_i;
+    assign blk_key      = key_i;
+    assign in_fifo_busy = 1'b0;
+end
+
+// -- Input Staging Register ---------------------------------------------------------------------- //
+assign in_ld_en = blk_valid & ~in_valid_r;
+
+// the key is staged with its block -- or, with KEY_PERSIST, on its own and held for the next blocks
+if (KEY_PERSIST) begin: g_if_key_persist
+    assign key_ready_o  = ~in_valid_r & ~in_fifo_busy;
+    assign in_key_ld_en = key_valid_i & key_ready_o;
+end else begin: g_if_not_key_persist
+    assign key_ready_o  = 1'b0;
+    assign in_key_ld_en = in_ld_en;
+end
+
+always_ff @(posedge clk, negedge arst_n) begin: ff_in_valid
+    if (!arst_n) begin
+        in_valid_r <= 1'b0;
+    end else begin
+        if (in_ld_en) begin
+            in_valid_r <= 1'b1;
+        end else if (in_pop) begin
+            in_valid_r <= 1'b0;
+        end
+    end
+end
+
+// -- Output Holding Register --------------------------------------------------------------------- //
+assign fsm_out_ready    = ~out_valid_r | hold_ready;
+assign out_ld_en        = fsm_out_valid & fsm_out_ready;
+
+always_ff @(posedge clk, negedge arst_n) begin: ff_out_valid
+    if (!arst_n) begin
+        out_valid_r <= 1'b0;
+    end else begin
+        if (out_ld_en) begin
+            out_valid_r <= 1'b1;
+        end else if (hold_ready) begin
+            out_valid_r <= 1'b0;
+        end
+    end
+end
+
+// -- Output FIFO --------------------------------------------------------------------------------- //
+if (OUT_FIFO_DEPTH > 0) begin: g_if_out_fifo
+    localparam int OUT_BLK_W  = 2 + 2*WW;
+    localparam int OUT_FIFO_W = OUT_BLK_W - (SPECK ? 0 : 1);
+    logic[OUT_FIFO_W-1:0] out_fifo_rdata;
+    
+    sync_fifo
+    #(
+        .WIDTH      (OUT_FIFO_W),
+        .DEPTH      (OUT_FIFO_DEPTH),
+        .DATA_RST   (DATA_RST)
+    )
+    i_out_fifo
+    (
+        .clk        (clk),
+        .arst_n     (arst_n),
+        .clr_i      (1'b0),
+        
+        .valid_i    (out_valid_r),
+        .ready_o    (hold_ready),
+        .data_i     (OUT_FIFO_W'({out_alg_r, out_mode_r, out_ct_r})),
+        
+        .valid_o    (valid_o),
+        .ready_i    (ready_i),
+        .data_o     (out_fifo_rdata),
+        
+        .count_o    ()
+    );
+    
+    assign {alg_o, mode_o, ct_o} = OUT_BLK_W'(out_fifo_rdata);
+end else begin: g_if_no_out_fifo
+    assign hold_ready   = ready_i;
+    assign valid_o      = out_valid_r;
+    assign mode_o       = out_mode_r;
+    assign alg_o        = out_alg_r;
+    assign ct_o         = out_ct_r;
+end
+
+assign active_o = fsm_active | out_valid_r | valid_i | blk_valid | valid_o;
 
 // -- Control FSM --------------------------------------------------------------------------------- //
 simon_ctrl_fsm
 #(
     .WW                 (WW),
-    .NKW                (NKW)
+    .NKW                (NKW),
+    .UNROLL             (UNROLL),
+    .RK_RAM             (RK_RAM),
+    .MASKED             (MASKED)
 )
 i_ctrl_fsm
 (
     .clk                (clk),
     .arst_n             (arst_n),
     
-    .active_o           (active_o),
+    .active_o           (fsm_active),
+    .key_prep_o         (fsm_key_prep),
     
-    .valid_i            (valid_i),
-    .ready_o            (ready_o),
-    .mode_i             (mode_i),
+    .valid_i            (in_valid_r),
+    .ready_o            (in_pop),
+    .mode_i             (in_mode_r),
+    .n_rounds_i         (RND_W'(run_alg_r == simon_const_pkg::ALG_SPECK ? N_ROUNDS_SPECK : N_ROUNDS)),
     
     .core_srst_o        (fsm2core_srst),
+    .core_srst_mode_o   (fsm2core_srst_mode),
     .core_mode_o        (fsm2core_mode),
     .core_pt_ld_en_o    (fsm2core_pt_ld_en),
     .core_pt_run_en_o   (fsm2core_pt_run_en),
     .core_key_ld_en_o   (fsm2core_key_ld_en),
     .core_key_run_en_o  (fsm2core_key_run_en),
+    .core_rk_cnt_o      (fsm2core_rk_cnt),
+    .core_last_o        (fsm2core_last),
+    .core_rnd_en_o      (fsm2core_rnd_en),
+    
+    .rk_hit_i           (rk_hit),
+    .rk_wr_en_o         (fsm2core_rk_wr_en),
+    .rk_rd_en_o         (fsm2core_rk_rd_en),
+    .rk_tag_ld_o        (fsm_rk_tag_ld),
+    .rk_valid_set_o     (fsm_rk_valid_set),
     
     .key_reg_ld_en_o    (fsm_key_reg_ld_en),
     .key_reg_sel_o      (fsm_key_reg_sel),
+    .key_hit_i          (kc_hit),
+    .key_fill_o         (fsm_key_cache_fill),
     
-    .valid_o            (valid_o),
-    .ready_i            (ready_i),
-    .mode_o             (mode_o)
+    .valid_o            (fsm_out_valid),
+    .ready_i            (fsm_out_ready),
+    .mode_o             (fsm_out_mode)
 );
 
+// A Simon key prepare stores the last NKW round keys, one per cycle (key reg i at round T-1-i), a Speck one all the key
+// words of its last cycle (the step T-1 state the decryption runs back from, see speck_key_schedule)
+for (genvar i=0; i<NKW; i++) begin: g_for_kc_key
+    if (SPECK) begin: g_if_speck
+        assign kc_key_ld_en[i]  = run_alg_r == simon_const_pkg::ALG_SPECK ? fsm_key_reg_ld_en[0] : fsm_key_reg_ld_en[i];
+        assign kc_key_in[i]     = run_alg_r == simon_const_pkg::ALG_SPECK ? core_key_regs[i] : core_key[(N_ROUNDS-1-i) % UNROLL];
+    end else begin: g_if_no_speck
+        assign kc_key_ld_en[i]  = fsm_key_reg_ld_en[i];
+        assign kc_key_in[i]     = core_key[(N_ROUNDS-1-i) % UNROLL];
+    end
+end
+
+// the decryption key cache is only written by key prepares (key regs) and fills (tags)
+if (CLK_GATE) begin: g_if_clk_gate
+    clk_gate i_cg_kc (.clk(clk), .en_i((|fsm_key_reg_ld_en) | fsm_key_cache_fill), .test_en_i(1'b0), .gclk_o(clk_kc));
+end else begin: g_if_no_clk_gate
+    assign clk_kc = clk;
+end
+
 if (DATA_RST) begin: g_if_data_rst
-    always_ff @(posedge clk, negedge arst_n) begin: ff_key_regs
+    always_ff @(posedge clk_kc, negedge arst_n) begin: ff_key_regs
         if (!arst_n) begin
-            dec_keys_r <= '0;
+            dec_keys_r  <= '0;
+            kc_tag_r    <= '0;
         end else begin
             for (int i=0; i<NKW; i++) begin
-                if (fsm_key_reg_ld_en[i]) begin
-                    dec_keys_r[i] <= core_key;
+                if (kc_key_ld_en[i]) begin
+                    dec_keys_r[kc_fill_ptr_r][i] <= kc_key_in[i];
                 end
             end
+            if (fsm_key_cache_fill) begin
+                kc_tag_r[kc_fill_ptr_r] <= in_key_r;
+            end
+        end
+    end
+    
+    always_ff @(posedge clk, negedge arst_n) begin: ff_in_regs
+        if (!arst_n) begin
+            in_mode_r   <= 1'b0;
+            in_pt_r     <= '0;
+            in_key_r    <= '0;
+        end else begin
+            if (in_ld_en) begin
+                in_mode_r   <= blk_mode;
+                in_pt_r     <= blk_pt;
+            end
+            if (in_key_ld_en) begin
+                in_key_r    <= blk_key;
+            end
+        end
+    end
+    
+    always_ff @(posedge clk, negedge arst_n) begin: ff_out_regs
+        if (!arst_n) begin
+            out_mode_r  <= 1'b0;
+            out_ct_r    <= '0;
+        end else begin
+            if (out_ld_en) begin
+                out_mode_r  <= fsm_out_mode;
+                out_ct_r    <= core_ct_nxt;
+            end
         end
     end
 end else begin: g_if_not_data_rst
-    always_ff @(posedge clk, negedge arst_n) begin: ff_key_regs
+    always_ff @(posedge clk_kc) begin: ff_key_regs
         for (int i=0; i<NKW; i++) begin
-            if (fsm_key_reg_ld_en[i]) begin
-                dec_keys_r[i] <= core_key;
+            if (kc_key_ld_en[i]) begin
+                dec_keys_r[kc_fill_ptr_r][i] <= kc_key_in[i];
+            end
+        end
+        if (fsm_key_cache_fill) begin
+            kc_tag_r[kc_fill_ptr_r] <= in_key_r;
+        end
+    end
+    
+    // the mode bits are control, so they are always resettable
+    always_ff @(posedge clk, negedge arst_n) begin: ff_in_regs
+        if (!arst_n) begin
+            in_mode_r   <= 1'b0;
+        end else begin
+            if (in_ld_en) begin
+                in_mode_r   <= blk_mode;
             end
         end
     end
+    
+    always_ff @(posedge clk) begin: ff_in_data_regs
+        if (in_ld_en) begin
+            in_pt_r     <= blk_pt;
+        end
+        if (in_key_ld_en) begin
+            in_key_r    <= blk_key;
+        end
+    end
+    
+    always_ff @(posedge clk, negedge arst_n) begin: ff_out_regs
+        if (!arst_n) begin
+            out_mode_r  <= 1'b0;
+        end else begin
+            if (out_ld_en) begin
+                out_mode_r  <= fsm_out_mode;
+            end
+        end
+    end
+    
+    always_ff @(posedge clk) begin: ff_out_data_regs
+        if (out_ld_en) begin
+            out_ct_r    <= core_ct_nxt;
+        end
+    end
+end
+
+// -- Cipher Selection ---------------------------------------------------------------------------- //
+// The cipher of the running block follows the staged one each time the FSM (re)loads the core's keys, as soon as the
+// previous block's last round is over (see simon_cfg_top). Control bits, always resettable (ALG_SIMON without SPECK)
+always_ff @(posedge clk, negedge arst_n) begin: ff_alg_regs
+    if (!arst_n) begin
+        in_alg_r    <= simon_const_pkg::ALG_SIMON;
+        run_alg_r   <= simon_const_pkg::ALG_SIMON;
+        out_alg_r   <= simon_const_pkg::ALG_SIMON;
+    end else begin
+        if (in_ld_en) begin
+            in_alg_r    <= blk_alg;
+        end
+        if (fsm2core_key_ld_en) begin
+            run_alg_r   <= in_alg_r;
+        end
+        if (out_ld_en) begin
+            out_alg_r   <= run_alg_r;
+        end
+    end
+end
+
+// -- Decryption Key Cache ------------------------------------------------------------------------ //
+// An entry becomes valid once its key prepare is over (the FSM's fill pulse, when the staged key is still held).
+// Only the staged decryption is compared: its keys are either in the cache, or about to be written to entry
+// kc_fill_ptr_r, so tags are unique
+always_ff @(posedge clk, negedge arst_n) begin: ff_key_cache
+    if (!arst_n) begin
+        kc_valid_r      <= '0;
+        kc_alg_r        <= '0;
+        kc_fill_ptr_r   <= '0;
+    end else begin
+        if (fsm_key_cache_fill) begin
+            kc_valid_r[kc_fill_ptr_r]   <= 1'b1;
+            kc_alg_r[kc_fill_ptr_r]     <= in_alg_r;
+            kc_fill_ptr_r               <= (kc_fill_ptr_r == KC_W'(KC_N-1)) ? '0 : kc_fill_ptr_r + 1;
+        end
+    end
+end
+
+if ((DEC_KEY_CACHE_DEPTH > 0) && !RK_RAM) begin: g_if_key_cache
+    always_comb begin: comb_key_cache_hit
+        kc_hit      = 1'b0;
+        kc_hit_idx  = '0;
+        for (int e=0; e<KC_N; e++) begin
+            if (kc_valid_r[e] && (kc_tag_r[e] == in_key_r) && (kc_alg_r[e] == in_alg_r)) begin
+                kc_hit      = 1'b1;
+                kc_hit_idx  = KC_W'(e);
+            end
+        end
+    end
+end else begin: g_if_no_key_cache
+    assign kc_hit       = 1'b0;
+    assign kc_hit_idx   = '0;
+end
+
+// keys prepared just now (fill) or cached ones (hit)
+assign kc_ld_idx = fsm_key_cache_fill ? kc_fill_ptr_r : kc_hit_idx;
+
+// -- Round Key RAM Tag --------------------------------------------------------------------------- //
+// The tag is loaded when a key prepare starts (invalidating the stored keys) and becomes valid with its last write.
+// A block chained to that last write may already hit
+if (RK_RAM) begin: g_if_rk_ram
+    logic[NKW-1:0][WW-1:0]  rk_tag_r;
+    logic                   rk_valid_r;
+    
+    always_ff @(posedge clk, negedge arst_n) begin: ff_rk_valid
+        if (!arst_n) begin
+            rk_valid_r <= 1'b0;
+        end else begin
+            if (fsm_rk_tag_ld) begin
+                rk_valid_r <= 1'b0;
+            end else if (fsm_rk_valid_set) begin
+                rk_valid_r <= 1'b1;
+            end
+        end
+    end
+    
+    if (DATA_RST) begin: g_if_data_rst
+        always_ff @(posedge clk, negedge arst_n) begin: ff_rk_tag
+            if (!arst_n) begin
+                rk_tag_r <= '0;
+            end else begin
+                if (fsm_rk_tag_ld) begin
+                    rk_tag_r <= in_key_r;
+                end
+            end
+        end
+    end else begin: g_if_not_data_rst
+        always_ff @(posedge clk) begin: ff_rk_tag
+            if (fsm_rk_tag_ld) begin
+                rk_tag_r <= in_key_r;
+            end
+        end
+    end
+    
+    assign rk_hit = (rk_valid_r | fsm_rk_valid_set) & (rk_tag_r == in_key_r);
+end else begin: g_if_no_rk_ram
+    assign rk_hit = 1'b0;
+end
+
+// -- Masking ------------------------------------------------------------------------------------- //
+// The text & key are masked as they are loaded into the core: share 0 = value ^ mask, share 1 = mask. The decryption
+// key cache keeps both shares of the prepared keys, and refreshes them with a new mask when they are loaded
+if (MASKED) begin: g_if_masked
+    logic[KC_N-1:0][NKW-1:0][WW-1:0] dec_keys_m_r;  // share 1 of dec_keys_r
+    
+    assign {key_mask, pt_mask, rnd_round} = rnd_i;
+    
+    if (DATA_RST) begin: g_if_data_rst
+        always_ff @(posedge clk_kc, negedge arst_n) begin: ff_key_regs_m
+            if (!arst_n) begin
+                dec_keys_m_r <= '0;
+            end else begin
+                for (int i=0; i<NKW; i++) begin
+                    if (fsm_key_reg_ld_en[i]) begin
+                        dec_keys_m_r[kc_fill_ptr_r][i] <= core_key_m[(N_ROUNDS-1-i) % UNROLL];
+                    end
+                end
+            end
+        end
+    end else begin: g_if_not_data_rst
+        always_ff @(posedge clk_kc) begin: ff_key_regs_m
+            for (int i=0; i<NKW; i++) begin
+                if (fsm_key_reg_ld_en[i]) begin
+                    dec_keys_m_r[kc_fill_ptr_r][i] <= core_key_m[(N_ROUNDS-1-i) % UNROLL];
+                end
+            end
+        end
+    end
+    
+    assign core_pt      = in_pt_r ^ pt_mask;
+    assign core_pt_m    = pt_mask;
+    assign core_key_ld  = core_keys_to_load ^ key_mask;
+    for (genvar i=0; i<NKW; i++) begin: g_for_key_m
+        assign core_key_ld_m[i] = ({WW{fsm_key_reg_sel}} & dec_keys_m_r[kc_ld_idx][i]) ^ key_mask[i];
+    end
+end else begin: g_if_not_masked
+    assign {key_mask, pt_mask, rnd_round} = '0;
+    assign core_pt      = in_pt_r;
+    assign core_pt_m    = '0;
+    assign core_key_ld  = core_keys_to_load;
+    assign core_key_ld_m = '0;
 end
 
 // -- Simon Core ---------------------------------------------------------------------------------- //
-for (genvar i=0; i<NKW; i++) begin
-    for (genvar w=0; w<WW; w++) begin
-        assign core_keys_to_load[i][w] = (~fsm_key_reg_sel & key_i[i][w]) |
-                                         ( fsm_key_reg_sel & dec_keys_r[i][w]);
+for (genvar i=0; i<NKW; i++) begin: g_for_key_ld
+    for (genvar w=0; w<WW; w++) begin: g_for_bit
+        assign core_keys_to_load[i][w] = (~fsm_key_reg_sel & in_key_r[i][w]) |
+                                         ( fsm_key_reg_sel & dec_keys_r[kc_ld_idx][i][w]);
     end
 end
 
@@ -140,7 +675,13 @@ simon_core
 #(
     .WW                 (WW),
     .NKW                (NKW),
-    .DATA_RST           (DATA_RST)
+    .DATA_RST           (DATA_RST),
+    .UNROLL             (UNROLL),
+    .RK_RAM             (RK_RAM),
+    .CLK_GATE           (CLK_GATE),
+    .OP_ISO             (OP_ISO),
+    .MASKED             (MASKED),
+    .SPECK              (SPECK)
 )
 i_core
 (
@@ -148,31 +689,84 @@ i_core
     .arst_n             (arst_n),     // async reset -- active low
     
     .srst_i             (fsm2core_srst),     // sync reset -- active high
+    .srst_mode_i        (fsm2core_srst_mode),
     .mode_i             (fsm2core_mode),     // 0 for encrypt, 1 for decrypt
+    .alg_i              (run_alg_r),
     
     .pt_ld_en_i         (fsm2core_pt_ld_en),
     .pt_run_en_i        (fsm2core_pt_run_en),
-    .pt_i               (pt_i),       // plaintext parts
+    .pt_i               (core_pt),    // plaintext parts
+    .pt_m_i             (core_pt_m),
     
     .key_ld_en_i        (fsm2core_key_ld_en),
     .key_run_en_i       (fsm2core_key_run_en),
-    .key_i              (core_keys_to_load),      // key parts
+    .key_i              (core_key_ld),            // key parts
+    .key_m_i            (core_key_ld_m),
+    .rnd_i              (rnd_round),
     
-    .ct_o               (ct_o),         // output ciphertext
-    .key_o              (core_key)
+    .rk_wr_en_i         (fsm2core_rk_wr_en),
+    .rk_rd_en_i         (fsm2core_rk_rd_en),
+    .rk_cnt_i           (fsm2core_rk_cnt),
+    .last_i             (fsm2core_last),
+    .rnd_en_i           (fsm2core_rnd_en),
+    
+    .ct_o               (),
+    .ct_nxt_o           (core_ct_nxt),  // output ciphertext (captured by the output holding register)
+    .key_o              (core_key),
+    .key_m_o            (core_key_m),
+    .key_regs_o         (core_key_regs)
 );
 
+// -- Statistics ---------------------------------------------------------------------------------- //
+// stalled: a result waits in the holding register / idle: no block staged, running or held, and none coming
+if (STATS) begin: g_if_stats
+    simon_stats
+    #(
+        .CNT_W      (simon_const_pkg::STATS_DW),
+        .MAX_FLIGHT (3 + IN_FIFO_DEPTH + OUT_FIFO_DEPTH)
+    )
+    i_stats
+    (
+        .clk        (clk),
+        .arst_n     (arst_n),
+        .clr_i      (stats_clr_i),
+        
+        .active_i   (active_o),
+        .in_hs_i    (valid_i & ready_o),
+        .out_hs_i   (valid_o & ready_i),
+        .out_mode_i (mode_o),
+        .stall_i    (valid_o & ~ready_i),
+        .idle_i     (~active_o),
+        .key_run_i  (fsm_key_prep),
+        
+        .addr_i     (stats_addr_i),
+        .rdata_o    (stats_rdata_o)
+    );
+end else begin: g_if_no_stats
+    assign stats_rdata_o = '0;
+end
 
 // -- Assertion Properties ------------------------------------------------------------------------ //
 // synthesis translate_off
 // input interface
+if (KEY_PERSIST) begin: g_if_key_persist_assert
+    assert property (@(posedge clk) disable iff(!arst_n)
+        valid_i & ~ready_o |=> $stable({pt_i, mode_i})) else $error("mode_i and pt_i should remain stable when valid_i=1 and ready_o=0");
+    assert property (@(posedge clk) disable iff(!arst_n)
+        key_valid_i & ~key_ready_o |=> $stable(key_i)) else $error("key_i should remain stable when key_valid_i=1 and key_ready_o=0");
+    assert property (@(posedge clk) disable iff(!arst_n)
+        key_valid_i & ~key_ready_o |=> key_valid_i) else $error("key_valid_i should remain HIGH while key_ready_o=0");
+end else begin: g_if_not_key_persist_assert
+    assert property (@(posedge clk) disable iff(!arst_n)
+        valid_i & ~ready_o |=> $stable({key_i, pt_i, mode_i})) else $error("mode_i, pt_i and key_i should remain stable when valid_i=1 and ready_o=0");
+end
 assert property (@(posedge clk) disable iff(!arst_n)
-    valid_i & ~ready_o |=> $stable({key_i, pt_i, mode_i})) else $error("mode_i, pt_i and key_i should remain stable when valid_i=1 and ready_o=0");
+    valid_i & ~ready_o |=> $stable(SPECK & alg_i)) else $error("alg_i should remain stable when valid_i=1 and ready_o=0");
 assert property (@(posedge clk) disable iff(!arst_n)
     valid_i & ~ready_o |=> valid_i) else $error("valid_i should remain HIGH while ready_o=0");
 // output interface
 assert property (@(posedge clk) disable iff(!arst_n)
-    valid_o & ~ready_i |=> $stable({ct_o, mode_o})) else $error("mode_o and ct_o should remain stable when valid_o=1 and ready_i=0");
+    valid_o & ~ready_i |=> $stable({ct_o, mode_o, alg_o})) else $error("mode_o, alg_o and ct_o should remain stable when valid_o=1 and ready_i=0");
 assert property (@(posedge clk) disable iff(!arst_n)
     valid_o & ~ready_i |=> valid_o) else $error("valid_o should remain HIGH while ready_i=0");
 // synthesis translate_on
@@ -181,6 +775,11 @@ assert property (@(posedge clk) disable iff(!arst_n)
 // synthesis translate_off
 initial begin
     #0 assert (WW inside {16, 24, 32, 48, 64}) else $error("Illegal WW parameter value %0d -- legal values: 16, 24, 32, 48, 64", WW);
+    #0 assert (DEC_KEY_CACHE_DEPTH >= 0) else $error("Illegal DEC_KEY_CACHE_DEPTH parameter value %0d -- must be >= 0", DEC_KEY_CACHE_DEPTH);
+    #0 assert (IN_FIFO_DEPTH >= 0) else $error("Illegal IN_FIFO_DEPTH parameter value %0d -- must be >= 0", IN_FIFO_DEPTH);
+    #0 assert (OUT_FIFO_DEPTH >= 0) else $error("Illegal OUT_FIFO_DEPTH parameter value %0d -- must be >= 0", OUT_FIFO_DEPTH);
+    #0 assert (!MASKED || ((UNROLL == 1) && !RK_RAM)) else $error("MASKED requires UNROLL = 1 (got %0d) and RK_RAM = 0 (got %0d)", UNROLL, RK_RAM);
+    #0 assert (!SPECK || ((UNROLL == 1) && !RK_RAM && !MASKED)) else $error("SPECK requires UNROLL = 1 (got %0d), RK_RAM = 0 (got %0d) and MASKED = 0 (got %0d)", UNROLL, RK_RAM, MASKED);
     
     if (WW == 16)
         #0 assert (NKW == 4) else $error("Illegal NKW parameter value %0d -- legal values for WW = %0d: 4", NKW, WW);
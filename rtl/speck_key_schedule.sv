@@ -0,0 +1,80 @@
+/**
+ * @info NSA's Speck key schedule algorithm (combinational logic)
+ *
+ * @author Anastasios Psarras (a.psarras4225@gmail.com)
+ *
+ * @license MIT license, check license.md
+ *
+ * @brief Speck key schedule [ref] on the key registers of simon_core (SPECK), in both directions
+ *        [ref] R. Beaulieu, D. Shors, J. Smith, S. Treatman-Clark, B. Weeks, L. Wingers, "The Simon and Speck Families of Lightweight Block Ciphers", DAC 2015
+ *        The key words of step i are {l_(i+m-2), .., l_(i+1), l_i, k_i} (word 0 is the round key k_i, as for Simon):
+ *        -- Encryption (step i to i+1), the Speck round on (l_i, k_i) with i as the key:
+ *           l_(i+m-1) = (k_i + (l_i >>> alpha)) ^ i,  k_(i+1) = (k_i <<< beta) ^ l_(i+m-1)
+ *        -- Decryption (step i+1 back to i, from the key words of the last round), its inverse:
+ *           k_i = (k_(i+1) ^ l_(i+m-1)) >>> beta,    l_i = ((l_(i+m-1) ^ i) - k_i) <<< alpha
+ *        cnt_i is the step index i in both directions. Unlike Simon's, the last round's state holds l words that
+ *        are not round keys, so a decryption starts from all the key words of step T-1 (see simon_top).
+ *
+ * @param WW        Defines the word size (n in [ref])
+ * @param NKW       Defines the number of key words (m in [ref]).
+ */
+
+module speck_key_schedule
+#(
+    parameter int WW    = 16, // WW: Word Width (n) -- Legal values: 16, 24, 32, 48, 64
+    parameter int NKW   = 4   // NKW: Number of Key Words (m) -- Legal values: 2, 3, 4
+)
+(
+    input  logic                    mode_i,     // 0 for encryption, 1 for decryption
+    input  logic[NKW-1:0][WW-1:0]   key_cur_i,  // key word inputs
+    input  logic[WW-1:0]            cnt_i,      // step index i
+    
+    output logic[NKW-1:0][WW-1:0]   key_nxt_o   // key word outputs
+);
+
+// -- Constants ----------------------------------------------------------------------------------- //
+localparam int ALPHA    = WW == 16 ? 7 : 8;
+localparam int BETA     = WW == 16 ? 2 : 3;
+
+// -- Rotation handy functions -------------------------------------------------------------------- //
+function logic[WW-1:0] rot_left(input logic[WW-1:0] a, input int n);
+    return (a << n) | (a >> (WW-n));
+endfunction
+
+function logic[WW-1:0] rot_right(input logic[WW-1:0] a, input int n);
+    return (a >> n) | (a << (WW-n));
+endfunction
+
+// -- Comb Logic ---------------------------------------------------------------------------------- //
+logic[WW-1:0] enc_l;    // l_(i+m-1)
+logic[WW-1:0] enc_k;    // k_(i+1)
+logic[WW-1:0] dec_k;    // k_i
+logic[WW-1:0] dec_l;    // l_i
+
+assign enc_l    = (key_cur_i[0] + rot_right(key_cur_i[1], ALPHA)) ^ cnt_i;
+assign enc_k    = rot_left(key_cur_i[0], BETA) ^ enc_l;
+assign dec_k    = rot_right(key_cur_i[0] ^ key_cur_i[NKW-1], BETA);
+assign dec_l    = rot_left((key_cur_i[NKW-1] ^ cnt_i) - dec_k, ALPHA);
+
+// -- Outputs ------------------------------------------------------------------------------------- //
+// encryption: l_i is consumed & l_(i+m-1) shifted in on top; decryption: the other way around
+assign key_nxt_o[0] = mode_i ? dec_k : enc_k;
+if (NKW == 2) begin: g_if_m_eq_2
+    assign key_nxt_o[1] = mode_i ? dec_l : enc_l;
+end else begin: g_if_m_gt_2
+    assign key_nxt_o[1] = mode_i ? dec_l : key_cur_i[2];
+    for (genvar i=2; i<(NKW-1); i++) begin: g_for_i
+        assign key_nxt_o[i] = mode_i ? key_cur_i[i-1] : key_cur_i[i+1];
+    end
+    assign key_nxt_o[NKW-1] = mode_i ? key_cur_i[NKW-2] : enc_l;
+end
+
+// -- Design Parameter Assertions ----------------------------------------------------------------- //
+// synthesis translate_off
+initial begin
+    #0 assert (WW inside {16, 24, 32, 48, 64}) else $error("Illegal WW parameter value %0d -- legal values: 16, 24, 32, 48, 64", WW);
+    #0 assert (NKW inside {2, 3, 4}) else $error("Illegal NKW parameter value %0d -- legal values: 2, 3, 4", NKW);
+end
+// synthesis translate_on
+
+endmodule
@@ -0,0 +1,68 @@
+/**
+ * @info NSA's Speck round algorithm (combinational logic)
+ *
+ * @author Anastasios Psarras (a.psarras4225@gmail.com)
+ *
+ * @license MIT license, check license.md
+ *
+ * @brief Speck round [ref] for the Simon datapath of simon_core (SPECK), in both directions
+ *        [ref] R. Beaulieu, D. Shors, J. Smith, S. Treatman-Clark, B. Weeks, L. Wingers, "The Simon and Speck Families of Lightweight Block Ciphers", DAC 2015
+ *        Encryption: x' = ((x >>> alpha) + y) ^ k, y' = (y <<< beta) ^ x'
+ *        Decryption: y = (x' ^ y') >>> beta,       x = ((x' ^ k) - y) <<< alpha
+ *        with alpha/beta = 7/2 for n = 16, 8/3 otherwise. Simon's decryption runs the encryption round on the
+ *        word-reversed text, so simon_core holds a decryption's text word-reversed: the decryption round takes and
+ *        produces it the same way (x_i/x_o carry the y word, y_i/y_o the x word), and both ciphers share the text
+ *        registers & the word-reversed ciphertext/plaintext of the interfaces.
+ *
+ * @param WW        Defines the word size (n in [ref])
+ */
+
+module speck_round
+#(
+    parameter int WW    = 16 // WW: Word Width (n) -- Legal values: 16, 24, 32, 48, 64
+)
+(
+    input  logic         mode_i,    // 0 for encryption, 1 for decryption
+    input  logic[WW-1:0] key_i,
+    input  logic[WW-1:0] x_i,
+    input  logic[WW-1:0] y_i,
+    
+    output logic[WW-1:0] x_o,
+    output logic[WW-1:0] y_o
+);
+
+// -- Constants ----------------------------------------------------------------------------------- //
+localparam int ALPHA    = WW == 16 ? 7 : 8;
+localparam int BETA     = WW == 16 ? 2 : 3;
+
+// -- Rotation handy functions -------------------------------------------------------------------- //
+function logic[WW-1:0] rot_left(input logic[WW-1:0] a, input int n);
+    return (a << n) | (a >> (WW-n));
+endfunction
+
+function logic[WW-1:0] rot_right(input logic[WW-1:0] a, input int n);
+    return (a >> n) | (a << (WW-n));
+endfunction
+
+// -- Comb Logic ---------------------------------------------------------------------------------- //
+logic[WW-1:0] enc_x;
+logic[WW-1:0] enc_y;
+logic[WW-1:0] dec_x;
+logic[WW-1:0] dec_y;
+
+assign enc_x    = (rot_right(x_i, ALPHA) + y_i) ^ key_i;
+assign enc_y    = rot_left(y_i, BETA) ^ enc_x;
+// word-reversed: y_i is x', x_i is y'
+assign dec_y    = rot_right(y_i ^ x_i, BETA);
+assign dec_x    = rot_left((y_i ^ key_i) - dec_y, ALPHA);
+
+// -- Outputs ------------------------------------------------------------------------------------- //
+assign x_o = mode_i ? dec_y : enc_x;
+assign y_o = mode_i ? dec_x : enc_y;
+
+// synthesis translate_off
+initial begin
+    #0 assert (WW inside {16, 24, 32, 48, 64}) else $error("Illegal WW parameter value %0d -- legal values: 16, 24, 32, 48, 64", WW);
+end
+// synthesis translate_on
+endmodule
@@ -0,0 +1,115 @@
+/**
+ * @info Synchronous FIFO
+ *
+ * @author Anastasios Psarras (a.psarras4225@gmail.com)
+ *
+ * @license MIT license, check license.md
+ *
+ * @brief Generic single-clock FIFO with a valid/ready interface on both sides. Storage is a register array
+ *        addressed by read/write pointers; the output is taken straight from the entry at the read pointer,
+ *        so data pushed into an empty FIFO is available the next cycle. Pushing into a full FIFO and popping
+ *        from an empty one are prevented by the handshakes (ready_o / valid_o stay low). clr_i drops all the entries
+ *        (taking precedence over a push in the same cycle).
+ *
+ * @param WIDTH     Width of each entry
+ * @param DEPTH     Number of entries (any value >= 1)
+ * @param DATA_RST  Sets whether the storage registers are resettable to zero
+ */
+
+module sync_fifo
+#(
+    parameter int   WIDTH       = 8,
+    parameter int   DEPTH       = 4,
+    parameter logic DATA_RST    = 1'b0
+)
+(
+    input  logic                    clk,        // clock, @posedge
+    input  logic                    arst_n,     // async reset -- active low
+    input  logic                    clr_i,      // sync clear -- empties the FIFO
+    // Push Interface
+    input  logic                    valid_i,    // push data_i
+    output logic                    ready_o,    // FIFO is not full
+    input  logic[WIDTH-1:0]         data_i,
+    // Pop Interface
+    output logic                    valid_o,    // FIFO is not empty -- data_o is the oldest entry
+    input  logic                    ready_i,    // pop data_o
+    output logic[WIDTH-1:0]         data_o,
+    // Status
+    output logic[$clog2(DEPTH+1)-1:0] count_o   // number of entries
+);
+
+// -- Constants ----------------------------------------------------------------------------------- //
+localparam int PTR_W = DEPTH > 1 ? $clog2(DEPTH) : 1;
+localparam int CNT_W = $clog2(DEPTH+1);
+
+// -- Signals ------------------------------------------------------------------------------------- //
+logic[DEPTH-1:0][WIDTH-1:0] mem_r;
+logic[PTR_W-1:0]            wr_ptr_r;
+logic[PTR_W-1:0]            rd_ptr_r;
+logic[CNT_W-1:0]            count_r;
+logic                       push;
+logic                       pop;
+
+assign push = valid_i & ready_o;
+assign pop  = valid_o & ready_i;
+
+// -- Pointers & Count ---------------------------------------------------------------------------- //
+always_ff @(posedge clk, negedge arst_n) begin: ff_ptrs
+    if (!arst_n) begin
+        wr_ptr_r    <= '0;
+        rd_ptr_r    <= '0;
+        count_r     <= '0;
+    end else begin
+        if (clr_i) begin
+            wr_ptr_r    <= '0;
+            rd_ptr_r    <= '0;
+            count_r     <= '0;
+        end else begin
+            if (push) begin
+                wr_ptr_r <= (wr_ptr_r == PTR_W'(DEPTH-1)) ? '0 : wr_ptr_r + 1;
+            end
+            if (pop) begin
+                rd_ptr_r <= (rd_ptr_r == PTR_W'(DEPTH-1)) ? '0 : rd_ptr_r + 1;
+            end
+            if (push && !pop) begin
+                count_r <= count_r + 1;
+            end else if (pop && !push) begin
+                count_r <= count_r - 1;
+            end
+        end
+    end
+end
+
+// -- Storage ------------------------------------------------------------------------------------- //
+if (DATA_RST) begin: g_if_data_rst
+    always_ff @(posedge clk, negedge arst_n) begin: ff_mem
+        if (!arst_n) begin
+            mem_r <= '0;
+        end else begin
+            if (push) begin
+                mem_r[wr_ptr_r] <= data_i;
+            end
+        end
+    end
+end else begin: g_if_not_data_rst
+    always_ff @(posedge clk) begin: ff_mem
+        if (push) begin
+            mem_r[wr_ptr_r] <= data_i;
+        end
+    end
+end
+
+// -- Outputs ------------------------------------------------------------------------------------- //
+assign ready_o  = (count_r != CNT_W'(DEPTH));
+assign valid_o  = (count_r != 0);
+assign data_o   = mem_r[rd_ptr_r];
+assign count_o  = count_r;
+
+// -- Design Parameter Assertions ----------------------------------------------------------------- //
+// synthesis translate_off
+initial begin
+    #0 assert (DEPTH >= 1) else $error("Illegal DEPTH parameter value %0d -- must be >= 1", DEPTH);
+    #0 assert (WIDTH >= 1) else $error("Illegal WIDTH parameter value %0d -- must be >= 1", WIDTH);
+end
+// synthesis translate_on
+endmodule
@@ -0,0 +1,199 @@
+#!/usr/bin/env python3
+"""
+@info   NSA's Simon cipher -- parallel multi-seed regression runner
+
+@author Anastasios Psarras (a.psarras4225@gmail.com)
+
+@license MIT license, check license.md
+
+@brief  Runs tb_top over a matrix of Simon configurations, sharding the random items of each configuration over
+        concurrent simulator processes with independent seeds, then merges the pass/fail counts (and, optionally,
+        the coverage databases) per configuration.
+        -- The design is compiled once; each shard elaborates tb_top with the configuration as -G overrides, and
+           runs ceil(ITEMS/SHARDS) items (+ITEMS) with seed SEED + config*SHARDS + shard, so that no two shards of
+           the whole matrix (of any configuration) share a seed.
+        -- A shard passes when its checker reports all of its transactions succeeded and no error was logged.
+        -- The exit status is non-zero if any shard failed, so the script can gate a CI job.
+        The default matrix is the NSA-verified configurations (Simon 64/96, 64/128, 128/128, 128/192, 128/256).
+        Commands default to ModelSim/QuestaSim; override them with --compile-cmd/--sim-cmd for other simulators.
+
+Example: scripts/regress.py -j 32 --items 100000 --shards 64 -G UNROLL=2 --cover
+"""
+
+import argparse
+import concurrent.futures
+import os
+import re
+import shlex
+import subprocess
+import sys
+import time
+
+# -- Defaults -------------------------------------------------------------------------------------- #
+# (WW, NKW) -- NSA-verified configurations
+NSA_CONFIGS = [(32, 3), (32, 4), (64, 2), (64, 3), (64, 4)]
+
+COMPILE_CMD = "vlog {cover} -f {flist}"
+SIM_CMD     = ("vsim -c {cover} -sv_seed {seed} {params} +ITEMS={items} +VERBOSITY=NONE {plusargs} -l {log} "
+               "-do \"{cover_save}run -a; quit -f\" tb_top")
+MERGE_CMD   = "vcover merge {out} {inputs}"
+
+RE_CHECKED  = re.compile(r"Checked all transactions: (\d+)/(\d+) succeeded")
+RE_ERROR    = re.compile(r"(\*\* (Error|Fatal)|\*\*\* FAILURE \*\*\*)")
+
+
+# -- Helpers --------------------------------------------------------------------------------------- #
+def parse_config(text):
+    """'64/128' (block/key size) or '32-4' (WW-NKW) -> (WW, NKW)"""
+    if "/" in text:
+        block, key = (int(v) for v in text.split("/"))
+        return block // 2, key // (block // 2)
+    ww, nkw = (int(v) for v in text.split("-"))
+    return ww, nkw
+
+
+def config_name(ww, nkw):
+    return "simon%d_%d" % (2 * ww, ww * nkw)
+
+
+def run_shard(job):
+    """Runs one simulation; returns (job, passed, checked, total, wall time, first error line)"""
+    start   = time.time()
+    log     = job["log"]
+    with open(log + ".out", "w") as out:
+        rc = subprocess.call(job["cmd"], shell=True, cwd=job["cwd"], stdout=out, stderr=subprocess.STDOUT)
+    checked, total, error = 0, 0, None
+    found = False
+    for path in (log, log + ".out"):
+        if not os.path.exists(path):
+            continue
+        with open(path, errors="replace") as f:
+            for line in f:
+                m = RE_CHECKED.search(line)
+                if m:
+                    checked, total, found = int(m.group(1)), int(m.group(2)), True
+                if error is None and RE_ERROR.search(line):
+                    error = line.strip()
+        if found:
+            break
+    if not found and error is None:
+        error = "no checker summary (exit code %d)" % rc
+    passed = found and error is None and checked == total == job["items"]
+    if found and error is None and not passed:
+        error = "%d/%d succeeded, %d items expected" % (checked, total, job["items"])
+    return job, passed, checked, total, time.time() - start, error
+
+
+# -- Main ------------------------------------------------------------------------------------------ #
+def main():
+    repo = os.path.abspath(os.path.join(os.path.dirname(__file__), ".."))
+
+    ap = argparse.ArgumentParser(description="Parallel multi-seed regression of tb_top over Simon configurations")
+    ap.add_argument("-c", "--config", action="append", metavar="CFG",
+                    help="configuration, as block/key size (e.g. 64/96) or WW-NKW (e.g. 32-3); repeatable "
+                         "(default: the NSA-verified configurations)")
+    ap.add_argument("-G", dest="params", action="append", default=[], metavar="NAME=VALUE",
+                    help="extra tb_top parameter override for all the runs (e.g. -G UNROLL=2); repeatable")
+    ap.add_argument("-p", "--plusarg", action="append", default=[], metavar="ARG",
+                    help="extra plusarg for all the runs (e.g. -p IDLE_PCT=10); repeatable")
+    ap.add_argument("-n", "--items", type=int, default=1000, help="random items per configuration (default 1000)")
+    ap.add_argument("-s", "--shards", type=int, default=8, help="simulations per configuration (default 8)")
+    ap.add_argument("-j", "--jobs", type=int, default=os.cpu_count() or 1,
+                    help="concurrent simulations (default: number of CPUs)")
+    ap.add_argument("--seed", type=int, default=1, help="seed of shard 0 of the first configuration; shard i of configuration c runs with seed+c*shards+i (default 1)")
+    ap.add_argument("--cover", action="store_true", help="compile with coverage and merge the shards' databases")
+    ap.add_argument("-o", "--outdir", default="regress", help="work/log directory (default ./regress)")
+    ap.add_argument("--flist", default=os.path.join(repo, "flist"), help="compilation filelist")
+    ap.add_argument("--no-compile", action="store_true", help="reuse the existing compilation in outdir")
+    ap.add_argument("--compile-cmd", default=COMPILE_CMD, help="compile command template {cover} {flist}")
+    ap.add_argument("--sim-cmd", default=SIM_CMD,
+                    help="simulation command template {cover} {seed} {params} {items} {plusargs} {log} {cover_save}")
+    ap.add_argument("--merge-cmd", default=MERGE_CMD, help="coverage merge command template {out} {inputs}")
+    args = ap.parse_args()
+
+    configs = [parse_config(c) for c in args.config] if args.config else NSA_CONFIGS
+    if args.items < 1 or args.shards < 1 or args.jobs < 1:
+        ap.error("--items, --shards and --jobs must be at least 1")
+    shards  = min(args.shards, args.items)
+    per     = -(-args.items // shards)  # ceil, every shard runs the same number of items
+    outdir  = os.path.abspath(args.outdir)
+    os.makedirs(outdir, exist_ok=True)
+
+    # compile once, shards only elaborate with their own -G overrides
+    if not args.no_compile:
+        cmd = args.compile_cmd.format(cover="+cover" if args.cover else "", flist=args.flist)
+        print("[regress] compiling: %s" % cmd, flush=True)
+        if subprocess.call(cmd, shell=True, cwd=outdir) != 0:
+            print("[regress] *** FAILURE *** compilation failed", file=sys.stderr)
+            return 2
+
+    jobs = []
+    for cfg_idx, (ww, nkw) in enumerate(configs):
+        name = config_name(ww, nkw)
+        os.makedirs(os.path.join(outdir, name), exist_ok=True)
+        params = " ".join(["-GWW=%d" % ww, "-GNKW=%d" % nkw] + ["-G%s" % p for p in args.params])
+        for i in range(shards):
+            seed    = args.seed + cfg_idx*shards + i
+            log     = os.path.join(outdir, name, "seed%d.log" % seed)
+            ucdb    = os.path.join(outdir, name, "seed%d.ucdb" % seed)
+            cmd     = args.sim_cmd.format(
+                cover       = "-coverage" if args.cover else "",
+                seed        = seed,
+                params      = params,
+                items       = per,
+                plusargs    = " ".join("+" + p for p in args.plusarg),
+                log         = shlex.quote(log),
+                cover_save  = ("coverage save -onexit %s; " % ucdb) if args.cover else "")
+            jobs.append({"name": name, "seed": seed, "items": per, "log": log, "ucdb": ucdb, "cmd": cmd,
+                         "cwd": outdir})
+
+    print("[regress] %d configuration(s) x %d shard(s) x %d item(s), %d concurrent simulation(s)"
+          % (len(configs), shards, per, args.jobs), flush=True)
+
+    # run & merge pass/fail counts per configuration
+    results = {config_name(ww, nkw): {"shards": 0, "failed": [], "checked": 0, "total": 0, "ucdbs": []}
+               for ww, nkw in configs}
+    start = time.time()
+    with concurrent.futures.ThreadPoolExecutor(max_workers=args.jobs) as pool:
+        for job, passed, checked, total, wall, error in pool.map(run_shard, jobs):
+            res = results[job["name"]]
+            res["shards"]   += 1
+            res["checked"]  += checked
+            res["total"]    += total
+            if os.path.exists(job["ucdb"]):
+                res["ucdbs"].append(job["ucdb"])
+            if not passed:
+                res["failed"].append((job["seed"], error, job["log"]))
+            print("[regress] %-12s seed %-6d %s %d/%d (%.1fs)" % (job["name"], job["seed"],
+                  "PASS" if passed else "FAIL", checked, total, wall), flush=True)
+
+    # merge coverage per configuration, then overall
+    if args.cover:
+        merged = []
+        for name, res in results.items():
+            if res["ucdbs"]:
+                out = os.path.join(outdir, name, "merged.ucdb")
+                subprocess.call(args.merge_cmd.format(out=out, inputs=" ".join(res["ucdbs"])), shell=True,
+                                cwd=outdir)
+                merged.append(out)
+        if merged:
+            out = os.path.join(outdir, "merged.ucdb")
+            subprocess.call(args.merge_cmd.format(out=out, inputs=" ".join(merged)), shell=True, cwd=outdir)
+            print("[regress] coverage merged into %s" % out)
+
+    # summary
+    print("\n[regress] %-12s %8s %8s %14s" % ("config", "shards", "failed", "transactions"))
+    n_failed = 0
+    for name, res in results.items():
+        n_failed += len(res["failed"])
+        print("[regress] %-12s %8d %8d %7d/%-7d" % (name, res["shards"], len(res["failed"]), res["checked"],
+                                                     res["total"]))
+        for seed, error, log in res["failed"]:
+            print("[regress]     seed %d: %s (%s)" % (seed, error, log))
+    print("[regress] %s in %.1fs" % ("*** PASSED ***" if n_failed == 0 else "*** FAILED *** %d shard(s)" % n_failed,
+                                     time.time() - start))
+    return 0 if n_failed == 0 else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
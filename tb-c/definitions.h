@@ -19,8 +19,13 @@
 #define ROTR64(x,r) (((x)>>(r)) | ((x)<<(64-(r))))
 
 // Extra definitions for the specific application -- not in original Implementation Guide
+#define N_ROUNDS__32_64   32
+#define N_ROUNDS__48_72   36
+#define N_ROUNDS__48_96   36
 #define N_ROUNDS__64_96   42
 #define N_ROUNDS__64_128  44
+#define N_ROUNDS__96_96   52
+#define N_ROUNDS__96_144  54
 #define N_ROUNDS__128_128 68
 #define N_ROUNDS__128_192 69
 #define N_ROUNDS__128_256 72
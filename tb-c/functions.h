@@ -58,4 +58,24 @@ void BytesToWords64(u8 bytes[],u64 words[],int numbytes)
     }
 }
 
+// Extra functions for the specific application -- not in original Implementation Guide
+// Generic versions for any word size of wbytes bytes (e.g. 3 for 24-bit, 6 for 48-bit words), little-endian
+void WordsNToBytes(u64 words[],u8 bytes[],int numwords,int wbytes)
+{
+    int i,b,j=0;
+    for(i=0;i<numwords;i++)
+        for(b=0;b<wbytes;b++)
+            bytes[j++]=(u8)(words[i]>>(8*b));
+}
+
+void BytesToWordsN(u8 bytes[],u64 words[],int numbytes,int wbytes)
+{
+    int i,b,j=0;
+    for(i=0;i<numbytes/wbytes;i++){
+        words[i]=0;
+        for(b=0;b<wbytes;b++)
+            words[i]|=(u64)bytes[j++]<<(8*b);
+    }
+}
+
 #endif // FUNCTIONS_H
\ No newline at end of file
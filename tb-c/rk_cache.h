@@ -0,0 +1,92 @@
+/**
+ * @author Anastasios Psarras (a.psarras4225@gmail.com)
+ *
+ * @license MIT license, check license.md
+ *
+ * @brief Bounded LRU cache of expanded Simon round keys, keyed by (block size, key size, key bytes)
+ *        Workloads that reuse a small set of keys skip the key schedule on every hit.
+ *        The cache depth can be overriden at compile time, e.g. -DRK_CACHE_DEPTH=64 (0 disables the cache).
+ *
+ */
+
+#ifndef RK_CACHE_H
+#define RK_CACHE_H
+
+#include "definitions.h"
+#include "string.h"
+
+#ifndef RK_CACHE_DEPTH
+#define RK_CACHE_DEPTH 16
+#endif
+
+#define RK_CACHE_MAX_KEY_BYTES  32                  // Simon 128/256
+#define RK_CACHE_MAX_ROUNDS     N_ROUNDS__128_256   // Simon 128/256
+
+typedef struct {
+    int         valid;
+    int         sz_txt;
+    int         sz_key;
+    u8          key[RK_CACHE_MAX_KEY_BYTES];
+    u64         last_use;
+    union {
+        u32     rk32[RK_CACHE_MAX_ROUNDS];
+        u64     rk64[RK_CACHE_MAX_ROUNDS];
+    } rk;
+} rk_cache_entry_t;
+
+static rk_cache_entry_t rk_cache[RK_CACHE_DEPTH > 0 ? RK_CACHE_DEPTH : 1];
+static rk_cache_entry_t rk_cache_nocache;   // scratch entry, used when the cache is disabled
+static u64              rk_cache_clock  = 0;
+static u64              rk_cache_hits   = 0;
+static u64              rk_cache_misses = 0;
+
+/**
+ * Returns the round key buffer for Simon<sz_txt>/<sz_key> with key key_u8.
+ * On a hit (*hit=1) the buffer already contains the expanded round keys.
+ * On a miss (*hit=0) the least recently used entry is re-tagged and the caller must fill in the round keys.
+ */
+void* RkCacheGet(int sz_txt, int sz_key, u8 key_u8[], int* hit)
+{
+    int victim = 0;
+    
+    rk_cache_clock++;
+    if (RK_CACHE_DEPTH == 0) {
+        rk_cache_misses++;
+        *hit = 0;
+        return rk_cache_nocache.rk.rk64;
+    }
+    
+    for (int i=0; i<RK_CACHE_DEPTH; i++) {
+        rk_cache_entry_t* e = &rk_cache[i];
+        if (e->valid && (e->sz_txt == sz_txt) && (e->sz_key == sz_key) && (memcmp(e->key, key_u8, sz_key/8) == 0)) {
+            e->last_use = rk_cache_clock;
+            rk_cache_hits++;
+            *hit = 1;
+            return e->rk.rk64;
+        }
+        // invalid entries first, then the least recently used one
+        if (!e->valid || (rk_cache[victim].valid && (e->last_use < rk_cache[victim].last_use)))
+            victim = i;
+    }
+    
+    rk_cache[victim].valid      = 1;
+    rk_cache[victim].sz_txt     = sz_txt;
+    rk_cache[victim].sz_key     = sz_key;
+    rk_cache[victim].last_use   = rk_cache_clock;
+    memcpy(rk_cache[victim].key, key_u8, sz_key/8);
+    rk_cache_misses++;
+    *hit = 0;
+    return rk_cache[victim].rk.rk64;
+}
+
+// Invalidates all entries & clears the hit/miss counters
+void RkCacheReset()
+{
+    for (int i=0; i<RK_CACHE_DEPTH; i++)
+        rk_cache[i].valid = 0;
+    rk_cache_clock  = 0;
+    rk_cache_hits   = 0;
+    rk_cache_misses = 0;
+}
+
+#endif // RK_CACHE_H
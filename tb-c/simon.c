@@ -4,6 +4,7 @@
  * @license MIT license, check license.md
  *
  * @brief NSA's Simon cipher C implementation for use with SystemVerilog DPI-C testbench
+ *        (and the generic Speck kernel, speck_generic.h, for simon_top's SPECK blocks)
  *
  * @param crypto_mode   Defines whether it's encryption or decryption (MODE_ENC or MODE_DEC, see definitions.h)
  * @param txt_i         Input plaintext (on encryption) or ciphertext (on decryption)
@@ -19,98 +20,581 @@
 #include "functions.h"
 #include "simon64.h"
 #include "simon128.h"
+#include "simon_generic.h"
+#include "speck_generic.h"
+#include "rk_cache.h"
+#include "simon_vec.h"
+#include "simon_ctr.h"
+#include "tb_log.h"
 
 #include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
 
-void dpi_c_run_simon(int crypto_mode, svOpenArrayHandle txt_i, svOpenArrayHandle key_i, svOpenArrayHandle txt_o)
+// Runs a single Simon<sz_txt>/<sz_key> enc/decryption on byte arrays -- returns 0 on success
+static int run_simon(int crypto_mode, int sz_txt, int sz_key, u8 txti_u8[], u8 key_u8[], u8 txto_u8[])
 {
-    int sz_txt = svSize(txt_i, 1) * 8;
-    int sz_key = svSize(key_i, 1) * 8;
-    io_printf("[DPI-C] *** INFO *** Detected Simon%0d/%0d -- %s mode.\n", sz_txt, sz_key, crypto_mode == MODE_ENC ? "encryption" : "decryption");
-    
-    u8 txti_u8[sz_txt/8];
-    u8 key_u8[sz_key/8];
-    u8 txto_u8[sz_txt/8];
-    // -- 1a. Convert Input Text to Byte array ---------------------------------------------------- //
-    for (int i=svLow(txt_i, 1); i<(svHigh(txt_i, 1)+1); i++) {
-        txti_u8[i] = *((u8*)svGetArrElemPtr(txt_i, i));
-    }
-    // -- 1b. Convert Key to Byte array ----------------------------------------------------------- //
-    for (int i=svLow(key_i, 1); i<(svHigh(key_i, 1)+1); i++)
-        key_u8[i] = *((u8*)svGetArrElemPtr(key_i, i));
-    
+    int ok = 1;
+    int hit;
     if (sz_txt == 64) {
         u32 txti_u32[sz_txt/32];
         u32 key_u32[sz_key/32];
         u32 txto_u32[sz_txt/32];
-        // -- 2. Convert Plaintext & Key to Words ------------------------------------------------- //
+        // -- 2. Convert Plaintext to Words ------------------------------------------------------- //
         BytesToWords32(txti_u8, txti_u32, sz_txt/8);
-        BytesToWords32(key_u8, key_u32, sz_key/8);
         
-        // -- 3. Run Key Schedule & Enc/Decryption ------------------------------------------------ //
+        // -- 3. Run Key Schedule (on a round key cache miss) & Enc/Decryption -------------------- //
         if (sz_key == 96) {
-            u32 rk[N_ROUNDS__64_96];
-            Simon6496KeySchedule(key_u32, rk);
+            u32* rk = (u32*)RkCacheGet(sz_txt, sz_key, key_u8, &hit);
+            if (!hit) {
+                BytesToWords32(key_u8, key_u32, sz_key/8);
+                Simon6496KeySchedule(key_u32, rk);
+            }
             if (crypto_mode == MODE_ENC)
                 Simon6496Encrypt(txti_u32, txto_u32, rk);
             else
                 Simon6496Decrypt(txto_u32, txti_u32, rk);
         } else if (sz_key == 128) {
-            u32 rk[N_ROUNDS__64_128];
-            Simon64128KeySchedule(key_u32, rk);
+            u32* rk = (u32*)RkCacheGet(sz_txt, sz_key, key_u8, &hit);
+            if (!hit) {
+                BytesToWords32(key_u8, key_u32, sz_key/8);
+                Simon64128KeySchedule(key_u32, rk);
+            }
             if (crypto_mode == MODE_ENC)
                 Simon64128Encrypt(txti_u32, txto_u32, rk);
             else
                 Simon64128Decrypt(txto_u32, txti_u32, rk);
         } else {
-            // fail
-            io_printf("[DPI-C] *** FAILURE *** I dont know how to run Simon%0d/%0d\n", sz_txt, sz_key);
+            ok = 0;
         }
         // -- 4. Convert Output Text to Bytes ----------------------------------------------------- //
-        Words32ToBytes(txto_u32, txto_u8, sz_txt/8);
+        if (ok)
+            Words32ToBytes(txto_u32, txto_u8, sz_txt/32);
     } else if (sz_txt == 128) {
         u64 txti_u64[sz_txt/64];
         u64 key_u64[sz_key/64];
         u64 txto_u64[sz_txt/64];
         
-        // -- 2. Convert Plaintext & Key to Words ------------------------------------------------- //
+        // -- 2. Convert Plaintext to Words ------------------------------------------------------- //
         BytesToWords64(txti_u8, txti_u64, sz_txt/8);
-        BytesToWords64(key_u8, key_u64, sz_key/8);
 
-        // -- 3. Run Key Schedule & Enc/Decryption ------------------------------------------------ //
+        // -- 3. Run Key Schedule (on a round key cache miss) & Enc/Decryption -------------------- //
         if (sz_key == 128) {
-            u64 rk[N_ROUNDS__128_128];
-            Simon128128KeySchedule(key_u64, rk);
+            u64* rk = (u64*)RkCacheGet(sz_txt, sz_key, key_u8, &hit);
+            if (!hit) {
+                BytesToWords64(key_u8, key_u64, sz_key/8);
+                Simon128128KeySchedule(key_u64, rk);
+            }
             if (crypto_mode == MODE_ENC)
                 Simon128128Encrypt(txti_u64, txto_u64, rk);
             else
                 Simon128128Decrypt(txto_u64, txti_u64, rk);
         } else if (sz_key == 192) {
-            u64 rk[N_ROUNDS__128_192];
-            Simon128192KeySchedule(key_u64, rk);
+            u64* rk = (u64*)RkCacheGet(sz_txt, sz_key, key_u8, &hit);
+            if (!hit) {
+                BytesToWords64(key_u8, key_u64, sz_key/8);
+                Simon128192KeySchedule(key_u64, rk);
+            }
             if (crypto_mode == MODE_ENC)
                 Simon128192Encrypt(txti_u64, txto_u64, rk);
             else
                 Simon128192Decrypt(txto_u64, txti_u64, rk);
         } else if (sz_key == 256) {
-            u64 rk[N_ROUNDS__128_256];
-            Simon128256KeySchedule(key_u64, rk);
+            u64* rk = (u64*)RkCacheGet(sz_txt, sz_key, key_u8, &hit);
+            if (!hit) {
+                BytesToWords64(key_u8, key_u64, sz_key/8);
+                Simon128256KeySchedule(key_u64, rk);
+            }
             if (crypto_mode == MODE_ENC)
                 Simon128256Encrypt(txti_u64, txto_u64, rk);
             else
                 Simon128256Decrypt(txto_u64, txti_u64, rk);
         } else {
-            // fail
-            io_printf("[DPI-C] *** FAILURE *** I dont know how to run Simon%0d/%0d\n", sz_txt, sz_key);
+            ok = 0;
         }
-        // -- 4. Convert Output Text to Bytes ---------------------------------------------------00 //
-        Words64ToBytes(txto_u64, txto_u8, sz_txt/8);
+        // -- 4. Convert Output Text to Bytes ----------------------------------------------------- //
+        if (ok)
+            Words64ToBytes(txto_u64, txto_u8, sz_txt/64);
+    } else if (SimonGenConfig(sz_txt, sz_key) != NULL) {
+        // -- Configurations not covered by the NSA code: generic kernel ------------------------- //
+        static int self_tested = 0;
+        const simon_gen_cfg_t* cfg = SimonGenConfig(sz_txt, sz_key);
+        int wbytes = cfg->ww/8;
+        u64 txti_u64[2];
+        u64 key_u64[4];
+        u64 txto_u64[2];
+        
+        if (!self_tested) {
+            if (SimonGenSelfTest() != 0)
+                io_printf("[DPI-C] *** FAILURE *** Generic Simon kernel failed its known-answer self test\n");
+            self_tested = 1;
+        }
+        
+        // -- 2. Convert Plaintext to Words ------------------------------------------------------- //
+        BytesToWordsN(txti_u8, txti_u64, sz_txt/8, wbytes);
+        
+        // -- 3. Run Key Schedule (on a round key cache miss) & Enc/Decryption -------------------- //
+        u64* rk = (u64*)RkCacheGet(sz_txt, sz_key, key_u8, &hit);
+        if (!hit) {
+            BytesToWordsN(key_u8, key_u64, sz_key/8, wbytes);
+            cfg->KeySchedule(key_u64, rk);
+        }
+        if (crypto_mode == MODE_ENC)
+            cfg->Encrypt(txti_u64, txto_u64, rk);
+        else
+            cfg->Decrypt(txto_u64, txti_u64, rk);
+        
+        // -- 4. Convert Output Text to Bytes ----------------------------------------------------- //
+        WordsNToBytes(txto_u64, txto_u8, 2, wbytes);
     } else {
-        // fail
+        ok = 0;
+    }
+    
+    if (!ok)
         io_printf("[DPI-C] *** FAILURE *** I dont know how to run Simon%0d/%0d\n", sz_txt, sz_key);
+    return ok ? 0 : -1;
+}
+
+void dpi_c_run_simon(int crypto_mode, svOpenArrayHandle txt_i, svOpenArrayHandle key_i, svOpenArrayHandle txt_o)
+{
+    int sz_txt = svSize(txt_i, 1) * 8;
+    int sz_key = svSize(key_i, 1) * 8;
+    LogMsg(LOG_HIGH, "[DPI-C] *** INFO *** Detected Simon%0d/%0d -- %s mode.\n", sz_txt, sz_key, crypto_mode == MODE_ENC ? "encryption" : "decryption");
+    
+    u8 txti_u8[sz_txt/8];
+    u8 key_u8[sz_key/8];
+    u8 txto_u8[sz_txt/8];
+    // -- 1a. Convert Input Text to Byte array ---------------------------------------------------- //
+    for (int i=svLow(txt_i, 1); i<(svHigh(txt_i, 1)+1); i++) {
+        txti_u8[i] = *((u8*)svGetArrElemPtr(txt_i, i));
     }
+    // -- 1b. Convert Key to Byte array ----------------------------------------------------------- //
+    for (int i=svLow(key_i, 1); i<(svHigh(key_i, 1)+1); i++)
+        key_u8[i] = *((u8*)svGetArrElemPtr(key_i, i));
+    
+    // -- 2-4. Run Simon -------------------------------------------------------------------------- //
+    run_simon(crypto_mode, sz_txt, sz_key, txti_u8, key_u8, txto_u8);
     
     // -- 5. Convert Output Text to sv open array ------------------------------------------------- //
     for (int i=svLow(txt_i, 1); i<(svHigh(txt_i, 1)+1); i++)
         *(u8*)svGetArrElemPtr1(txt_o, i) = txto_u8[i];
 }
+
+/**
+ * @brief Batched version of dpi_c_run_simon: runs n_items transactions in a single DPI crossing
+ *
+ * @param n_items       Number of transactions in the batch
+ * @param modes_i       n_items modes (MODE_ENC or MODE_DEC), one per transaction
+ * @param txts_i        n_items input texts, concatenated (item i occupies bytes [i*txt_bytes, (i+1)*txt_bytes))
+ * @param keys_i        n_items keys, concatenated in the same manner
+ * @param txts_o        n_items output texts, concatenated in the same manner
+ *
+ * Text & key sizes are deduced from the array sizes, i.e. all items of a batch share the same Simon configuration.
+ * Returns the number of items that could not be run (0 on success).
+ */
+int dpi_c_run_simon_batch(int n_items, const svOpenArrayHandle modes_i, const svOpenArrayHandle txts_i, const svOpenArrayHandle keys_i, const svOpenArrayHandle txts_o)
+{
+    if (n_items <= 0)
+        return 0;
+    
+    int txt_bytes = svSize(txts_i, 1) / n_items;
+    int key_bytes = svSize(keys_i, 1) / n_items;
+    int n_failed  = 0;
+    LogMsg(LOG_MEDIUM, "[DPI-C] *** INFO *** Detected Simon%0d/%0d -- batch of %0d items.\n", txt_bytes*8, key_bytes*8, n_items);
+    
+    // -- 1. Get direct access to the sv open arrays ---------------------------------------------- //
+    // svGetArrayPtr() returns NULL if the simulator's representation is not C-compatible,
+    // in which case all arrays are copied element by element
+    int* modes = (int*)svGetArrayPtr(modes_i);
+    u8*  txti  = (u8*)svGetArrayPtr(txts_i);
+    u8*  keys  = (u8*)svGetArrayPtr(keys_i);
+    u8*  txto  = (u8*)svGetArrayPtr(txts_o);
+    int  copy  = (modes == NULL) || (txti == NULL) || (keys == NULL) || (txto == NULL);
+    
+    if (copy) {
+        modes = (int*)malloc(n_items * sizeof(int));
+        txti  = (u8*)malloc(n_items * txt_bytes);
+        keys  = (u8*)malloc(n_items * key_bytes);
+        txto  = (u8*)malloc(n_items * txt_bytes);
+        for (int i=0; i<n_items; i++)
+            modes[i] = *((int*)svGetArrElemPtr1(modes_i, svLow(modes_i, 1)+i));
+        for (int i=0; i<n_items*txt_bytes; i++)
+            txti[i] = *((u8*)svGetArrElemPtr1(txts_i, svLow(txts_i, 1)+i));
+        for (int i=0; i<n_items*key_bytes; i++)
+            keys[i] = *((u8*)svGetArrElemPtr1(keys_i, svLow(keys_i, 1)+i));
+    }
+    
+    // -- 2. Run Simon on each item --------------------------------------------------------------- //
+    for (int i=0; i<n_items; i++) {
+        if (run_simon(modes[i], txt_bytes*8, key_bytes*8, &txti[i*txt_bytes], &keys[i*key_bytes], &txto[i*txt_bytes]) != 0)
+            n_failed++;
+    }
+    
+    // -- 3. Write back output texts (only when copied) ------------------------------------------- //
+    if (copy) {
+        for (int i=0; i<n_items*txt_bytes; i++)
+            *((u8*)svGetArrElemPtr1(txts_o, svLow(txts_o, 1)+i)) = txto[i];
+        free(modes);
+        free(txti);
+        free(keys);
+        free(txto);
+    }
+    return n_failed;
+}
+
+/**
+ * @brief Returns the round key cache counters (see rk_cache.h)
+ *
+ * @param hits          Number of lookups that found the expanded round keys in the cache
+ * @param misses        Number of lookups that had to run the key schedule
+ */
+void dpi_c_get_rk_cache_stats(long long* hits, long long* misses)
+{
+    *hits   = (long long)rk_cache_hits;
+    *misses = (long long)rk_cache_misses;
+}
+
+// Invalidates the round key cache & clears its counters
+void dpi_c_reset_rk_cache()
+{
+    RkCacheReset();
+}
+
+// -- Packed (svBitVecVal) interface ----------------------------------------------------------- //
+// A packed bit[k*WW-1:0] vector is an array of 32-bit chunks, least significant first, i.e. word i occupies bits [i*WW +: WW].
+// For WW=32 each chunk is a word, for WW=64 each pair of chunks is a word, so the NSA kernels run on the vectors directly.
+// Other word sizes are extracted bit-wise by the following helpers.
+static void VecToWordsN(const svBitVecVal vec[], u64 words[], int numwords, int ww)
+{
+    for (int w=0; w<numwords; w++) {
+        words[w] = 0;
+        for (int b=0; b<ww; b++) {
+            int bit = w*ww + b;
+            words[w] |= (u64)((vec[bit/32] >> (bit%32)) & 1) << b;
+        }
+    }
+}
+
+static void WordsNToVec(u64 words[], svBitVecVal vec[], int numwords, int ww)
+{
+    for (int c=0; c<(numwords*ww+31)/32; c++)
+        vec[c] = 0;
+    for (int w=0; w<numwords; w++) {
+        for (int b=0; b<ww; b++) {
+            int bit = w*ww + b;
+            vec[bit/32] |= (svBitVecVal)((words[w] >> b) & 1) << (bit%32);
+        }
+    }
+}
+
+// Runs a single Simon<2*ww>/<nkw*ww> enc/decryption on packed vectors -- returns 0 on success
+// Note: the round key cache is tagged with the key vector's bytes, which matches the byte-array interface on little-endian hosts
+static int run_simon_packed(int crypto_mode, int ww, int nkw, const svBitVecVal* txt_i, const svBitVecVal* key_i, svBitVecVal* txt_o)
+{
+    int sz_txt = 2*ww;
+    int sz_key = nkw*ww;
+    int hit;
+    
+    if ((ww == 32) && ((nkw == 3) || (nkw == 4))) {
+        u32* txti = (u32*)txt_i;
+        u32* key  = (u32*)key_i;
+        u32* txto = (u32*)txt_o;
+        u32* rk   = (u32*)RkCacheGet(sz_txt, sz_key, (u8*)key_i, &hit);
+        if (nkw == 3) {
+            if (!hit)
+                Simon6496KeySchedule(key, rk);
+            if (crypto_mode == MODE_ENC)
+                Simon6496Encrypt(txti, txto, rk);
+            else
+                Simon6496Decrypt(txto, txti, rk);
+        } else {
+            if (!hit)
+                Simon64128KeySchedule(key, rk);
+            if (crypto_mode == MODE_ENC)
+                Simon64128Encrypt(txti, txto, rk);
+            else
+                Simon64128Decrypt(txto, txti, rk);
+        }
+    } else if ((ww == 64) && (nkw >= 2) && (nkw <= 4)) {
+        // chunk pairs form the 64-bit words (memcpy: svBitVecVal arrays are only 32-bit aligned)
+        u64 txti[2];
+        u64 key[4];
+        u64 txto[2];
+        u64* rk = (u64*)RkCacheGet(sz_txt, sz_key, (u8*)key_i, &hit);
+        memcpy(txti, txt_i, sizeof(txti));
+        if (!hit)
+            memcpy(key, key_i, nkw*sizeof(u64));
+        if (nkw == 2) {
+            if (!hit)
+                Simon128128KeySchedule(key, rk);
+            if (crypto_mode == MODE_ENC)
+                Simon128128Encrypt(txti, txto, rk);
+            else
+                Simon128128Decrypt(txto, txti, rk);
+        } else if (nkw == 3) {
+            if (!hit)
+                Simon128192KeySchedule(key, rk);
+            if (crypto_mode == MODE_ENC)
+                Simon128192Encrypt(txti, txto, rk);
+            else
+                Simon128192Decrypt(txto, txti, rk);
+        } else {
+            if (!hit)
+                Simon128256KeySchedule(key, rk);
+            if (crypto_mode == MODE_ENC)
+                Simon128256Encrypt(txti, txto, rk);
+            else
+                Simon128256Decrypt(txto, txti, rk);
+        }
+        memcpy(txt_o, txto, sizeof(txto));
+    } else if (SimonGenConfig(sz_txt, sz_key) != NULL) {
+        const simon_gen_cfg_t* cfg = SimonGenConfig(sz_txt, sz_key);
+        u64 txti[2];
+        u64 key[4];
+        u64 txto[2];
+        u64* rk = (u64*)RkCacheGet(sz_txt, sz_key, (u8*)key_i, &hit);
+        VecToWordsN(txt_i, txti, 2, ww);
+        if (!hit) {
+            VecToWordsN(key_i, key, nkw, ww);
+            cfg->KeySchedule(key, rk);
+        }
+        if (crypto_mode == MODE_ENC)
+            cfg->Encrypt(txti, txto, rk);
+        else
+            cfg->Decrypt(txto, txti, rk);
+        WordsNToVec(txto, txt_o, 2, ww);
+    } else {
+        io_printf("[DPI-C] *** FAILURE *** I dont know how to run Simon%0d/%0d\n", sz_txt, sz_key);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Same as dpi_c_run_simon, using packed vectors instead of byte arrays (no intermediate byte buffers)
+ *
+ * @param crypto_mode   MODE_ENC or MODE_DEC
+ * @param ww            Word size (WW)
+ * @param nkw           Number of key words (NKW)
+ * @param txt_i         Input text, bit[2*WW-1:0] (see crypto_item::get_flattened_txt())
+ * @param key_i         Input key, bit[NKW*WW-1:0] (see crypto_item::get_flattened_key())
+ * @param txt_o         Output text, bit[2*WW-1:0]
+ */
+void dpi_c_run_simon_packed(int crypto_mode, int ww, int nkw, const svBitVecVal* txt_i, const svBitVecVal* key_i, svBitVecVal* txt_o)
+{
+    run_simon_packed(crypto_mode, ww, nkw, txt_i, key_i, txt_o);
+}
+
+/**
+ * @brief Batched version of dpi_c_run_simon_packed: arrays of n_items packed vectors, one DPI crossing
+ *
+ * Returns the number of items that could not be run (0 on success).
+ */
+int dpi_c_run_simon_packed_batch(int n_items, int ww, int nkw, const svOpenArrayHandle modes_i, const svOpenArrayHandle txts_i, const svOpenArrayHandle keys_i, const svOpenArrayHandle txts_o)
+{
+    int n_failed = 0;
+    int* modes = (int*)svGetArrayPtr(modes_i);
+    for (int i=0; i<n_items; i++) {
+        int mode = modes ? modes[i] : *((int*)svGetArrElemPtr1(modes_i, svLow(modes_i, 1)+i));
+        if (run_simon_packed(mode, ww, nkw,
+                             (const svBitVecVal*)svGetArrElemPtr1(txts_i, svLow(txts_i, 1)+i),
+                             (const svBitVecVal*)svGetArrElemPtr1(keys_i, svLow(keys_i, 1)+i),
+                             (svBitVecVal*)svGetArrElemPtr1(txts_o, svLow(txts_o, 1)+i)) != 0)
+            n_failed++;
+    }
+    return n_failed;
+}
+
+// -- Speck (see speck_generic.h) --------------------------------------------------------------- //
+// Runs a single Speck<2*ww>/<nkw*ww> enc/decryption on packed vectors -- returns 0 on success
+// Note: the round key cache is tagged with Simon configurations only, so Speck's (cheap) key schedule runs every time
+static int run_speck_packed(int crypto_mode, int ww, int nkw, const svBitVecVal* txt_i, const svBitVecVal* key_i, svBitVecVal* txt_o)
+{
+    static int self_tested = 0;
+    const simon_gen_cfg_t* cfg = SpeckGenConfig(2*ww, nkw*ww);
+    u64 txti[2];
+    u64 key[4];
+    u64 txto[2];
+    u64 rk[SPECK_N_ROUNDS__128_256];
+    
+    if (cfg == NULL) {
+        io_printf("[DPI-C] *** FAILURE *** I dont know how to run Speck%0d/%0d\n", 2*ww, nkw*ww);
+        return -1;
+    }
+    if (!self_tested) {
+        if (SpeckGenSelfTest() != 0)
+            io_printf("[DPI-C] *** FAILURE *** Generic Speck kernel failed its known-answer self test\n");
+        self_tested = 1;
+    }
+    VecToWordsN(txt_i, txti, 2, ww);
+    VecToWordsN(key_i, key, nkw, ww);
+    cfg->KeySchedule(key, rk);
+    if (crypto_mode == MODE_ENC)
+        cfg->Encrypt(txti, txto, rk);
+    else
+        cfg->Decrypt(txto, txti, rk);
+    WordsNToVec(txto, txt_o, 2, ww);
+    return 0;
+}
+
+/**
+ * @brief Same as dpi_c_run_simon_packed, for Speck 2n/mn
+ */
+void dpi_c_run_speck_packed(int crypto_mode, int ww, int nkw, const svBitVecVal* txt_i, const svBitVecVal* key_i, svBitVecVal* txt_o)
+{
+    run_speck_packed(crypto_mode, ww, nkw, txt_i, key_i, txt_o);
+}
+
+/**
+ * @brief Same as dpi_c_run_simon_packed_batch, for Speck 2n/mn
+ *
+ * Returns the number of items that could not be run (0 on success).
+ */
+int dpi_c_run_speck_packed_batch(int n_items, int ww, int nkw, const svOpenArrayHandle modes_i, const svOpenArrayHandle txts_i, const svOpenArrayHandle keys_i, const svOpenArrayHandle txts_o)
+{
+    int n_failed = 0;
+    int* modes = (int*)svGetArrayPtr(modes_i);
+    for (int i=0; i<n_items; i++) {
+        int mode = modes ? modes[i] : *((int*)svGetArrElemPtr1(modes_i, svLow(modes_i, 1)+i));
+        if (run_speck_packed(mode, ww, nkw,
+                             (const svBitVecVal*)svGetArrElemPtr1(txts_i, svLow(txts_i, 1)+i),
+                             (const svBitVecVal*)svGetArrElemPtr1(keys_i, svLow(keys_i, 1)+i),
+                             (svBitVecVal*)svGetArrElemPtr1(txts_o, svLow(txts_o, 1)+i)) != 0)
+            n_failed++;
+    }
+    return n_failed;
+}
+
+// -- Test-vector file replay (see simon_vec.h) ------------------------------------------------- //
+static simon_vec_file_t vec_file = {.fd = -1};
+static u64              vec_next = 0;
+
+// Copies n little-endian bytes into a packed vector
+static void BytesToVec(const u8 bytes[], svBitVecVal vec[], int numbytes)
+{
+    for (int c=0; c<(numbytes+3)/4; c++)
+        vec[c] = 0;
+    for (int b=0; b<numbytes; b++)
+        vec[b/4] |= (svBitVecVal)bytes[b] << (8*(b%4));
+}
+
+/**
+ * @brief Opens a test-vector file for replay -- returns 0 on success
+ *
+ * @param path          File path
+ * @param ww            File's word size (WW)
+ * @param nkw           File's number of key words (NKW)
+ * @param n_records     Number of records in the file
+ */
+int dpi_c_vec_open(const char* path, int* ww, int* nkw, long long* n_records)
+{
+    const char* err;
+    SimonVecClose(&vec_file);
+    err = SimonVecOpen(path, &vec_file);
+    if (err) {
+        io_printf("[DPI-C] *** FAILURE *** Cannot read vector file %s: %s\n", path, err);
+        SimonVecClose(&vec_file);
+        return -1;
+    }
+    vec_next    = 0;
+    *ww         = vec_file.hdr->ww;
+    *nkw        = vec_file.hdr->nkw;
+    *n_records  = (long long)vec_file.hdr->n_records;
+    LogMsg(LOG_LOW, "[DPI-C] *** INFO *** Opened vector file %s: Simon%0d/%0d, %lld records.\n", path, 2*(*ww), (*ww)*(*nkw), *n_records);
+    return 0;
+}
+
+/**
+ * @brief Returns the next record of the opened vector file -- returns 1 if a record was returned, 0 at the end of the file
+ *
+ * @param mode          Record mode (MODE_ENC or MODE_DEC)
+ * @param txt_i         Input text, bit[2*WW-1:0]
+ * @param key_i         Key, bit[NKW*WW-1:0]
+ * @param txt_o         Expected output text, bit[2*WW-1:0]
+ */
+int dpi_c_vec_next(int* mode, svBitVecVal* txt_i, svBitVecVal* key_i, svBitVecVal* txt_o)
+{
+    if (!vec_file.map || (vec_next >= vec_file.hdr->n_records))
+        return 0;
+    
+    int txt_bytes = 2*vec_file.hdr->ww/8;
+    int key_bytes = vec_file.hdr->nkw*vec_file.hdr->ww/8;
+    const u8* rec = SimonVecRecord(&vec_file, vec_next++);
+    *mode = rec[0];
+    BytesToVec(&rec[1], txt_i, txt_bytes);
+    BytesToVec(&rec[1+txt_bytes], key_i, key_bytes);
+    BytesToVec(&rec[1+txt_bytes+key_bytes], txt_o, txt_bytes);
+    return 1;
+}
+
+void dpi_c_vec_close()
+{
+    SimonVecClose(&vec_file);
+}
+
+// -- Counter mode (see simon_ctr.h) ------------------------------------------------------------ //
+/**
+ * @brief Encrypts/decrypts a whole buffer in counter mode, in place -- returns 0 on success
+ *
+ * @param ww            Word size (n)
+ * @param nkw           Number of key words (m)
+ * @param key_i         Key, bit[NKW*WW-1:0]
+ * @param nonce_i       Nonce, bit[2*WW-1:0] -- the first counter block is nonce + ctr
+ * @param ctr           Initial block counter
+ * @param buf           Data, byte[] -- any length, overwritten with the result
+ */
+int dpi_c_run_simon_ctr(int ww, int nkw, const svBitVecVal* key_i, const svBitVecVal* nonce_i, long long ctr, const svOpenArrayHandle buf)
+{
+    simon_ctr_t c;
+    u64         key[4];
+    u64         nonce[2];
+    int         len = svSize(buf, 1);
+    
+    VecToWordsN(key_i, key, nkw, ww);
+    VecToWordsN(nonce_i, nonce, 2, ww);
+    if (SimonCtrInit(&c, 2*ww, nkw*ww, key, nonce, (u64)ctr) != 0) {
+        io_printf("[DPI-C] *** FAILURE *** I dont know how to run Simon%0d/%0d\n", 2*ww, nkw*ww);
+        return -1;
+    }
+    LogMsg(LOG_MEDIUM, "[DPI-C] *** INFO *** Detected Simon%0d/%0d -- CTR stream of %0d bytes.\n", 2*ww, nkw*ww, len);
+    
+    // svGetArrayPtr() returns NULL if the simulator's representation is not C-compatible -- copy in that case
+    u8* data = (u8*)svGetArrayPtr(buf);
+    if (data) {
+        SimonCtrXor(&c, data, len);
+    } else {
+        data = (u8*)malloc(len);
+        for (int i=0; i<len; i++)
+            data[i] = *((u8*)svGetArrElemPtr1(buf, svLow(buf, 1)+i));
+        SimonCtrXor(&c, data, len);
+        for (int i=0; i<len; i++)
+            *((u8*)svGetArrElemPtr1(buf, svLow(buf, 1)+i)) = data[i];
+        free(data);
+    }
+    return 0;
+}
+
+// -- Logging (see tb_log.h) -------------------------------------------------------------------- //
+// Sets the verbosity of both the DPI-C model & the messages the testbench routes through dpi_c_log
+void dpi_c_set_verbosity(int level)
+{
+    LogSetVerbosity(level);
+}
+
+// Enables keeping every message (DPI-C model & testbench) in the shared ring, whatever the verbosity
+void dpi_c_set_log_ring(int en)
+{
+    LogSetRing(en);
+}
+
+// Keeps a testbench message in the shared ring, printing it if level <= verbosity
+void dpi_c_log(int level, const char* msg)
+{
+    LogLine(level, msg);
+}
+
+// Prints & clears the shared ring -- called by the testbench on a failure
+void dpi_c_log_dump()
+{
+    LogDump();
+}
@@ -0,0 +1,415 @@
+/**
+ * @author Anastasios Psarras (a.psarras4225@gmail.com)
+ *
+ * @license MIT license, check license.md
+ *
+ * @brief Benchmark of the C Simon kernels (no simulator needed)
+ *        For every configuration, times the key schedule and the encryption/decryption of independent blocks through:
+ *          nsa      -- NSA's reference single-block kernels (simon64.h, simon128.h -- 64/96, 64/128 and the 128-bit block configurations)
+ *          generic  -- the generic single-block kernels (simon_generic.h)
+ *          rk_cache -- the per-item path of the DPI-C batch calls: a round-key cache lookup (rk_cache.h) + a single-block kernel
+ *          simd     -- the multi-block engine (simon_simd.h), in batches of -b blocks
+ *          ctr      -- the counter-mode streaming API (simon_ctr.h), on buffers of -b blocks (encryption & decryption are the same)
+ *        Each measurement is the best of -r repetitions. Cycles are read from the TSC on x86-64, and reported as 0 elsewhere.
+ *
+ *        Build:    gcc -O3 -o simon_bench tb-c/simon_bench.c
+ *        Usage:    simon_bench [-c <block>/<key>] [-n blocks] [-b batch] [-r reps] [-j file]
+ *
+ * @param -c        Only benchmark this configuration, e.g. 64/96 (default: all ten configurations)
+ * @param -n        Number of blocks per measurement (default: 1M)
+ * @param -b        Blocks per batch -- size of the working buffer (default: 1024)
+ * @param -r        Repetitions per measurement (default: 5)
+ * @param -j        Also write the results as JSON to this file ("-" for stdout, the table then goes to stderr)
+ *
+ */
+
+#include "stdint.h"
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include "time.h"
+#include "unistd.h"
+
+#include "definitions.h"
+#include "functions.h"
+#include "simon64.h"
+#include "simon128.h"
+#include "simon_generic.h"
+#include "simon_simd.h"
+#include "rk_cache.h"
+#include "simon_ctr.h"
+
+#define BENCH_MAX_RESULTS   (SIMON_GEN_N_CFGS * 14)
+#define BENCH_KEYS          256     // keys per key schedule measurement
+
+typedef struct {
+    char        config[16];
+    const char* variant;
+    const char* op;             // key_schedule, encrypt, decrypt
+    u64         n;              // blocks or keys per measurement
+    int         bytes;          // bytes per block (0 for the key schedule)
+    double      ns;             // per block / key
+    double      cycles;         // per block / key
+} bench_result_t;
+
+static bench_result_t   results[BENCH_MAX_RESULTS];
+static int              n_results = 0;
+static volatile u64     bench_sink;     // keeps the outputs alive
+
+// -- Timing ------------------------------------------------------------------------------------ //
+static double now_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static u64 now_cycles()
+{
+#if defined(__x86_64__) && defined(__GNUC__)
+    return __builtin_ia32_rdtsc();
+#else
+    return 0;
+#endif
+}
+
+// -- Kernels under test ------------------------------------------------------------------------ //
+typedef struct {
+    const simon_gen_cfg_t*  cfg;
+    int                     variant;    // BENCH_NSA, BENCH_GENERIC, BENCH_RK_CACHE, BENCH_SIMD
+    int                     decrypt;
+    int                     batch;
+    u64                     rk[N_ROUNDS__128_256];
+    u32                     rk32[N_ROUNDS__128_256];
+    u64                     key[4];
+    u8                      key_u8[32];
+    u64*                    in;
+    u64*                    out;
+    u32*                    in32;
+    u32*                    out32;
+    simon_ctr_t             ctr;
+    u8*                     stream;
+} bench_ctx_t;
+
+#define BENCH_NSA       0
+#define BENCH_GENERIC   1
+#define BENCH_RK_CACHE  2
+#define BENCH_SIMD      3
+#define BENCH_CTR       4
+
+static const char* variant_names[] = {"nsa", "generic", "rk_cache", "simd", "ctr"};
+
+static int has_nsa(const simon_gen_cfg_t* cfg)
+{
+    return ((cfg->ww == 32) && (cfg->nkw >= 3)) || (cfg->ww == 64);
+}
+
+// NSA key schedule on u64 words
+static void nsa_key_schedule(bench_ctx_t* c, u64 key[])
+{
+    const simon_gen_cfg_t* cfg = c->cfg;
+    if (cfg->ww == 32) {
+        u32 k32[4];
+        for (int i=0; i<cfg->nkw; i++)
+            k32[i] = (u32)key[i];
+        if (cfg->nkw == 3)
+            Simon6496KeySchedule(k32, c->rk32);
+        else
+            Simon64128KeySchedule(k32, c->rk32);
+    } else if (cfg->nkw == 2) {
+        Simon128128KeySchedule(key, c->rk);
+    } else if (cfg->nkw == 3) {
+        Simon128192KeySchedule(key, c->rk);
+    } else {
+        Simon128256KeySchedule(key, c->rk);
+    }
+}
+
+// One block through NSA's kernels
+static void nsa_block(bench_ctx_t* c, int b)
+{
+    const simon_gen_cfg_t* cfg = c->cfg;
+    if (cfg->ww == 32) {
+        u32* in  = &c->in32[2*b];
+        u32* out = &c->out32[2*b];
+        if (cfg->nkw == 3) {
+            if (c->decrypt) Simon6496Decrypt(out, in, c->rk32);
+            else            Simon6496Encrypt(in, out, c->rk32);
+        } else {
+            if (c->decrypt) Simon64128Decrypt(out, in, c->rk32);
+            else            Simon64128Encrypt(in, out, c->rk32);
+        }
+    } else {
+        u64* in  = &c->in[2*b];
+        u64* out = &c->out[2*b];
+        if (cfg->nkw == 2) {
+            if (c->decrypt) Simon128128Decrypt(out, in, c->rk);
+            else            Simon128128Encrypt(in, out, c->rk);
+        } else if (cfg->nkw == 3) {
+            if (c->decrypt) Simon128192Decrypt(out, in, c->rk);
+            else            Simon128192Encrypt(in, out, c->rk);
+        } else {
+            if (c->decrypt) Simon128256Decrypt(out, in, c->rk);
+            else            Simon128256Encrypt(in, out, c->rk);
+        }
+    }
+}
+
+// One block through the generic kernels
+static void generic_block(bench_ctx_t* c, u64 rk[], int b)
+{
+    if (c->decrypt) c->cfg->Decrypt(&c->out[2*b], &c->in[2*b], rk);
+    else            c->cfg->Encrypt(&c->in[2*b], &c->out[2*b], rk);
+}
+
+// One batch of c->batch blocks through the variant under test
+static void run_batch(bench_ctx_t* c)
+{
+    const simon_gen_cfg_t* cfg = c->cfg;
+    switch (c->variant) {
+        case BENCH_NSA:
+            for (int b=0; b<c->batch; b++)
+                nsa_block(c, b);
+            break;
+        case BENCH_GENERIC:
+            for (int b=0; b<c->batch; b++)
+                generic_block(c, c->rk, b);
+            break;
+        case BENCH_RK_CACHE:
+            for (int b=0; b<c->batch; b++) {
+                int  hit;
+                u64* rk = (u64*)RkCacheGet(2*cfg->ww, cfg->nkw*cfg->ww, c->key_u8, &hit);
+                if (!hit)
+                    cfg->KeySchedule(c->key, rk);
+                generic_block(c, rk, b);
+            }
+            break;
+        case BENCH_SIMD:
+            if (cfg->ww == 32) {
+                if (c->decrypt) SimonDecryptBlocks32(c->out32, c->in32, c->rk32, cfg->n_rounds, c->batch);
+                else            SimonEncryptBlocks32(c->in32, c->out32, c->rk32, cfg->n_rounds, c->batch);
+            } else if (cfg->ww == 64) {
+                if (c->decrypt) SimonDecryptBlocks64(c->out, c->in, c->rk, cfg->n_rounds, c->batch);
+                else            SimonEncryptBlocks64(c->in, c->out, c->rk, cfg->n_rounds, c->batch);
+            } else {
+                if (c->decrypt) SimonDecryptBlocksN(c->out, c->in, c->rk, cfg->n_rounds, cfg->ww, c->batch);
+                else            SimonEncryptBlocksN(c->in, c->out, c->rk, cfg->n_rounds, cfg->ww, c->batch);
+            }
+            break;
+        case BENCH_CTR:
+            SimonCtrXor(&c->ctr, c->stream, (size_t)c->batch * 2*cfg->ww/8);
+            bench_sink += c->stream[0];
+            break;
+    }
+    bench_sink += (cfg->ww == 32) ? c->out32[0] : c->out[0];
+}
+
+// -- Measurements ------------------------------------------------------------------------------ //
+static void add_result(const simon_gen_cfg_t* cfg, const char* variant, const char* op, u64 n, int bytes, double ns, double cycles)
+{
+    bench_result_t* r = &results[n_results++];
+    snprintf(r->config, sizeof(r->config), "%d/%d", 2*cfg->ww, cfg->nkw*cfg->ww);
+    r->variant  = variant;
+    r->op       = op;
+    r->n        = n;
+    r->bytes    = bytes;
+    r->ns       = ns / n;
+    r->cycles   = cycles / n;
+}
+
+static void bench_blocks(bench_ctx_t* c, u64 n_blocks, int reps)
+{
+    u64     n_batches   = (n_blocks + c->batch - 1) / c->batch;
+    double  best_ns     = 0;
+    double  best_cyc    = 0;
+
+    run_batch(c);   // warm-up
+    for (int r=0; r<reps; r++) {
+        double  t0 = now_ns();
+        u64     c0 = now_cycles();
+        for (u64 i=0; i<n_batches; i++)
+            run_batch(c);
+        double  t  = now_ns() - t0;
+        double  cy = (double)(now_cycles() - c0);
+        if ((r == 0) || (t < best_ns)) {
+            best_ns  = t;
+            best_cyc = cy;
+        }
+    }
+    add_result(c->cfg, variant_names[c->variant], c->decrypt ? "decrypt" : "encrypt", n_batches * c->batch, 2*c->cfg->ww/8, best_ns, best_cyc);
+}
+
+static void bench_key_schedule(bench_ctx_t* c, int variant, u64 n_keys, int reps)
+{
+    u64     keys[BENCH_KEYS][4];
+    double  best_ns     = 0;
+    double  best_cyc    = 0;
+    u64     n_rounds    = (n_keys + BENCH_KEYS - 1) / BENCH_KEYS;
+
+    for (int k=0; k<BENCH_KEYS; k++)
+        for (int i=0; i<4; i++)
+            keys[k][i] = ((u64)rand() << 32 | (u64)rand()) & MASKN(c->cfg->ww);
+
+    for (int r=0; r<reps; r++) {
+        double  t0 = now_ns();
+        u64     c0 = now_cycles();
+        for (u64 j=0; j<n_rounds; j++) {
+            for (int k=0; k<BENCH_KEYS; k++) {
+                if (variant == BENCH_NSA)
+                    nsa_key_schedule(c, keys[k]);
+                else
+                    c->cfg->KeySchedule(keys[k], c->rk);
+            }
+            bench_sink += c->rk[c->cfg->n_rounds-1] ^ c->rk32[c->cfg->n_rounds-1];
+        }
+        double  t  = now_ns() - t0;
+        double  cy = (double)(now_cycles() - c0);
+        if ((r == 0) || (t < best_ns)) {
+            best_ns  = t;
+            best_cyc = cy;
+        }
+    }
+    add_result(c->cfg, variant_names[variant], "key_schedule", n_rounds * BENCH_KEYS, 0, best_ns, best_cyc);
+}
+
+static void bench_config(const simon_gen_cfg_t* cfg, u64 n_blocks, int batch, int reps)
+{
+    bench_ctx_t c;
+    memset(&c, 0, sizeof(c));
+    c.cfg   = cfg;
+    c.batch = batch;
+    c.in    = (u64*)malloc(2*batch*sizeof(u64));
+    c.out   = (u64*)malloc(2*batch*sizeof(u64));
+    c.in32  = (u32*)malloc(2*batch*sizeof(u32));
+    c.out32 = (u32*)malloc(2*batch*sizeof(u32));
+    c.stream = (u8*)calloc((size_t)batch, 2*cfg->ww/8);
+    for (int i=0; i<2*batch; i++) {
+        c.in[i]   = ((u64)rand() << 32 | (u64)rand()) & MASKN(cfg->ww);
+        c.in32[i] = (u32)c.in[i];
+    }
+    for (int i=0; i<cfg->nkw; i++)
+        c.key[i] = ((u64)rand() << 32 | (u64)rand()) & MASKN(cfg->ww);
+    WordsNToBytes(c.key, c.key_u8, cfg->nkw, cfg->ww/8);
+
+    // -- Key schedule ---------------------------------------------------------------------------- //
+    if (has_nsa(cfg))
+        bench_key_schedule(&c, BENCH_NSA, n_blocks / 16, reps);
+    bench_key_schedule(&c, BENCH_GENERIC, n_blocks / 16, reps);
+
+    // -- Blocks ---------------------------------------------------------------------------------- //
+    cfg->KeySchedule(c.key, c.rk);
+    for (int i=0; i<cfg->n_rounds; i++)
+        c.rk32[i] = (u32)c.rk[i];
+    SimonCtrInit(&c.ctr, 2*cfg->ww, cfg->nkw*cfg->ww, c.key, c.in, 0);
+    for (c.variant=BENCH_NSA; c.variant<=BENCH_CTR; c.variant++) {
+        if ((c.variant == BENCH_NSA) && !has_nsa(cfg))
+            continue;
+        RkCacheReset();
+        for (c.decrypt=0; c.decrypt<2; c.decrypt++)
+            bench_blocks(&c, n_blocks, reps);
+    }
+
+    free(c.in);
+    free(c.out);
+    free(c.in32);
+    free(c.out32);
+    free(c.stream);
+}
+
+// -- Report ------------------------------------------------------------------------------------ //
+static void print_table(FILE* f)
+{
+    fprintf(f, "[simon_bench] *** INFO *** engine: %s\n", SimonSimdIsa());
+    fprintf(f, "%-9s %-9s %-13s %12s %12s %12s\n", "config", "variant", "op", "ns/block", "cycles/byte", "Mblocks/s");
+    for (int i=0; i<n_results; i++) {
+        bench_result_t* r = &results[i];
+        if (r->bytes == 0)
+            fprintf(f, "%-9s %-9s %-13s %12.2f %12s %12s   (ns/key, %.0f cycles/key)\n", r->config, r->variant, r->op, r->ns, "-", "-", r->cycles);
+        else
+            fprintf(f, "%-9s %-9s %-13s %12.2f %12.2f %12.3f\n", r->config, r->variant, r->op, r->ns, r->cycles / r->bytes, 1e3 / r->ns);
+    }
+}
+
+static void print_json(FILE* f, u64 n_blocks, int batch, int reps)
+{
+    fprintf(f, "{\n  \"engine\": \"%s\",\n  \"blocks\": %llu,\n  \"batch\": %d,\n  \"reps\": %d,\n  \"tsc\": %s,\n  \"results\": [\n",
+            SimonSimdIsa(), (unsigned long long)n_blocks, batch, reps, now_cycles() ? "true" : "false");
+    for (int i=0; i<n_results; i++) {
+        bench_result_t* r = &results[i];
+        if (r->bytes == 0)
+            fprintf(f, "    {\"config\": \"%s\", \"variant\": \"%s\", \"op\": \"%s\", \"n\": %llu, \"ns_per_key\": %.3f, \"cycles_per_key\": %.1f}",
+                    r->config, r->variant, r->op, (unsigned long long)r->n, r->ns, r->cycles);
+        else
+            fprintf(f, "    {\"config\": \"%s\", \"variant\": \"%s\", \"op\": \"%s\", \"n\": %llu, \"ns_per_block\": %.3f, \"cycles_per_byte\": %.3f}",
+                    r->config, r->variant, r->op, (unsigned long long)r->n, r->ns, r->cycles / r->bytes);
+        fprintf(f, "%s\n", i < n_results-1 ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+}
+
+// -- Main -------------------------------------------------------------------------------------- //
+static void usage(const char* prog)
+{
+    fprintf(stderr, "Usage: %s [-c <block>/<key>] [-n blocks] [-b batch] [-r reps] [-j file]\n", prog);
+}
+
+int main(int argc, char* argv[])
+{
+    const simon_gen_cfg_t*  only = NULL;
+    const char*             json_path = NULL;
+    u64                     n_blocks = 1000000;
+    int                     batch = 1024;
+    int                     reps = 5;
+    int                     opt;
+
+    while ((opt = getopt(argc, argv, "c:n:b:r:j:h")) != -1) {
+        switch (opt) {
+            case 'c': {
+                int sz_txt = 0, sz_key = 0;
+                sscanf(optarg, "%d/%d", &sz_txt, &sz_key);
+                only = SimonGenConfig(sz_txt, sz_key);
+                if (only == NULL) {
+                    fprintf(stderr, "[simon_bench] *** FAILURE *** I dont know how to run Simon%s\n", optarg);
+                    return 1;
+                }
+                break;
+            }
+            case 'n': n_blocks = strtoull(optarg, NULL, 0); break;
+            case 'b': batch = atoi(optarg); break;
+            case 'r': reps = atoi(optarg); break;
+            case 'j': json_path = optarg; break;
+            default:  usage(argv[0]); return 1;
+        }
+    }
+    if (batch < 1)
+        batch = 1;
+    if (reps < 1)
+        reps = 1;
+    if (n_blocks < 16)
+        n_blocks = 16;
+
+    // don't time broken kernels
+    if (SimonGenSelfTest() != 0) {
+        fprintf(stderr, "[simon_bench] *** FAILURE *** generic kernels failed their self-test\n");
+        return 1;
+    }
+
+    srand(1);
+    for (int i=0; i<SIMON_GEN_N_CFGS; i++)
+        if ((only == NULL) || (only == &simon_gen_cfgs[i]))
+            bench_config(&simon_gen_cfgs[i], n_blocks, batch, reps);
+
+    int json_stdout = json_path && (strcmp(json_path, "-") == 0);
+    print_table(json_stdout ? stderr : stdout);
+    if (json_path) {
+        FILE* f = json_stdout ? stdout : fopen(json_path, "w");
+        if (f == NULL) {
+            perror("[simon_bench] *** FAILURE *** cannot create JSON file");
+            return 1;
+        }
+        print_json(f, n_blocks, batch, reps);
+        if (!json_stdout)
+            fclose(f);
+    }
+    return 0;
+}
@@ -0,0 +1,150 @@
+/**
+ * @author Anastasios Psarras (a.psarras4225@gmail.com)
+ *
+ * @license MIT license, check license.md
+ *
+ * @brief Counter-mode (CTR) streaming API on top of the Simon kernels, for any of the ten configurations
+ *        The key is expanded once in SimonCtrInit(). SimonCtrXor() then encrypts/decrypts (the same operation)
+ *        a buffer of any length in place: keystream blocks are generated SIMON_CTR_BATCH at a time through the
+ *        multi-block engine (simon_simd.h), in stack buffers, and XORed into the data -- no heap allocation.
+ *        Consecutive calls continue the stream, also from the middle of a block.
+ *
+ *        Counter block i is (nonce + ctr + i) mod 2^(2n), as a 2n-bit integer whose word 0 holds the low n bits,
+ *        encrypted and serialized like any other block (word 0 first, each word little-endian, see functions.h).
+ *
+ */
+
+#ifndef SIMON_CTR_H
+#define SIMON_CTR_H
+
+#include "definitions.h"
+#include "functions.h"
+#include "simon_generic.h"
+#include "simon_simd.h"
+#include "string.h"
+
+#ifndef SIMON_CTR_BATCH
+#define SIMON_CTR_BATCH 64      // keystream blocks per multi-block engine call
+#endif
+
+typedef struct {
+    const simon_gen_cfg_t*  cfg;
+    u64                     rk[N_ROUNDS__128_256];
+    u32                     rk32[N_ROUNDS__128_256];
+    u64                     ctr[2];                 // next counter block (word 0, word 1)
+    u8                      ks[16];                 // keystream of the current block
+    int                     ks_used;                // bytes of ks[] already consumed (block size if none left)
+} simon_ctr_t;
+
+// Adds v to the 2n-bit counter block
+static void SimonCtrAdd(const simon_gen_cfg_t* cfg, u64 ctr[], u64 v)
+{
+    const u64 mask = MASKN(cfg->ww);
+    if (cfg->ww == 64) {
+        u64 lo = ctr[0] + v;
+        ctr[1] += (lo < ctr[0]);
+        ctr[0]  = lo;
+    } else {
+        // v is split in words, n <= 48 so that no sum overflows
+        u64 lo = ctr[0] + (v & mask);
+        u64 hi = ctr[1] + ((v >> cfg->ww) & mask) + (lo >> cfg->ww);
+        ctr[0] = lo & mask;
+        ctr[1] = hi & mask;
+    }
+}
+
+/**
+ * @brief Expands the key & sets the initial counter block -- returns 0 on success, -1 for an unknown configuration
+ *
+ * @param sz_txt    Block size (e.g. 64)
+ * @param sz_key    Key size (e.g. 96)
+ * @param key       NKW key words
+ * @param nonce     Nonce, as a counter block (word 0, word 1)
+ * @param ctr       Initial block counter, added to the nonce
+ */
+int SimonCtrInit(simon_ctr_t* c, int sz_txt, int sz_key, u64 key[], u64 nonce[], u64 ctr)
+{
+    c->cfg = SimonGenConfig(sz_txt, sz_key);
+    if (c->cfg == NULL)
+        return -1;
+    c->cfg->KeySchedule(key, c->rk);
+    for (int i=0; i<c->cfg->n_rounds; i++)
+        c->rk32[i] = (u32)c->rk[i];
+    c->ctr[0]   = nonce[0] & MASKN(c->cfg->ww);
+    c->ctr[1]   = nonce[1] & MASKN(c->cfg->ww);
+    SimonCtrAdd(c->cfg, c->ctr, ctr);
+    c->ks_used  = 2*c->cfg->ww/8;
+    return 0;
+}
+
+// Encrypts n counter blocks into ks_u8 (n*block bytes), advancing the counter
+static void SimonCtrKeystream(simon_ctr_t* c, u8 ks_u8[], int n)
+{
+    const simon_gen_cfg_t* cfg = c->cfg;
+    const int wbytes = cfg->ww/8;
+    if (cfg->ww == 32) {
+        u32 blk[2*SIMON_CTR_BATCH];
+        for (int b=0; b<n; b++) {
+            blk[2*b]   = (u32)c->ctr[0];
+            blk[2*b+1] = (u32)c->ctr[1];
+            SimonCtrAdd(cfg, c->ctr, 1);
+        }
+        SimonEncryptBlocks32(blk, blk, c->rk32, cfg->n_rounds, n);
+        Words32ToBytes(blk, ks_u8, 2*n);
+    } else {
+        u64 blk[2*SIMON_CTR_BATCH];
+        for (int b=0; b<n; b++) {
+            blk[2*b]   = c->ctr[0];
+            blk[2*b+1] = c->ctr[1];
+            SimonCtrAdd(cfg, c->ctr, 1);
+        }
+        if (cfg->ww == 64)
+            SimonEncryptBlocks64(blk, blk, c->rk, cfg->n_rounds, n);
+        else
+            SimonEncryptBlocksN(blk, blk, c->rk, cfg->n_rounds, cfg->ww, n);
+        WordsNToBytes(blk, ks_u8, 2*n, wbytes);
+    }
+}
+
+/**
+ * @brief XORs len bytes of keystream into buf, in place, continuing the stream of previous calls
+ */
+void SimonCtrXor(simon_ctr_t* c, u8 buf[], size_t len)
+{
+    const int   blk_b = 2*c->cfg->ww/8;
+    u8          ks[SIMON_CTR_BATCH*16];
+    size_t      pos = 0;
+
+    // -- 1. Rest of the current block ---------------------------------------------------------- //
+    while ((pos < len) && (c->ks_used < blk_b))
+        buf[pos++] ^= c->ks[c->ks_used++];
+
+    // -- 2. Full batches & blocks -------------------------------------------------------------- //
+    while (len - pos >= (size_t)blk_b) {
+        size_t  n_blk = (len - pos) / blk_b;
+        int     n     = n_blk < SIMON_CTR_BATCH ? (int)n_blk : SIMON_CTR_BATCH;
+        size_t  n_b   = (size_t)n * blk_b;
+        SimonCtrKeystream(c, ks, n);
+        size_t  i = 0;
+        for (; i+8<=n_b; i+=8) {
+            u64 d, k;
+            memcpy(&d, &buf[pos+i], 8);
+            memcpy(&k, &ks[i], 8);
+            d ^= k;
+            memcpy(&buf[pos+i], &d, 8);
+        }
+        for (; i<n_b; i++)
+            buf[pos+i] ^= ks[i];
+        pos += n_b;
+    }
+
+    // -- 3. Partial last block: keep its keystream for the next call --------------------------- //
+    if (pos < len) {
+        SimonCtrKeystream(c, c->ks, 1);
+        c->ks_used = 0;
+        while (pos < len)
+            buf[pos++] ^= c->ks[c->ks_used++];
+    }
+}
+
+#endif // SIMON_CTR_H
@@ -0,0 +1,335 @@
+/**
+ * @author Anastasios Psarras (a.psarras4225@gmail.com)
+ *
+ * @license MIT license, check license.md
+ *
+ * @brief Standalone high-throughput Simon golden-vector generator (no simulator needed)
+ *        Generates random or counter-based plaintext/key streams, runs them through the C Simon kernels on all cores and
+ *        writes known-answer records in the binary format of simon_vec.h, through a shared memory-mapped output file.
+ *        Records are grouped by key (-r records per key), so that each group runs through the multi-block engine
+ *        (simon_simd.h) with a single key expansion. The output only depends on the arguments, not on the number of threads.
+ *
+ *        Build:    gcc -O3 -pthread -o simon_gen tb-c/simon_gen.c
+ *        Usage:    simon_gen -c <block>/<key> [-n records] [-m enc|dec|mix] [-p random|counter] [-k random|counter]
+ *                            [-r records_per_key] [-t threads] [-s seed] [-o file]
+ *
+ * @param -c        Simon configuration, e.g. 64/96 (any of the ten configurations)
+ * @param -n        Number of records to generate (default: 1M)
+ * @param -m        enc, dec or mix (mode chosen randomly per key group) (default: enc)
+ * @param -p        Input text stream: random, or counter (text = record index) (default: random)
+ * @param -k        Key stream: random, or counter (key = key group index) (default: random)
+ * @param -r        Records per key (default: 1024)
+ * @param -t        Number of worker threads (default: number of online cores)
+ * @param -s        Seed of the random streams (default: 1)
+ * @param -o        Output file -- if omitted, records are generated but not stored (throughput measurement)
+ *
+ */
+
+#include "stdint.h"
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include "time.h"
+#include "fcntl.h"
+#include "unistd.h"
+#include "pthread.h"
+#include "sys/mman.h"
+
+#include "definitions.h"
+#include "functions.h"
+#include "simon64.h"
+#include "simon128.h"
+#include "simon_generic.h"
+#include "simon_simd.h"
+#include "simon_vec.h"
+
+#define GEN_STREAM_RANDOM   0
+#define GEN_STREAM_COUNTER  1
+#define GEN_MODE_MIX        2
+#define GEN_GROUPS_PER_GRAB 16      // key groups a worker takes from the shared work counter at once
+
+// -- Global Config ----------------------------------------------------------------------------- //
+typedef struct {
+    const simon_gen_cfg_t*  cfg;
+    u64                     n_records;
+    int                     mode;
+    int                     pt_stream;
+    int                     key_stream;
+    int                     records_per_key;
+    int                     n_threads;
+    u64                     seed;
+    u8*                     out;            // first record in the output mapping, NULL if not stored
+    u64                     n_groups;
+    u64                     next_group;     // shared work counter
+} gen_ctx_t;
+
+typedef struct {
+    gen_ctx_t*  ctx;
+    int         id;
+    u64         records_done;
+    double      busy_sec;
+} gen_worker_t;
+
+// -- Helpers ----------------------------------------------------------------------------------- //
+static double now_sec()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// splitmix64: every key group gets its own stream, so that the output doesn't depend on the thread schedule
+static u64 splitmix64(u64* state)
+{
+    u64 z = (*state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+// Expands the key into rk (u64 words), using the NSA key schedules where available
+static void expand_key(const simon_gen_cfg_t* cfg, u64 key[], u64 rk[])
+{
+    if (cfg->ww == 32) {
+        u32 k32[4];
+        u32 rk32[N_ROUNDS__64_128];
+        for (int i=0; i<cfg->nkw; i++)
+            k32[i] = (u32)key[i];
+        if (cfg->nkw == 3)
+            Simon6496KeySchedule(k32, rk32);
+        else
+            Simon64128KeySchedule(k32, rk32);
+        for (int i=0; i<cfg->n_rounds; i++)
+            rk[i] = rk32[i];
+    } else if (cfg->ww == 64) {
+        if (cfg->nkw == 2)
+            Simon128128KeySchedule(key, rk);
+        else if (cfg->nkw == 3)
+            Simon128192KeySchedule(key, rk);
+        else
+            Simon128256KeySchedule(key, rk);
+    } else {
+        cfg->KeySchedule(key, rk);
+    }
+}
+
+// Runs n blocks (u64 words) through the multi-block engine
+static void run_blocks(const simon_gen_cfg_t* cfg, int mode, u64 rk[], u64 in[], u64 out[], u32 tmp_in[], u32 tmp_out[], u32 rk32[], int n)
+{
+    if (cfg->ww == 32) {
+        for (int i=0; i<cfg->n_rounds; i++)
+            rk32[i] = (u32)rk[i];
+        for (int i=0; i<2*n; i++)
+            tmp_in[i] = (u32)in[i];
+        if (mode == MODE_ENC)
+            SimonEncryptBlocks32(tmp_in, tmp_out, rk32, cfg->n_rounds, n);
+        else
+            SimonDecryptBlocks32(tmp_out, tmp_in, rk32, cfg->n_rounds, n);
+        for (int i=0; i<2*n; i++)
+            out[i] = tmp_out[i];
+    } else if (cfg->ww == 64) {
+        if (mode == MODE_ENC)
+            SimonEncryptBlocks64(in, out, rk, cfg->n_rounds, n);
+        else
+            SimonDecryptBlocks64(out, in, rk, cfg->n_rounds, n);
+    } else {
+        if (mode == MODE_ENC)
+            SimonEncryptBlocksN(in, out, rk, cfg->n_rounds, cfg->ww, n);
+        else
+            SimonDecryptBlocksN(out, in, rk, cfg->n_rounds, cfg->ww, n);
+    }
+}
+
+// -- Worker ------------------------------------------------------------------------------------ //
+static void* gen_worker(void* arg)
+{
+    gen_worker_t*           w       = (gen_worker_t*)arg;
+    gen_ctx_t*              ctx     = w->ctx;
+    const simon_gen_cfg_t*  cfg     = ctx->cfg;
+    const int               ww      = cfg->ww;
+    const int               txt_b   = 2*ww/8;
+    const int               key_b   = cfg->nkw*ww/8;
+    const int               rec_b   = SimonVecRecordSize(ww, cfg->nkw);
+    const u64               mask    = MASKN(ww);
+    const int               rpk     = ctx->records_per_key;
+
+    u64* in      = (u64*)malloc(2*rpk*sizeof(u64));
+    u64* out     = (u64*)malloc(2*rpk*sizeof(u64));
+    u32* tmp_in  = (u32*)malloc(2*rpk*sizeof(u32));
+    u32* tmp_out = (u32*)malloc(2*rpk*sizeof(u32));
+    u8*  scratch = ctx->out ? NULL : (u8*)malloc((size_t)rpk*rec_b);
+    u32  rk32[N_ROUNDS__128_256];
+    u64  rk[N_ROUNDS__128_256];
+    u64  key[4];
+    u8   key_u8[32];
+
+    double t_start = now_sec();
+    for (;;) {
+        u64 g0 = __atomic_fetch_add(&ctx->next_group, GEN_GROUPS_PER_GRAB, __ATOMIC_RELAXED);
+        if (g0 >= ctx->n_groups)
+            break;
+
+        for (u64 g=g0; (g<g0+GEN_GROUPS_PER_GRAB) && (g<ctx->n_groups); g++) {
+            u64 rng     = ctx->seed ^ (g * 0xd1b54a32d192ed03ULL);
+            u64 first   = g * rpk;
+            int n       = (first + rpk <= ctx->n_records) ? rpk : (int)(ctx->n_records - first);
+            int mode    = ctx->mode == GEN_MODE_MIX ? (int)(splitmix64(&rng) & 1) : ctx->mode;
+            u8* rec     = ctx->out ? &ctx->out[first * rec_b] : scratch;
+
+            // -- 1. Key ------------------------------------------------------------------------ //
+            for (int i=0; i<cfg->nkw; i++) {
+                if (ctx->key_stream == GEN_STREAM_COUNTER)
+                    key[i] = (i == 0) ? (g & mask) : (ww < 64 && i == 1) ? ((g >> ww) & mask) : 0;
+                else
+                    key[i] = splitmix64(&rng) & mask;
+            }
+            expand_key(cfg, key, rk);
+            WordsNToBytes(key, key_u8, cfg->nkw, ww/8);
+
+            // -- 2. Input Texts ---------------------------------------------------------------- //
+            for (int b=0; b<n; b++) {
+                if (ctx->pt_stream == GEN_STREAM_COUNTER) {
+                    u64 idx = first + b;
+                    in[2*b]   = idx & mask;
+                    in[2*b+1] = ww < 64 ? ((idx >> ww) & mask) : 0;
+                } else {
+                    in[2*b]   = splitmix64(&rng) & mask;
+                    in[2*b+1] = splitmix64(&rng) & mask;
+                }
+            }
+
+            // -- 3. Enc/Decryption ------------------------------------------------------------- //
+            run_blocks(cfg, mode, rk, in, out, tmp_in, tmp_out, rk32, n);
+
+            // -- 4. Records -------------------------------------------------------------------- //
+            for (int b=0; b<n; b++) {
+                u8* r = &rec[(size_t)b * rec_b];
+                r[0] = (u8)mode;
+                WordsNToBytes(&in[2*b], &r[1], 2, ww/8);
+                memcpy(&r[1+txt_b], key_u8, key_b);
+                WordsNToBytes(&out[2*b], &r[1+txt_b+key_b], 2, ww/8);
+            }
+            w->records_done += n;
+        }
+    }
+    w->busy_sec = now_sec() - t_start;
+
+    free(in);
+    free(out);
+    free(tmp_in);
+    free(tmp_out);
+    free(scratch);
+    return NULL;
+}
+
+// -- Main -------------------------------------------------------------------------------------- //
+static void usage(const char* prog)
+{
+    fprintf(stderr, "Usage: %s -c <block>/<key> [-n records] [-m enc|dec|mix] [-p random|counter] [-k random|counter]\n"
+                    "          [-r records_per_key] [-t threads] [-s seed] [-o file]\n", prog);
+}
+
+static int parse_stream(const char* s)
+{
+    return strcmp(s, "counter") == 0 ? GEN_STREAM_COUNTER : GEN_STREAM_RANDOM;
+}
+
+int main(int argc, char* argv[])
+{
+    gen_ctx_t   ctx;
+    const char* out_path = NULL;
+    int         sz_txt = 0, sz_key = 0;
+    int         opt;
+
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.n_records       = 1000000;
+    ctx.mode            = MODE_ENC;
+    ctx.pt_stream       = GEN_STREAM_RANDOM;
+    ctx.key_stream      = GEN_STREAM_RANDOM;
+    ctx.records_per_key = 1024;
+    ctx.n_threads       = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    ctx.seed            = 1;
+
+    while ((opt = getopt(argc, argv, "c:n:m:p:k:r:t:s:o:h")) != -1) {
+        switch (opt) {
+            case 'c': sscanf(optarg, "%d/%d", &sz_txt, &sz_key); break;
+            case 'n': ctx.n_records = strtoull(optarg, NULL, 0); break;
+            case 'm': ctx.mode = strcmp(optarg, "dec") == 0 ? MODE_DEC : strcmp(optarg, "mix") == 0 ? GEN_MODE_MIX : MODE_ENC; break;
+            case 'p': ctx.pt_stream = parse_stream(optarg); break;
+            case 'k': ctx.key_stream = parse_stream(optarg); break;
+            case 'r': ctx.records_per_key = atoi(optarg); break;
+            case 't': ctx.n_threads = atoi(optarg); break;
+            case 's': ctx.seed = strtoull(optarg, NULL, 0); break;
+            case 'o': out_path = optarg; break;
+            default:  usage(argv[0]); return 1;
+        }
+    }
+
+    ctx.cfg = SimonGenConfig(sz_txt, sz_key);
+    if (ctx.cfg == NULL) {
+        fprintf(stderr, "[simon_gen] *** FAILURE *** I dont know how to run Simon%0d/%0d\n", sz_txt, sz_key);
+        usage(argv[0]);
+        return 1;
+    }
+    if (ctx.records_per_key < 1)
+        ctx.records_per_key = 1;
+    if (ctx.n_threads < 1)
+        ctx.n_threads = 1;
+    ctx.n_groups = (ctx.n_records + ctx.records_per_key - 1) / ctx.records_per_key;
+
+    // -- Output file: header + records, memory-mapped -------------------------------------------- //
+    int     fd      = -1;
+    u8*     map     = NULL;
+    size_t  map_sz  = sizeof(simon_vec_header_t) + (size_t)ctx.n_records * SimonVecRecordSize(ctx.cfg->ww, ctx.cfg->nkw);
+    if (out_path) {
+        simon_vec_header_t hdr;
+        fd = open(out_path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if ((fd < 0) || (ftruncate(fd, map_sz) != 0)) {
+            perror("[simon_gen] *** FAILURE *** cannot create output file");
+            return 1;
+        }
+        map = (u8*)mmap(NULL, map_sz, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (map == MAP_FAILED) {
+            perror("[simon_gen] *** FAILURE *** cannot map output file");
+            return 1;
+        }
+        SimonVecInitHeader(&hdr, ctx.cfg->ww, ctx.cfg->nkw, ctx.n_records);
+        memcpy(map, &hdr, sizeof(hdr));
+        ctx.out = map + sizeof(hdr);
+    }
+
+    // -- Run workers ----------------------------------------------------------------------------- //
+    pthread_t*      threads = (pthread_t*)malloc(ctx.n_threads * sizeof(pthread_t));
+    gen_worker_t*   workers = (gen_worker_t*)calloc(ctx.n_threads, sizeof(gen_worker_t));
+    double          t_start = now_sec();
+    for (int i=0; i<ctx.n_threads; i++) {
+        workers[i].ctx = &ctx;
+        workers[i].id  = i;
+        pthread_create(&threads[i], NULL, gen_worker, &workers[i]);
+    }
+    for (int i=0; i<ctx.n_threads; i++)
+        pthread_join(threads[i], NULL);
+    double t_wall = now_sec() - t_start;
+
+    if (map) {
+        msync(map, map_sz, MS_SYNC);
+        munmap(map, map_sz);
+        close(fd);
+    }
+
+    // -- Report ---------------------------------------------------------------------------------- //
+    printf("[simon_gen] *** INFO *** Simon%0d/%0d, %llu records, %0d records/key, %0d threads, engine: %s\n",
+           sz_txt, sz_key, (unsigned long long)ctx.n_records, ctx.records_per_key, ctx.n_threads, SimonSimdIsa());
+    for (int i=0; i<ctx.n_threads; i++) {
+        printf("[simon_gen] *** INFO ***   thread %2d: %12llu blocks in %8.3f s -- %10.3f Mblocks/s\n", i,
+               (unsigned long long)workers[i].records_done, workers[i].busy_sec,
+               workers[i].busy_sec > 0 ? workers[i].records_done / workers[i].busy_sec * 1e-6 : 0.0);
+    }
+    printf("[simon_gen] *** INFO *** overall: %.3f s -- %.3f Mblocks/s (%.3f Mblocks/s per core)%s%s\n",
+           t_wall, ctx.n_records / t_wall * 1e-6, ctx.n_records / t_wall * 1e-6 / ctx.n_threads,
+           out_path ? ", written to " : "", out_path ? out_path : "");
+
+    free(threads);
+    free(workers);
+    return 0;
+}
@@ -0,0 +1,164 @@
+/**
+ * @author Anastasios Psarras (a.psarras4225@gmail.com)
+ *
+ * @license MIT license, check license.md
+ *
+ * @brief Generic Simon kernel covering all ten Simon configurations [ref]
+ *        [ref] R. Beaulieu, D. Shors, J. Smith, S. Treatman-Clark, B. Weeks, L. Wingers, "The Simon and Speck Families of Lightweight Block Ciphers", DAC 2015
+ *        One kernel is generated per configuration by SIMON_GEN_KERNEL(), with the word size n, number of key words m,
+ *        number of rounds T and z sequence as compile-time constants, so every loop has a constant trip count and is fully
+ *        unrolled. Words are held in u64 for all configurations; n < 64 uses masked rotations (ROTLN/ROTRN).
+ *        Argument conventions follow the NSA Implementation Guide: Encrypt(Pt, Ct, rk) / Decrypt(Pt, Ct, rk),
+ *        word 0 is the least significant word of the block (and key).
+ *
+ */
+
+#ifndef SIMON_GENERIC_H
+#define SIMON_GENERIC_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "definitions.h"
+
+// z sequences, bit i = z_j[i] (period 62)
+#define SIMON_Z0 0x19c3522fb386a45fULL
+#define SIMON_Z1 0x16864fb8ad0c9f71ULL
+#define SIMON_Z2 0x3369f885192c0ef5ULL
+#define SIMON_Z3 0x3c2ce51207a635dbULL
+#define SIMON_Z4 0x3dc94c3a046d678bULL
+
+#define MASKN(n)        ((n) == 64 ? ~0ULL : ((1ULL << (n)) - 1))
+#define ROTLN(x,r,n)    ((((x) << (r)) | ((x) >> ((n)-(r)))) & MASKN(n))
+#define ROTRN(x,r,n)    ((((x) >> (r)) | ((x) << ((n)-(r)))) & MASKN(n))
+#define fN(x,n)         ((ROTLN(x,1,n) & ROTLN(x,8,n)) ^ ROTLN(x,2,n))
+
+#if defined(__clang__)
+#define SIMON_UNROLL _Pragma("unroll")
+#elif defined(__GNUC__)
+#define SIMON_UNROLL _Pragma("GCC unroll 128")
+#else
+#define SIMON_UNROLL
+#endif
+
+#define SIMON_GEN_KERNEL(NAME, N, M, T, Z)                                          \
+void SimonG##NAME##KeySchedule(u64 K[], u64 rk[])                                   \
+{                                                                                   \
+    const u64 c = MASKN(N) ^ 3;                                                     \
+    int i;                                                                          \
+    for (i=0; i<(M); i++) rk[i] = K[i] & MASKN(N);                                  \
+    SIMON_UNROLL                                                                    \
+    for (i=(M); i<(T); i++) {                                                       \
+        u64 tmp = ROTRN(rk[i-1], 3, N);                                             \
+        if ((M) == 4) tmp ^= rk[i-3];                                               \
+        tmp ^= ROTRN(tmp, 1, N);                                                    \
+        rk[i] = c ^ (((Z) >> ((i-(M)) % 62)) & 1) ^ rk[i-(M)] ^ tmp;                \
+    }                                                                               \
+}                                                                                   \
+                                                                                    \
+void SimonG##NAME##Encrypt(u64 Pt[], u64 Ct[], u64 rk[])                            \
+{                                                                                   \
+    u64 x = Pt[1] & MASKN(N), y = Pt[0] & MASKN(N), t;                              \
+    SIMON_UNROLL                                                                    \
+    for (int i=0; i<(T); i++) {                                                     \
+        t = x; x = y ^ fN(x, N) ^ rk[i]; y = t;                                     \
+    }                                                                               \
+    Ct[1] = x; Ct[0] = y;                                                           \
+}                                                                                   \
+                                                                                    \
+void SimonG##NAME##Decrypt(u64 Pt[], u64 Ct[], u64 rk[])                            \
+{                                                                                   \
+    u64 x = Ct[0] & MASKN(N), y = Ct[1] & MASKN(N), t;                              \
+    SIMON_UNROLL                                                                    \
+    for (int i=(T)-1; i>=0; i--) {                                                  \
+        t = x; x = y ^ fN(x, N) ^ rk[i]; y = t;                                     \
+    }                                                                               \
+    Pt[0] = x; Pt[1] = y;                                                           \
+}
+
+SIMON_GEN_KERNEL(3264,    16, 4, N_ROUNDS__32_64,   SIMON_Z0)
+SIMON_GEN_KERNEL(4872,    24, 3, N_ROUNDS__48_72,   SIMON_Z0)
+SIMON_GEN_KERNEL(4896,    24, 4, N_ROUNDS__48_96,   SIMON_Z1)
+SIMON_GEN_KERNEL(6496,    32, 3, N_ROUNDS__64_96,   SIMON_Z2)
+SIMON_GEN_KERNEL(64128,   32, 4, N_ROUNDS__64_128,  SIMON_Z3)
+SIMON_GEN_KERNEL(9696,    48, 2, N_ROUNDS__96_96,   SIMON_Z2)
+SIMON_GEN_KERNEL(96144,   48, 3, N_ROUNDS__96_144,  SIMON_Z3)
+SIMON_GEN_KERNEL(128128,  64, 2, N_ROUNDS__128_128, SIMON_Z2)
+SIMON_GEN_KERNEL(128192,  64, 3, N_ROUNDS__128_192, SIMON_Z3)
+SIMON_GEN_KERNEL(128256,  64, 4, N_ROUNDS__128_256, SIMON_Z4)
+
+// -- Configuration Table ----------------------------------------------------------------------- //
+typedef struct {
+    int     ww;         // word size n
+    int     nkw;        // number of key words m
+    int     n_rounds;   // number of rounds T
+    void    (*KeySchedule)(u64 K[], u64 rk[]);
+    void    (*Encrypt)(u64 Pt[], u64 Ct[], u64 rk[]);
+    void    (*Decrypt)(u64 Pt[], u64 Ct[], u64 rk[]);
+} simon_gen_cfg_t;
+
+#define SIMON_GEN_N_CFGS 10
+
+const simon_gen_cfg_t simon_gen_cfgs[SIMON_GEN_N_CFGS] = {
+    {16, 4, N_ROUNDS__32_64,   SimonG3264KeySchedule,   SimonG3264Encrypt,   SimonG3264Decrypt  },
+    {24, 3, N_ROUNDS__48_72,   SimonG4872KeySchedule,   SimonG4872Encrypt,   SimonG4872Decrypt  },
+    {24, 4, N_ROUNDS__48_96,   SimonG4896KeySchedule,   SimonG4896Encrypt,   SimonG4896Decrypt  },
+    {32, 3, N_ROUNDS__64_96,   SimonG6496KeySchedule,   SimonG6496Encrypt,   SimonG6496Decrypt  },
+    {32, 4, N_ROUNDS__64_128,  SimonG64128KeySchedule,  SimonG64128Encrypt,  SimonG64128Decrypt },
+    {48, 2, N_ROUNDS__96_96,   SimonG9696KeySchedule,   SimonG9696Encrypt,   SimonG9696Decrypt  },
+    {48, 3, N_ROUNDS__96_144,  SimonG96144KeySchedule,  SimonG96144Encrypt,  SimonG96144Decrypt },
+    {64, 2, N_ROUNDS__128_128, SimonG128128KeySchedule, SimonG128128Encrypt, SimonG128128Decrypt},
+    {64, 3, N_ROUNDS__128_192, SimonG128192KeySchedule, SimonG128192Encrypt, SimonG128192Decrypt},
+    {64, 4, N_ROUNDS__128_256, SimonG128256KeySchedule, SimonG128256Encrypt, SimonG128256Decrypt}
+};
+
+// Returns the configuration for Simon<sz_txt>/<sz_key> (sizes in bits), NULL if there's no such configuration
+const simon_gen_cfg_t* SimonGenConfig(int sz_txt, int sz_key)
+{
+    for (int i=0; i<SIMON_GEN_N_CFGS; i++)
+        if ((2*simon_gen_cfgs[i].ww == sz_txt) && (simon_gen_cfgs[i].nkw*simon_gen_cfgs[i].ww == sz_key))
+            return &simon_gen_cfgs[i];
+    return NULL;
+}
+
+// -- Self Test --------------------------------------------------------------------------------- //
+// Test vectors of [ref], Appendix B (words listed least significant first)
+typedef struct {
+    int ww;
+    int nkw;
+    u64 key[4];
+    u64 pt[2];
+    u64 ct[2];
+} simon_gen_kat_t;
+
+const simon_gen_kat_t simon_gen_kats[SIMON_GEN_N_CFGS] = {
+    {16, 4, {0x0100, 0x0908, 0x1110, 0x1918}, {0x6877, 0x6565}, {0xe9bb, 0xc69b}},
+    {24, 3, {0x020100, 0x0a0908, 0x121110}, {0x6e696c, 0x612067}, {0x292cac, 0xdae5ac}},
+    {24, 4, {0x020100, 0x0a0908, 0x121110, 0x1a1918}, {0x20646e, 0x726963}, {0xacf156, 0x6e06a5}},
+    {32, 3, {0x03020100, 0x0b0a0908, 0x13121110}, {0x6e696c63, 0x6f722067}, {0x111a8fc8, 0x5ca2e27f}},
+    {32, 4, {0x03020100, 0x0b0a0908, 0x13121110, 0x1b1a1918}, {0x20646e75, 0x656b696c}, {0xb9dfa07a, 0x44c8fc20}},
+    {48, 2, {0x050403020100ULL, 0x0d0c0b0a0908ULL}, {0x702065687420ULL, 0x2072616c6c69ULL}, {0x69063d8ff082ULL, 0x602807a462b4ULL}},
+    {48, 3, {0x050403020100ULL, 0x0d0c0b0a0908ULL, 0x151413121110ULL}, {0x73756420666fULL, 0x746168742074ULL}, {0x3f59c5db1ae9ULL, 0xecad1c6c451eULL}},
+    {64, 2, {0x0706050403020100ULL, 0x0f0e0d0c0b0a0908ULL}, {0x6c6c657661727420ULL, 0x6373656420737265ULL}, {0x65aa832af84e0bbcULL, 0x49681b1e1e54fe3fULL}},
+    {64, 3, {0x0706050403020100ULL, 0x0f0e0d0c0b0a0908ULL, 0x1716151413121110ULL}, {0x6568772065626972ULL, 0x206572656874206eULL}, {0x6c9c8d6e2597b85bULL, 0xc4ac61effcdc0d4fULL}},
+    {64, 4, {0x0706050403020100ULL, 0x0f0e0d0c0b0a0908ULL, 0x1716151413121110ULL, 0x1f1e1d1c1b1a1918ULL}, {0x6d69732061207369ULL, 0x74206e69206d6f6fULL}, {0x3bf72a87efe7b868ULL, 0x8d2b5579afc8a3a0ULL}}
+};
+
+// Runs every test vector in both directions -- returns the number of failing configurations
+int SimonGenSelfTest()
+{
+    int n_failed = 0;
+    for (int i=0; i<SIMON_GEN_N_CFGS; i++) {
+        const simon_gen_kat_t* kat = &simon_gen_kats[i];
+        const simon_gen_cfg_t* cfg = SimonGenConfig(2*kat->ww, kat->nkw*kat->ww);
+        u64 rk[N_ROUNDS__128_256];
+        u64 ct[2], pt[2];
+        cfg->KeySchedule((u64*)kat->key, rk);
+        cfg->Encrypt((u64*)kat->pt, ct, rk);
+        cfg->Decrypt(pt, (u64*)kat->ct, rk);
+        if ((ct[0] != kat->ct[0]) || (ct[1] != kat->ct[1]) || (pt[0] != kat->pt[0]) || (pt[1] != kat->pt[1]))
+            n_failed++;
+    }
+    return n_failed;
+}
+
+#endif // SIMON_GENERIC_H
@@ -0,0 +1,239 @@
+/**
+ * @author Anastasios Psarras (a.psarras4225@gmail.com)
+ *
+ * @license MIT license, check license.md
+ *
+ * @brief Multi-block Simon engine: encrypts/decrypts many independent blocks per call, sharing the same round keys
+ *        Blocks are processed SIMON_SIMD_LANES32 (n=32) or SIMON_SIMD_LANES64 (any other n) at a time, one block per vector lane,
+ *        using GCC/Clang vector extensions. On x86-64 the chunk kernels are cloned for AVX-512/AVX2/SSE2 and the best
+ *        one is picked at load time (runtime CPU dispatch); on AArch64 the same code compiles to NEON.
+ *        Compilers without vector extensions fall back to the scalar single-block kernels.
+ *
+ *        Block layout follows the NSA Implementation Guide: block i is Pt[2*i] (word 0) & Pt[2*i+1] (word 1).
+ *        rk[] is the output of the respective Simon*KeySchedule(), n_rounds the config's number of rounds.
+ *        Pt and Ct may point to the same buffer (in-place operation).
+ *
+ */
+
+#ifndef SIMON_SIMD_H
+#define SIMON_SIMD_H
+
+#include "definitions.h"
+
+#define SIMON_SIMD_BYTES    64                          // vector size: 512 bits
+#define SIMON_SIMD_LANES32  (SIMON_SIMD_BYTES/4)        // 16 blocks of Simon64/*
+#define SIMON_SIMD_LANES64  (SIMON_SIMD_BYTES/8)        //  8 blocks of Simon128/*
+
+#if defined(__GNUC__) && defined(__x86_64__) && defined(__ELF__)
+#define SIMON_SIMD_DISPATCH __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+#define SIMON_SIMD_DISPATCH
+#endif
+
+// Selected instruction set (informative, e.g. for benchmarks)
+const char* SimonSimdIsa()
+{
+#if defined(__GNUC__) && defined(__x86_64__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+        return "avx512f";
+    if (__builtin_cpu_supports("avx2"))
+        return "avx2";
+    return "sse2";
+#elif defined(__GNUC__) && defined(__aarch64__)
+    return "neon";
+#elif defined(__GNUC__)
+    return "generic-vector";
+#else
+    return "scalar";
+#endif
+}
+
+#if defined(__GNUC__)
+// -- Vector Kernels ---------------------------------------------------------------------------- //
+typedef u32 v32_t __attribute__((vector_size(SIMON_SIMD_BYTES)));
+typedef u64 v64_t __attribute__((vector_size(SIMON_SIMD_BYTES)));
+
+#define VROTL32(x,r) (((x)<<(r)) | ((x)>>(32-(r))))
+#define VROTL64(x,r) (((x)<<(r)) | ((x)>>(64-(r))))
+#define vf32(x) ((VROTL32(x,1) & VROTL32(x,8)) ^ VROTL32(x,2))
+#define vf64(x) ((VROTL64(x,1) & VROTL64(x,8)) ^ VROTL64(x,2))
+
+// One chunk of SIMON_SIMD_LANES32 blocks -- enc: rounds 0..n_rounds-1, dec: rounds n_rounds-1..0
+SIMON_SIMD_DISPATCH
+void SimonChunk32(u32 In[], u32 Out[], u32 rk[], int n_rounds, int decrypt)
+{
+    v32_t a, b, t;
+    int i, l;
+    // enc: a = word 1, b = word 0 / dec: a = word 0, b = word 1
+    for (l=0; l<SIMON_SIMD_LANES32; l++) {
+        a[l] = In[2*l + !decrypt];
+        b[l] = In[2*l +  decrypt];
+    }
+    if (!decrypt) {
+        for (i=0; i<n_rounds; i++) {
+            t = a; a = b ^ vf32(a) ^ rk[i]; b = t;
+        }
+    } else {
+        for (i=n_rounds-1; i>=0; i--) {
+            t = a; a = b ^ vf32(a) ^ rk[i]; b = t;
+        }
+    }
+    for (l=0; l<SIMON_SIMD_LANES32; l++) {
+        Out[2*l + !decrypt] = a[l];
+        Out[2*l +  decrypt] = b[l];
+    }
+}
+
+SIMON_SIMD_DISPATCH
+void SimonChunk64(u64 In[], u64 Out[], u64 rk[], int n_rounds, int decrypt)
+{
+    v64_t a, b, t;
+    int i, l;
+    for (l=0; l<SIMON_SIMD_LANES64; l++) {
+        a[l] = In[2*l + !decrypt];
+        b[l] = In[2*l +  decrypt];
+    }
+    if (!decrypt) {
+        for (i=0; i<n_rounds; i++) {
+            t = a; a = b ^ vf64(a) ^ rk[i]; b = t;
+        }
+    } else {
+        for (i=n_rounds-1; i>=0; i--) {
+            t = a; a = b ^ vf64(a) ^ rk[i]; b = t;
+        }
+    }
+    for (l=0; l<SIMON_SIMD_LANES64; l++) {
+        Out[2*l + !decrypt] = a[l];
+        Out[2*l +  decrypt] = b[l];
+    }
+}
+
+// Any word size n (16, 24, 48 etc) held in 64-bit lanes, masked rotations
+SIMON_SIMD_DISPATCH
+void SimonChunkN(u64 In[], u64 Out[], u64 rk[], int n_rounds, int ww, int decrypt)
+{
+    const u64 mask = ww == 64 ? ~0ULL : ((1ULL << ww) - 1);
+    v64_t a, b, t;
+    int i, l;
+#define VROTLN(x,r) ((((x)<<(r)) | ((x)>>(ww-(r)))) & mask)
+#define vfN(x) ((VROTLN(x,1) & VROTLN(x,8)) ^ VROTLN(x,2))
+    for (l=0; l<SIMON_SIMD_LANES64; l++) {
+        a[l] = In[2*l + !decrypt] & mask;
+        b[l] = In[2*l +  decrypt] & mask;
+    }
+    if (!decrypt) {
+        for (i=0; i<n_rounds; i++) {
+            t = a; a = b ^ vfN(a) ^ rk[i]; b = t;
+        }
+    } else {
+        for (i=n_rounds-1; i>=0; i--) {
+            t = a; a = b ^ vfN(a) ^ rk[i]; b = t;
+        }
+    }
+#undef VROTLN
+#undef vfN
+    for (l=0; l<SIMON_SIMD_LANES64; l++) {
+        Out[2*l + !decrypt] = a[l];
+        Out[2*l +  decrypt] = b[l];
+    }
+}
+#else
+// -- Scalar Fallback --------------------------------------------------------------------------- //
+#define sf32(x) ((ROTL32(x,1) & ROTL32(x,8)) ^ ROTL32(x,2))
+#define sf64(x) ((ROTL64(x,1) & ROTL64(x,8)) ^ ROTL64(x,2))
+
+void SimonChunk32(u32 In[], u32 Out[], u32 rk[], int n_rounds, int decrypt)
+{
+    for (int l=0; l<SIMON_SIMD_LANES32; l++) {
+        u32 a = In[2*l + !decrypt], b = In[2*l + decrypt], t;
+        for (int r=0; r<n_rounds; r++) {
+            t = a; a = b ^ sf32(a) ^ rk[decrypt ? n_rounds-1-r : r]; b = t;
+        }
+        Out[2*l + !decrypt] = a; Out[2*l + decrypt] = b;
+    }
+}
+
+void SimonChunk64(u64 In[], u64 Out[], u64 rk[], int n_rounds, int decrypt)
+{
+    for (int l=0; l<SIMON_SIMD_LANES64; l++) {
+        u64 a = In[2*l + !decrypt], b = In[2*l + decrypt], t;
+        for (int r=0; r<n_rounds; r++) {
+            t = a; a = b ^ sf64(a) ^ rk[decrypt ? n_rounds-1-r : r]; b = t;
+        }
+        Out[2*l + !decrypt] = a; Out[2*l + decrypt] = b;
+    }
+}
+
+void SimonChunkN(u64 In[], u64 Out[], u64 rk[], int n_rounds, int ww, int decrypt)
+{
+    const u64 mask = ww == 64 ? ~0ULL : ((1ULL << ww) - 1);
+#define SROTLN(x,r) ((((x)<<(r)) | ((x)>>(ww-(r)))) & mask)
+    for (int l=0; l<SIMON_SIMD_LANES64; l++) {
+        u64 a = In[2*l + !decrypt] & mask, b = In[2*l + decrypt] & mask, t;
+        for (int r=0; r<n_rounds; r++) {
+            t = a; a = b ^ ((SROTLN(a,1) & SROTLN(a,8)) ^ SROTLN(a,2)) ^ rk[decrypt ? n_rounds-1-r : r]; b = t;
+        }
+        Out[2*l + !decrypt] = a; Out[2*l + decrypt] = b;
+    }
+#undef SROTLN
+}
+#endif
+
+// -- Multi-block API --------------------------------------------------------------------------- //
+// Runs full chunks in place, pads the remainder into a local chunk
+void SimonBlocks32(u32 In[], u32 Out[], u32 rk[], int n_rounds, int n_blocks, int decrypt)
+{
+    int b;
+    for (b=0; b+SIMON_SIMD_LANES32<=n_blocks; b+=SIMON_SIMD_LANES32)
+        SimonChunk32(&In[2*b], &Out[2*b], rk, n_rounds, decrypt);
+    if (b < n_blocks) {
+        u32 tail[2*SIMON_SIMD_LANES32] = {0};
+        for (int i=0; i<2*(n_blocks-b); i++)
+            tail[i] = In[2*b + i];
+        SimonChunk32(tail, tail, rk, n_rounds, decrypt);
+        for (int i=0; i<2*(n_blocks-b); i++)
+            Out[2*b + i] = tail[i];
+    }
+}
+
+void SimonBlocks64(u64 In[], u64 Out[], u64 rk[], int n_rounds, int n_blocks, int decrypt)
+{
+    int b;
+    for (b=0; b+SIMON_SIMD_LANES64<=n_blocks; b+=SIMON_SIMD_LANES64)
+        SimonChunk64(&In[2*b], &Out[2*b], rk, n_rounds, decrypt);
+    if (b < n_blocks) {
+        u64 tail[2*SIMON_SIMD_LANES64] = {0};
+        for (int i=0; i<2*(n_blocks-b); i++)
+            tail[i] = In[2*b + i];
+        SimonChunk64(tail, tail, rk, n_rounds, decrypt);
+        for (int i=0; i<2*(n_blocks-b); i++)
+            Out[2*b + i] = tail[i];
+    }
+}
+
+void SimonBlocksN(u64 In[], u64 Out[], u64 rk[], int n_rounds, int ww, int n_blocks, int decrypt)
+{
+    int b;
+    for (b=0; b+SIMON_SIMD_LANES64<=n_blocks; b+=SIMON_SIMD_LANES64)
+        SimonChunkN(&In[2*b], &Out[2*b], rk, n_rounds, ww, decrypt);
+    if (b < n_blocks) {
+        u64 tail[2*SIMON_SIMD_LANES64] = {0};
+        for (int i=0; i<2*(n_blocks-b); i++)
+            tail[i] = In[2*b + i];
+        SimonChunkN(tail, tail, rk, n_rounds, ww, decrypt);
+        for (int i=0; i<2*(n_blocks-b); i++)
+            Out[2*b + i] = tail[i];
+    }
+}
+
+// Same argument order as the NSA single-block functions: Encrypt(Pt, Ct, ...) / Decrypt(Pt, Ct, ...)
+void SimonEncryptBlocks32(u32 Pt[], u32 Ct[], u32 rk[], int n_rounds, int n_blocks) { SimonBlocks32(Pt, Ct, rk, n_rounds, n_blocks, 0); }
+void SimonDecryptBlocks32(u32 Pt[], u32 Ct[], u32 rk[], int n_rounds, int n_blocks) { SimonBlocks32(Ct, Pt, rk, n_rounds, n_blocks, 1); }
+void SimonEncryptBlocks64(u64 Pt[], u64 Ct[], u64 rk[], int n_rounds, int n_blocks) { SimonBlocks64(Pt, Ct, rk, n_rounds, n_blocks, 0); }
+void SimonDecryptBlocks64(u64 Pt[], u64 Ct[], u64 rk[], int n_rounds, int n_blocks) { SimonBlocks64(Ct, Pt, rk, n_rounds, n_blocks, 1); }
+// Generic word size version, rk[] as produced by the simon_generic.h key schedules
+void SimonEncryptBlocksN(u64 Pt[], u64 Ct[], u64 rk[], int n_rounds, int ww, int n_blocks) { SimonBlocksN(Pt, Ct, rk, n_rounds, ww, n_blocks, 0); }
+void SimonDecryptBlocksN(u64 Pt[], u64 Ct[], u64 rk[], int n_rounds, int ww, int n_blocks) { SimonBlocksN(Ct, Pt, rk, n_rounds, ww, n_blocks, 1); }
+
+#endif // SIMON_SIMD_H
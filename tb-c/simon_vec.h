@@ -0,0 +1,140 @@
+/**
+ * @author Anastasios Psarras (a.psarras4225@gmail.com)
+ *
+ * @license MIT license, check license.md
+ *
+ * @brief Compact binary Simon test-vector file format
+ *        A file consists of a fixed 64-byte header followed by n_records fixed-size records:
+ *
+ *              -----------------------------------------------------------------------
+ *             | offset  | size             | field                                     |
+ *             |-----------------------------------------------------------------------|
+ *             | 0       | 1                | mode (MODE_ENC or MODE_DEC)               |
+ *             | 1       | 2*WW/8           | input text (pt on encryption, ct on dec.) |
+ *             | 1+T     | NKW*WW/8         | key                                       |
+ *             | 1+T+K   | 2*WW/8           | expected output text                      |
+ *              -----------------------------------------------------------------------
+ *
+ *        Texts & keys use the same byte order as the testbench (crypto_item): word i occupies bytes [i*WW/8, (i+1)*WW/8),
+ *        least significant byte first. All header fields are little-endian.
+ *        Files are opened read-only with mmap (SimonVecOpen), so a single file can be shared by many concurrent readers.
+ *
+ */
+
+#ifndef SIMON_VEC_H
+#define SIMON_VEC_H
+
+#include "definitions.h"
+#include "string.h"
+#include "fcntl.h"
+#include "unistd.h"
+#include "sys/mman.h"
+#include "sys/stat.h"
+
+#define SIMON_VEC_MAGIC     "SIMONVEC"
+#define SIMON_VEC_VERSION   1
+
+typedef struct {
+    char    magic[8];       // SIMON_VEC_MAGIC (not NUL-terminated)
+    u32     version;        // SIMON_VEC_VERSION
+    u32     header_size;    // sizeof(simon_vec_header_t), i.e. offset of the first record
+    u32     ww;             // word size (WW)
+    u32     nkw;            // number of key words (NKW)
+    u32     record_size;    // SimonVecRecordSize(ww, nkw)
+    u32     flags;          // reserved, 0
+    u64     n_records;      // number of records following the header
+    u8      reserved[24];
+} simon_vec_header_t;
+
+// Whether WW/NKW is one of the ten Simon 2n/mn configurations
+int SimonVecLegalConfig(u32 ww, u32 nkw)
+{
+    switch (ww) {
+        case 16: return nkw == 4;
+        case 24: return (nkw == 3) || (nkw == 4);
+        case 32: return (nkw == 3) || (nkw == 4);
+        case 48: return (nkw == 2) || (nkw == 3);
+        case 64: return (nkw >= 2) && (nkw <= 4);
+        default: return 0;
+    }
+}
+
+// Record size in bytes (see table above)
+int SimonVecRecordSize(int ww, int nkw)
+{
+    return 1 + 2*(2*ww/8) + nkw*ww/8;
+}
+
+void SimonVecInitHeader(simon_vec_header_t* hdr, int ww, int nkw, u64 n_records)
+{
+    memset(hdr, 0, sizeof(*hdr));
+    memcpy(hdr->magic, SIMON_VEC_MAGIC, 8);
+    hdr->version        = SIMON_VEC_VERSION;
+    hdr->header_size    = sizeof(simon_vec_header_t);
+    hdr->ww             = ww;
+    hdr->nkw            = nkw;
+    hdr->record_size    = SimonVecRecordSize(ww, nkw);
+    hdr->n_records      = n_records;
+}
+
+// -- Reader ------------------------------------------------------------------------------------ //
+typedef struct {
+    int                         fd;         // -1 when no file is open
+    size_t                      size;
+    const u8*                   map;
+    const simon_vec_header_t*   hdr;
+    const u8*                   records;    // first record
+} simon_vec_file_t;
+
+// Maps a vector file read-only -- returns NULL on success, an error message otherwise
+// On error, whatever was acquired is released by SimonVecClose, which the caller must call in any case
+const char* SimonVecOpen(const char* path, simon_vec_file_t* vf)
+{
+    struct stat st;
+    memset(vf, 0, sizeof(*vf));
+    vf->fd = open(path, O_RDONLY);
+    if (vf->fd < 0)
+        return "cannot open file";
+    if ((fstat(vf->fd, &st) != 0) || ((size_t)st.st_size < sizeof(simon_vec_header_t)))
+        return "file too small";
+    vf->size = (size_t)st.st_size;
+    vf->map  = (const u8*)mmap(NULL, vf->size, PROT_READ, MAP_SHARED, vf->fd, 0);
+    if (vf->map == (const u8*)MAP_FAILED)
+        return "cannot map file";
+    vf->hdr     = (const simon_vec_header_t*)vf->map;
+    // sanity checks -- nothing of the header is trusted before it is checked (size >= header_size from here on)
+    if (memcmp(vf->hdr->magic, SIMON_VEC_MAGIC, 8) != 0)
+        return "bad magic";
+    if (vf->hdr->version != SIMON_VEC_VERSION)
+        return "unsupported version";
+    if (vf->hdr->header_size != sizeof(simon_vec_header_t))
+        return "bad header size";
+    if (!SimonVecLegalConfig(vf->hdr->ww, vf->hdr->nkw))
+        return "not a Simon configuration";
+    if (vf->hdr->record_size != (u32)SimonVecRecordSize(vf->hdr->ww, vf->hdr->nkw))
+        return "bad record size";
+    if (vf->hdr->n_records > (vf->size - vf->hdr->header_size) / vf->hdr->record_size)
+        return "file truncated";
+    vf->records = vf->map + vf->hdr->header_size;
+    // records are read sequentially
+    madvise((void*)vf->map, vf->size, MADV_SEQUENTIAL);
+    return NULL;
+}
+
+void SimonVecClose(simon_vec_file_t* vf)
+{
+    if (vf->map && (vf->map != (const u8*)MAP_FAILED))
+        munmap((void*)vf->map, vf->size);
+    if (vf->fd >= 0)
+        close(vf->fd);
+    memset(vf, 0, sizeof(*vf));
+    vf->fd = -1;
+}
+
+// Pointer to record i (no bounds check)
+const u8* SimonVecRecord(const simon_vec_file_t* vf, u64 i)
+{
+    return vf->records + i * vf->hdr->record_size;
+}
+
+#endif // SIMON_VEC_H
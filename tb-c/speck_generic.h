@@ -0,0 +1,143 @@
+/**
+ * @author Anastasios Psarras (a.psarras4225@gmail.com)
+ *
+ * @license MIT license, check license.md
+ *
+ * @brief Generic Speck kernel covering all ten Speck configurations [ref]
+ *        [ref] R. Beaulieu, D. Shors, J. Smith, S. Treatman-Clark, B. Weeks, L. Wingers, "The Simon and Speck Families of Lightweight Block Ciphers", DAC 2015
+ *        Same structure as the generic Simon kernel (simon_generic.h): one kernel per configuration generated by
+ *        SPECK_GEN_KERNEL(), with the word size n, number of key words m, number of rounds T and rotation amounts
+ *        alpha/beta (7/2 for n = 16, 8/3 otherwise) as compile-time constants. Speck 2n/mn has the same (n, m) pairs
+ *        as Simon 2n/mn, so the hardware (simon_top with SPECK) runs both on the same WW/NKW datapath.
+ *        Argument conventions follow the NSA Implementation Guide: Encrypt(Pt, Ct, rk) / Decrypt(Pt, Ct, rk),
+ *        word 0 is the least significant word of the block (y) and of the key (k_0, then l_0 .. l_(m-2)).
+ *
+ */
+
+#ifndef SPECK_GENERIC_H
+#define SPECK_GENERIC_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "definitions.h"
+#include "simon_generic.h"
+
+#define SPECK_N_ROUNDS__32_64   22
+#define SPECK_N_ROUNDS__48_72   22
+#define SPECK_N_ROUNDS__48_96   23
+#define SPECK_N_ROUNDS__64_96   26
+#define SPECK_N_ROUNDS__64_128  27
+#define SPECK_N_ROUNDS__96_96   28
+#define SPECK_N_ROUNDS__96_144  29
+#define SPECK_N_ROUNDS__128_128 32
+#define SPECK_N_ROUNDS__128_192 33
+#define SPECK_N_ROUNDS__128_256 34
+
+// Speck round (R in [ref]) and its inverse, on n-bit words held in u64
+#define SPECK_R(x,y,k,a,b,n)    (x = ((ROTRN(x,a,n) + (y)) & MASKN(n)) ^ (k), y = ROTLN(y,b,n) ^ (x))
+#define SPECK_RI(x,y,k,a,b,n)   (y = ROTRN((x) ^ (y),b,n), x = ROTLN((((x) ^ (k)) - (y)) & MASKN(n),a,n))
+
+#define SPECK_GEN_KERNEL(NAME, N, M, T, A, B)                                       \
+void SpeckG##NAME##KeySchedule(u64 K[], u64 rk[])                                   \
+{                                                                                   \
+    u64 l[(T)+(M)-2];                                                               \
+    u64 k = K[0] & MASKN(N);                                                        \
+    int i;                                                                          \
+    for (i=0; i<(M)-1; i++) l[i] = K[i+1] & MASKN(N);                               \
+    SIMON_UNROLL                                                                    \
+    for (i=0; i<(T)-1; i++) {                                                       \
+        rk[i] = k;                                                                  \
+        l[i+(M)-1] = l[i];                                                          \
+        SPECK_R(l[i+(M)-1], k, (u64)i, A, B, N);                                    \
+    }                                                                               \
+    rk[(T)-1] = k;                                                                  \
+}                                                                                   \
+                                                                                    \
+void SpeckG##NAME##Encrypt(u64 Pt[], u64 Ct[], u64 rk[])                            \
+{                                                                                   \
+    u64 x = Pt[1] & MASKN(N), y = Pt[0] & MASKN(N);                                 \
+    SIMON_UNROLL                                                                    \
+    for (int i=0; i<(T); i++)                                                       \
+        SPECK_R(x, y, rk[i], A, B, N);                                              \
+    Ct[1] = x; Ct[0] = y;                                                           \
+}                                                                                   \
+                                                                                    \
+void SpeckG##NAME##Decrypt(u64 Pt[], u64 Ct[], u64 rk[])                            \
+{                                                                                   \
+    u64 x = Ct[1] & MASKN(N), y = Ct[0] & MASKN(N);                                 \
+    SIMON_UNROLL                                                                    \
+    for (int i=(T)-1; i>=0; i--)                                                    \
+        SPECK_RI(x, y, rk[i], A, B, N);                                             \
+    Pt[1] = x; Pt[0] = y;                                                           \
+}
+
+SPECK_GEN_KERNEL(3264,    16, 4, SPECK_N_ROUNDS__32_64,   7, 2)
+SPECK_GEN_KERNEL(4872,    24, 3, SPECK_N_ROUNDS__48_72,   8, 3)
+SPECK_GEN_KERNEL(4896,    24, 4, SPECK_N_ROUNDS__48_96,   8, 3)
+SPECK_GEN_KERNEL(6496,    32, 3, SPECK_N_ROUNDS__64_96,   8, 3)
+SPECK_GEN_KERNEL(64128,   32, 4, SPECK_N_ROUNDS__64_128,  8, 3)
+SPECK_GEN_KERNEL(9696,    48, 2, SPECK_N_ROUNDS__96_96,   8, 3)
+SPECK_GEN_KERNEL(96144,   48, 3, SPECK_N_ROUNDS__96_144,  8, 3)
+SPECK_GEN_KERNEL(128128,  64, 2, SPECK_N_ROUNDS__128_128, 8, 3)
+SPECK_GEN_KERNEL(128192,  64, 3, SPECK_N_ROUNDS__128_192, 8, 3)
+SPECK_GEN_KERNEL(128256,  64, 4, SPECK_N_ROUNDS__128_256, 8, 3)
+
+// -- Configuration Table ----------------------------------------------------------------------- //
+#define SPECK_GEN_N_CFGS 10
+
+const simon_gen_cfg_t speck_gen_cfgs[SPECK_GEN_N_CFGS] = {
+    {16, 4, SPECK_N_ROUNDS__32_64,   SpeckG3264KeySchedule,   SpeckG3264Encrypt,   SpeckG3264Decrypt  },
+    {24, 3, SPECK_N_ROUNDS__48_72,   SpeckG4872KeySchedule,   SpeckG4872Encrypt,   SpeckG4872Decrypt  },
+    {24, 4, SPECK_N_ROUNDS__48_96,   SpeckG4896KeySchedule,   SpeckG4896Encrypt,   SpeckG4896Decrypt  },
+    {32, 3, SPECK_N_ROUNDS__64_96,   SpeckG6496KeySchedule,   SpeckG6496Encrypt,   SpeckG6496Decrypt  },
+    {32, 4, SPECK_N_ROUNDS__64_128,  SpeckG64128KeySchedule,  SpeckG64128Encrypt,  SpeckG64128Decrypt },
+    {48, 2, SPECK_N_ROUNDS__96_96,   SpeckG9696KeySchedule,   SpeckG9696Encrypt,   SpeckG9696Decrypt  },
+    {48, 3, SPECK_N_ROUNDS__96_144,  SpeckG96144KeySchedule,  SpeckG96144Encrypt,  SpeckG96144Decrypt },
+    {64, 2, SPECK_N_ROUNDS__128_128, SpeckG128128KeySchedule, SpeckG128128Encrypt, SpeckG128128Decrypt},
+    {64, 3, SPECK_N_ROUNDS__128_192, SpeckG128192KeySchedule, SpeckG128192Encrypt, SpeckG128192Decrypt},
+    {64, 4, SPECK_N_ROUNDS__128_256, SpeckG128256KeySchedule, SpeckG128256Encrypt, SpeckG128256Decrypt}
+};
+
+// Returns the configuration for Speck<sz_txt>/<sz_key> (sizes in bits), NULL if there's no such configuration
+const simon_gen_cfg_t* SpeckGenConfig(int sz_txt, int sz_key)
+{
+    for (int i=0; i<SPECK_GEN_N_CFGS; i++)
+        if ((2*speck_gen_cfgs[i].ww == sz_txt) && (speck_gen_cfgs[i].nkw*speck_gen_cfgs[i].ww == sz_key))
+            return &speck_gen_cfgs[i];
+    return NULL;
+}
+
+// -- Self Test --------------------------------------------------------------------------------- //
+// Test vectors of [ref], Appendix C (words listed least significant first)
+const simon_gen_kat_t speck_gen_kats[SPECK_GEN_N_CFGS] = {
+    {16, 4, {0x0100, 0x0908, 0x1110, 0x1918}, {0x694c, 0x6574}, {0x42f2, 0xa868}},
+    {24, 3, {0x020100, 0x0a0908, 0x121110}, {0x6c6172, 0x20796c}, {0x385adc, 0xc049a5}},
+    {24, 4, {0x020100, 0x0a0908, 0x121110, 0x1a1918}, {0x696874, 0x6d2073}, {0xb6445d, 0x735e10}},
+    {32, 3, {0x03020100, 0x0b0a0908, 0x13121110}, {0x736e6165, 0x74614620}, {0x4175946c, 0x9f7952ec}},
+    {32, 4, {0x03020100, 0x0b0a0908, 0x13121110, 0x1b1a1918}, {0x7475432d, 0x3b726574}, {0x454e028b, 0x8c6fa548}},
+    {48, 2, {0x050403020100ULL, 0x0d0c0b0a0908ULL}, {0x656761737520ULL, 0x65776f68202cULL}, {0x62bdde8f79aaULL, 0x9e4d09ab7178ULL}},
+    {48, 3, {0x050403020100ULL, 0x0d0c0b0a0908ULL, 0x151413121110ULL}, {0x69202c726576ULL, 0x656d6974206eULL}, {0x7ae440252ee6ULL, 0x2bf31072228aULL}},
+    {64, 2, {0x0706050403020100ULL, 0x0f0e0d0c0b0a0908ULL}, {0x7469206564616d20ULL, 0x6c61766975716520ULL}, {0x7860fedf5c570d18ULL, 0xa65d985179783265ULL}},
+    {64, 3, {0x0706050403020100ULL, 0x0f0e0d0c0b0a0908ULL, 0x1716151413121110ULL}, {0x43206f7420746e65ULL, 0x7261482066656968ULL}, {0xf9bc185de03c1886ULL, 0x1be4cf3a13135566ULL}},
+    {64, 4, {0x0706050403020100ULL, 0x0f0e0d0c0b0a0908ULL, 0x1716151413121110ULL, 0x1f1e1d1c1b1a1918ULL}, {0x202e72656e6f6f70ULL, 0x65736f6874206e49ULL}, {0x4eeeb48d9c188f43ULL, 0x4109010405c0f53eULL}}
+};
+
+// Runs every test vector in both directions -- returns the number of failing configurations
+int SpeckGenSelfTest()
+{
+    int n_failed = 0;
+    for (int i=0; i<SPECK_GEN_N_CFGS; i++) {
+        const simon_gen_kat_t* kat = &speck_gen_kats[i];
+        const simon_gen_cfg_t* cfg = SpeckGenConfig(2*kat->ww, kat->nkw*kat->ww);
+        u64 rk[SPECK_N_ROUNDS__128_256];
+        u64 ct[2], pt[2];
+        cfg->KeySchedule((u64*)kat->key, rk);
+        cfg->Encrypt((u64*)kat->pt, ct, rk);
+        cfg->Decrypt(pt, (u64*)kat->ct, rk);
+        if ((ct[0] != kat->ct[0]) || (ct[1] != kat->ct[1]) || (pt[0] != kat->pt[0]) || (pt[1] != kat->pt[1]))
+            n_failed++;
+    }
+    return n_failed;
+}
+
+#endif // SPECK_GENERIC_H
@@ -0,0 +1,105 @@
+/**
+ * @author Anastasios Psarras (a.psarras4225@gmail.com)
+ *
+ * @license MIT license, check license.md
+ *
+ * @brief Verbosity-filtered logging with an in-memory ring buffer, shared by the DPI-C model and the SV testbench
+ *        Messages at or below the current verbosity are printed. Once enabled (LogSetRing, off by default since keeping
+ *        every message costs a formatting pass each), every message is also kept in a ring of the LOG_RING_LINES most
+ *        recent lines, whatever its verbosity level. LogDump() prints (and clears) the ring, so that a failure can be
+ *        reported with the full history that led to it, without printing it on every run.
+ *        The ring depth can be overriden at compile time, e.g. -DLOG_RING_LINES=4096 (0 disables the ring).
+ *
+ */
+
+#ifndef TB_LOG_H
+#define TB_LOG_H
+
+#include "stdio.h"
+#include "stdarg.h"
+#include "string.h"
+
+// Verbosity levels (same values as VERB_* in tb_top)
+#define LOG_NONE        0   // failures only
+#define LOG_LOW         1   // + start/end summaries (default)
+#define LOG_MEDIUM      2   // + per-batch messages
+#define LOG_HIGH        3   // + per-transaction messages
+
+#ifndef LOG_RING_LINES
+#define LOG_RING_LINES  1024
+#endif
+#define LOG_RING_SLOTS  (LOG_RING_LINES > 0 ? LOG_RING_LINES : 1)
+#define LOG_LINE_BYTES  320
+
+// Printing function -- io_printf when linked to a simulator
+#ifndef LOG_PUTS
+#define LOG_PUTS(s)     io_printf("%s", s)
+#endif
+
+static int  log_verbosity   = LOG_LOW;
+static int  log_ring_en     = 0;
+static char log_ring[LOG_RING_SLOTS][LOG_LINE_BYTES];
+static u64  log_ring_head   = 0;    // number of lines ever written
+
+void LogSetVerbosity(int level)
+{
+    log_verbosity = level;
+}
+
+// Enables (1) or disables (0) keeping every message in the ring
+void LogSetRing(int en)
+{
+    log_ring_en = (LOG_RING_LINES > 0) && en;
+}
+
+// Adds an already formatted line to the ring, printing it if level <= verbosity
+void LogLine(int level, const char* line)
+{
+    if (log_ring_en) {
+        char* slot = log_ring[log_ring_head % LOG_RING_SLOTS];
+        strncpy(slot, line, LOG_LINE_BYTES-1);
+        slot[LOG_LINE_BYTES-1] = '\0';
+        log_ring_head++;
+    }
+    if (level <= log_verbosity) {
+        LOG_PUTS(line);
+        if (line[0] && line[strlen(line)-1] != '\n')
+            LOG_PUTS("\n");
+    }
+}
+
+// printf-like LogLine
+void LogMsg(int level, const char* fmt, ...)
+{
+    char    line[LOG_LINE_BYTES];
+    va_list args;
+    // skip formatting when the message is neither printed nor kept
+    if (!log_ring_en && (level > log_verbosity))
+        return;
+    va_start(args, fmt);
+    vsnprintf(line, sizeof(line), fmt, args);
+    va_end(args);
+    LogLine(level, line);
+}
+
+// Prints the lines kept in the ring (oldest first) and clears it
+void LogDump()
+{
+    u64 n     = log_ring_head < LOG_RING_LINES ? log_ring_head : LOG_RING_LINES;
+    u64 first = log_ring_head - n;
+    char hdr[LOG_LINE_BYTES];
+    if (n == 0)
+        return;
+    snprintf(hdr, sizeof(hdr), "---- last %llu log lines (of %llu) ----\n", (unsigned long long)n, (unsigned long long)log_ring_head);
+    LOG_PUTS(hdr);
+    for (u64 i=first; i<log_ring_head; i++) {
+        const char* line = log_ring[i % LOG_RING_SLOTS];
+        LOG_PUTS(line);
+        if (line[0] && line[strlen(line)-1] != '\n')
+            LOG_PUTS("\n");
+    }
+    LOG_PUTS("---- end of log ----\n");
+    log_ring_head = 0;
+}
+
+#endif // TB_LOG_H
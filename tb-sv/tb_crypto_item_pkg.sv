@@ -21,8 +21,14 @@ class crypto_item
 time        gen_time;
 time        sink_time;
 rand bit    crypto_mode; // 0 for encrypt, 1 for decrypt
+bit         alg;         // ALG_SIMON or ALG_SPECK (simon_top with SPECK)
+bit[1:0]    op;          // simon_mode_top: mode of operation of the session (OP_ECB, OP_CBC or OP_CTR)
+bit         new_session; // simon_mode_top: first block of a session (op, crypto_mode, iv and key loaded before it)
+bit[2-1:0][WW-1:0] iv;   // simon_mode_top: IV / initial counter of the session
 rand byte   txt[2*WW/8]; // Plaintext for Enryption -- Ciphertext for decryption
 rand byte   key[NKW*WW/8];
+bit         has_gold;           // set when the expected output text is known up front (vector file replay)
+byte        txt_gold[2*WW/8];   // expected output text
 
 // empty constructor
 function new();
@@ -32,8 +38,14 @@ endfunction
 function void hard_copy(ref crypto_item #(.WW(WW), .NKW(NKW)) item_cpy);
     item_cpy = new();
     item_cpy.crypto_mode = this.crypto_mode;
+    item_cpy.alg = this.alg;
+    item_cpy.op = this.op;
+    item_cpy.new_session = this.new_session;
+    item_cpy.iv = this.iv;
     item_cpy.txt = this.txt;
     item_cpy.key = this.key;
+    item_cpy.has_gold = this.has_gold;
+    item_cpy.txt_gold = this.txt_gold;
     item_cpy.gen_time = this.gen_time;
     item_cpy.sink_time = this.sink_time;
 endfunction
@@ -42,7 +54,7 @@ endfunction
 function string to_str(logic txt_is_pt);
     string enc_dec_str;
     string pt_ct_str;
-    enc_dec_str = this.crypto_mode == MODE_ENC ? "enc" : "dec";
+    enc_dec_str = {this.alg == ALG_SPECK ? "speck " : "", this.crypto_mode == MODE_ENC ? "enc" : "dec"};
     pt_ct_str = txt_is_pt ? "pt" : "ct";
     
     return $sformatf("%s | %s: %s | key: %s", enc_dec_str, pt_ct_str, this.txt_to_str(), this.key_to_str());
@@ -97,6 +109,33 @@ function bit[NKW*WW-1:0] get_flattened_key();
 endfunction
 
 
+// Text setter using "flattened" version of the text as input
+function void set_txt_from_flattened(bit[2*WW-1:0] txt_in);
+    for (int b=0; b<2*WW/8; b++)
+        this.txt[b] = txt_in[b*8 +: 8];
+endfunction
+
+// Key setter using "flattened" version of the key as input
+function void set_key_from_flattened(bit[NKW*WW-1:0] key_in);
+    for (int b=0; b<NKW*WW/8; b++)
+        this.key[b] = key_in[b*8 +: 8];
+endfunction
+
+// Expected output text setter using "flattened" version of the text as input
+function void set_gold_from_flattened(bit[2*WW-1:0] txt_in);
+    this.has_gold = 1'b1;
+    for (int b=0; b<2*WW/8; b++)
+        this.txt_gold[b] = txt_in[b*8 +: 8];
+endfunction
+
+// Expected output text getter returning "flattened" version of the text
+function bit[2*WW-1:0] get_flattened_gold();
+    bit[2*WW-1:0] txt_out;
+    for (int b=0; b<2*WW/8; b++)
+        txt_out[b*8 +: 8] = this.txt_gold[b];
+    return txt_out;
+endfunction
+
 // Method returning human-readable key
 function string key_to_str();
     string str_ret;
@@ -8,21 +8,59 @@
  * @brief -- To run the testbench you need a simulator that supports SystemVerilog & DPI-C:
  *           1. Compile files contained in <./flist>
  *           2. Simulate & run
- *              Your output should be flooded with *** INFO *** and *** SUCCESS *** messages,
- *              ending with: [chck] *** INFO *** Checked all transactions: 100/100 succeeded.
+ *              By default only summaries are printed, ending with:
+ *              [chck] *** INFO *** Checked all transactions: 100/100 succeeded.
  *              If you get less than 100% verified transactions, something has gone wrong.
  *              Make sure your simulator breaks on Error, so that you don't miss possible errors.
  *
  *        -- To customize the RTL:
  *           To generate and run any Simon 2n/mn configuration, set parameters WW and NKW  accordingly,
- *           where n=WW (word size), and m=NKW (key size). Default values are WW=32, NKW=3, which generates Simon 64/96.
- *           Note that the verification environment only supports Simon 64/96, 64/128, 128/128, 128/192, 128/256,
- *           since NSA provides reference C code only for those configurations. RTL supports all possible configurations.
+ *           where n=WW (word size), and m=NKW (key size). Default values are WW=64, NKW=3, which generates Simon 128/192.
+ *           The verification environment supports all ten configurations: Simon 64/96, 64/128, 128/128, 128/192, 128/256
+ *           are checked against NSA's reference C code, the rest against the generic C kernel (tb-c/simon_generic.h),
+ *           which is self-tested against the test vectors of the Simon & Speck paper.
  *
  *        -- To customize the TB:
- *           You can change the number of random transactions generated by setting ITEMS_TO_GENERATE parameter in tb_top.
- *           Each transaction is randomly selected to be an encryption or decryption process, in which case, a random Default
- *           value is 100, i.e. 100 random plaintext-key or ciphertext-key pairs are generated.
+ *           You can change the number of random transactions generated by setting ITEMS_TO_GENERATE parameter in tb_top
+ *           (or +ITEMS=<n> at runtime). Each transaction is randomly selected to be an encryption or decryption process, in
+ *           which case, a random plaintext-key or ciphertext-key pair is generated. Default value is 100.
+ *           The checker gathers CHECK_BATCH_SIZE transactions before calling the DPI-C golden model once for all of them.
+ *           Passing +VEC_FILE=<path> replays a golden-vector file (see tb-c/simon_gen.c) instead: the source drives its
+ *           records and the checker compares against the expected texts of the file, without calling the golden model.
+ *           +VERBOSITY=<0..3> (or NONE/LOW/MEDIUM/HIGH) sets the verbosity of both the testbench and the DPI-C model
+ *           (default LOW: summaries only, HIGH: every transaction). +LOG_RING also keeps all messages, whatever the
+ *           verbosity, in an in-memory ring buffer (tb-c/tb_log.h) that is printed on the first failures -- a debug
+ *           option, as every per-transaction message is then formatted.
+ *           N_ENGINES > 1 verifies simon_multi_top instead (results must come back in input order).
+ *           INTERLEAVE > 0 verifies simon_interleave_top with INTERLEAVE contexts instead (in input order as well).
+ *           AXIS_TOP verifies simon_axis_top instead (blocks as {key, pt} AXI-Stream beats, mode on TUSER).
+ *           MODE_TOP verifies simon_mode_top instead: the items come in random sessions of 1 to MODE_SESSION_MAX blocks,
+ *           each with a random mode of operation (ECB, CBC or CTR) & direction, and a new IV, a new key or both, loaded
+ *           mid-stream; the checker chains the ECB golden model the same way.
+ *           IN_FIFO_DEPTH / OUT_FIFO_DEPTH set the FIFO depths of simon_top (and of the simon_multi_top engines).
+ *           Power estimation: +VCD=<path> dumps the activity of the run (to feed a power tool, e.g. converted to SAIF
+ *           with vcd2saif), ideally with +IDLE_PCT=<0..100> to insert idle gaps between the blocks as a real workload
+ *           would. For simon_top, the duty cycles of the register group write enables (what CLK_GATE saves) and of
+ *           the round functions (what OP_ISO saves) are reported at the end.
+ *           MASKED verifies simon_top's masked core, with its randomness input driven with fresh random bits every cycle.
+ *           SPECK verifies simon_top with Speck as well: SPECK_PCT of the random blocks are Speck blocks (alg_i), checked
+ *           against the generic Speck kernel (tb-c/speck_generic.h), and the checker reports the counts per cipher.
+ *           Performance mode: +PERF drives valid_i saturated (a new block in the cycle after each handshake) and
+ *           drives ready_i under the +BP=NONE|RANDOM|BURSTY backpressure profile (+BP_PCT=<1..100>: % of the cycles,
+ *           or bursts, ready; +BP_BURST=<n>: max burst length), then reports the sustained blocks/cycle and the
+ *           per-mode latency (input to output handshake) with a histogram. +PERF_MODE=ENC|DEC|MIX sets all the
+ *           blocks to one mode, so that each mode can be measured separately.
+ *           CFG_TOP verifies simon_cfg_top instead, with every block's cfg_i set to the WW/NKW configuration (words
+ *           zero-extended to its 64-bit datapath): run the TB for each WW/NKW pair to cover all configurations.
+ *           With KEY_PERSIST, the driver loads simon_top's session key through key_valid_i/key_ready_o only when it changes.
+ *           KEY_REUSE_PCT of the random items reuse one of the last keys, so that simon_top's decryption key cache hits.
+ *           For simon_top, an assertion checks that blocks loaded back-to-back complete in exactly ceil(T/UNROLL) cycles
+ *           (2T with MASKED, Speck's T for the Speck blocks), and the number of such bubble-free results and of key cache hits is reported at the end.
+ *
+ *        -- To run a regression:
+ *           The RTL Config is made of tb_top parameters, so it can be overridden per run (e.g. vsim -GWW=32 -GNKW=4).
+ *           scripts/regress.py runs a parallel, multi-seed regression over a matrix of configurations this way, and merges
+ *           the pass/fail counts (and coverage) per configuration.
  *
  */
  
@@ -31,6 +69,29 @@
 // `default_nettype none
 module tb_top
 #(
+    // -- RTL Config (override per run, e.g. vsim -GWW=32 -GNKW=4) -------------------------------- //
+    parameter int   WW                 = 64,
+    parameter int   NKW                = 3,
+    parameter logic DATA_RST           = 1'b0,
+    parameter int   UNROLL             = 1,    // rounds per cycle -- the last cycle runs the remainder if it does not divide T
+    parameter bit   PIPE_TOP           = 1'b0, // 1: verify the fully pipelined simon_pipe_top instead of simon_top
+    parameter int   DEC_KEY_CACHE_DEPTH= 2,    // decryption key sets kept by simon_top (0: none)
+    parameter bit   KEY_PERSIST        = 1'b0, // 1: simon_top session key mode -- the driver loads a key only when it changes
+    parameter bit   RK_RAM             = 1'b0, // 1: simon_top stores the round keys of the last key (supersedes the key cache)
+    parameter int   N_ENGINES          = 1,    // > 1: verify simon_multi_top with N_ENGINES simon_top engines instead
+    parameter int   INTERLEAVE         = 0,    // > 0: verify simon_interleave_top with INTERLEAVE contexts instead
+    parameter bit   STATS              = 1'b1, // 1: simon_top statistics block, reported at the end
+    parameter bit   CFG_TOP            = 1'b0, // 1: verify the runtime-configurable simon_cfg_top instead, set to the WW/NKW configuration
+    parameter bit   AXIS_TOP           = 1'b0, // 1: verify the AXI-Stream simon_axis_top instead (simon_multi_top engines if N_ENGINES > 1)
+    parameter bit   MODE_TOP           = 1'b0, // 1: verify simon_mode_top instead, with random ECB/CBC/CTR sessions
+    parameter int   IN_FIFO_DEPTH      = 0,    // simon_top (& simon_multi_top engines) input FIFO depth
+    parameter int   OUT_FIFO_DEPTH     = 0,    // simon_top (& simon_multi_top engines) output FIFO depth
+    parameter bit   CLK_GATE           = 1'b0, // 1: simon_top clock gates on its register groups
+    parameter bit   OP_ISO             = 1'b0, // 1: simon_top operand isolation of the round functions
+    parameter bit   MASKED             = 1'b0, // 1: simon_top first-order masked core (needs UNROLL=1, RK_RAM=0)
+    parameter bit   SPECK              = 1'b0, // 1: simon_top with Speck blocks as well (needs UNROLL=1, RK_RAM=0, MASKED=0)
+    // -- TB Config (also +ITEMS=<n>) ------------------------------------------------------------- //
+    parameter int   ITEMS_TO_GENERATE  = 100
 )
 (
 );
@@ -38,22 +99,158 @@ module tb_top
 // -- Imports ------------------------------------------------------------------------------------- //
 import tb_crypto_item_pkg::crypto_item;
 import simon_const_pkg::*;
-import "DPI-C" function void dpi_c_run_simon(input int crypto_mode, byte txt_i[], byte key_i[], output byte txt_o[]);
-
-/*       Manual ENC | DEC | Auto
- 32-3:          OK  | OK  |  OK
- 32-4:          OK  | OK  |  OK
- 64-2:          OK  | OK  |  OK
- 64-3:          OK  | OK  |  OK
- 64-4:          OK  | OK  |  OK
+// the checker calls the batched golden routines, and the single-item one to chain simon_mode_top's modes
+// (tb-c/simon.c also exports byte-array ones)
+import "DPI-C" function void dpi_c_run_simon_packed(input int crypto_mode, input int ww, input int nkw, input bit[2*WW-1:0] txt_i, input bit[NKW*WW-1:0] key_i, output bit[2*WW-1:0] txt_o);
+import "DPI-C" function int  dpi_c_run_simon_packed_batch(input int n_items, input int ww, input int nkw, input int modes_i[], input bit[2*WW-1:0] txts_i[], input bit[NKW*WW-1:0] keys_i[], output bit[2*WW-1:0] txts_o[]);
+import "DPI-C" function int  dpi_c_run_speck_packed_batch(input int n_items, input int ww, input int nkw, input int modes_i[], input bit[2*WW-1:0] txts_i[], input bit[NKW*WW-1:0] keys_i[], output bit[2*WW-1:0] txts_o[]);
+import "DPI-C" function void dpi_c_get_rk_cache_stats(output longint hits, output longint misses);
+import "DPI-C" function int  dpi_c_vec_open(input string path, output int ww, output int nkw, output longint n_records);
+import "DPI-C" function int  dpi_c_vec_next(output int mode, output bit[2*WW-1:0] txt_i, output bit[NKW*WW-1:0] key_i, output bit[2*WW-1:0] txt_o);
+import "DPI-C" function void dpi_c_vec_close();
+import "DPI-C" function void dpi_c_set_verbosity(input int level);
+import "DPI-C" function void dpi_c_set_log_ring(input int en);
+import "DPI-C" function void dpi_c_log(input int level, input string msg);
+import "DPI-C" function void dpi_c_log_dump();
+
+/* Golden model of the checker per configuration (WW-NKW):
+ 16-4, 24-3, 24-4, 48-2, 48-3:  generic C kernel (tb-c/simon_generic.h), self-tested against the paper's test vectors
+ 32-3, 32-4, 64-2, 64-3, 64-4:  NSA's reference C code -- Manual ENC | DEC | Auto: OK for all five
 */
 
-// -- RTL Config ---------------------------------------------------------------------------------- //
-localparam int   WW                 = 64;
-localparam int   NKW                = 3;
-localparam logic DATA_RST           = 1'b0;
+// simon_top itself is verified (internal throughput checks, session key & statistics)
+localparam bit   SIMON_TOP          = !PIPE_TOP && (N_ENGINES <= 1) && (INTERLEAVE == 0) && !CFG_TOP && !AXIS_TOP && !MODE_TOP;
 // -- TB Config ----------------------------------------------------------------------------------- //
-localparam int   ITEMS_TO_GENERATE  = 100;
+localparam int   CHECK_BATCH_SIZE   = 16;   // number of transactions the checker sends to the DPI-C golden model at once
+localparam int   LOG_DUMP_FAILURES  = 4;    // number of failures printing the log ring buffer
+localparam int   KEY_REUSE_PCT      = 50;   // % of random items reusing one of the last KEY_REUSE_N keys (key cache hits)
+localparam int   KEY_REUSE_N        = 3;
+localparam int   SPECK_PCT          = 50;   // % of random items run as Speck blocks (SPECK)
+localparam int   MODE_SESSION_MAX   = 8;    // max blocks per simon_mode_top session (MODE_TOP)
+
+// -- Vector file replay -------------------------------------------------------------------------- //
+string  vec_file;
+bit     vec_replay          = 1'b0;
+int     items_to_generate   = ITEMS_TO_GENERATE;
+int     idle_pct            = 0;    // % of the blocks driven after an idle gap (power estimation workload)
+
+// -- Performance Mode ---------------------------------------------------------------------------- //
+// Backpressure profiles of the sink in performance mode
+localparam int   BP_NONE            = 0;    // ready_i always high
+localparam int   BP_RANDOM          = 1;    // ready_i high in bp_pct% of the cycles, independently
+localparam int   BP_BURSTY          = 2;    // ready_i high/low in bursts of 1..bp_burst cycles, high in bp_pct% of the bursts
+localparam int   PERF_HIST_BINS     = 16;   // latency histogram bins
+localparam int   PERF_HIST_BAR      = 40;   // latency histogram bar length of the fullest bin
+
+bit     perf_en             = 1'b0;
+int     perf_mode           = -1;   // -1: random modes, MODE_ENC / MODE_DEC: all blocks in that mode
+int     bp_profile          = BP_NONE;
+int     bp_pct              = 50;
+int     bp_burst            = 16;
+longint perf_in_cycle[$];           // input handshake cycle of each block in flight (blocks complete in order)
+longint perf_lat[2][$];             // latencies (input to output handshake, in cycles) per mode
+longint perf_first_in       = -1;
+longint perf_first_out      = -1;
+longint perf_last_out       = -1;
+
+// -- Logging ------------------------------------------------------------------------------------- //
+// Verbosity levels (same values as LOG_* in tb-c/tb_log.h)
+localparam int   VERB_NONE          = 0;    // failures only
+localparam int   VERB_LOW           = 1;    // + start/end summaries
+localparam int   VERB_MEDIUM        = 2;    // + per-batch messages
+localparam int   VERB_HIGH          = 3;    // + per-transaction messages
+
+int     verbosity       = VERB_LOW;
+bit     log_ring_en     = 1'b0;   // +LOG_RING
+int     n_log_dumps     = 0;
+
+// Whether a message of this level is printed or kept -- call sites skip formatting otherwise
+function automatic bit log_on(int level);
+    return log_ring_en || (level <= verbosity);
+endfunction
+
+function automatic void tb_log(int level, string msg);
+    if (log_ring_en)
+        dpi_c_log(level, msg);
+    else if (level <= verbosity)
+        $display("%s", msg);
+endfunction
+
+// Reports a failure, printing the history that led to it
+function automatic void tb_fail(string msg);
+    $error("%s", msg);
+    if (log_ring_en && (n_log_dumps < LOG_DUMP_FAILURES)) begin
+        dpi_c_log_dump();
+        n_log_dumps++;
+    end
+endfunction
+
+// -- Plusargs ------------------------------------------------------------------------------------ //
+initial begin
+    string verb_str;
+    if (KEY_PERSIST && !SIMON_TOP)
+        $fatal(1, "[mngr] *** FAILURE *** KEY_PERSIST is only supported by simon_top (PIPE_TOP=0, N_ENGINES=1, INTERLEAVE=0, CFG_TOP=0, AXIS_TOP=0, MODE_TOP=0)");
+    if (MASKED && !SIMON_TOP)
+        $fatal(1, "[mngr] *** FAILURE *** MASKED is only supported by simon_top (PIPE_TOP=0, N_ENGINES=1, INTERLEAVE=0, CFG_TOP=0, AXIS_TOP=0, MODE_TOP=0)");
+    if (SPECK && !SIMON_TOP)
+        $fatal(1, "[mngr] *** FAILURE *** SPECK is only supported by simon_top (PIPE_TOP=0, N_ENGINES=1, INTERLEAVE=0, CFG_TOP=0, AXIS_TOP=0, MODE_TOP=0)");
+    if ($value$plusargs("VERBOSITY=%s", verb_str)) begin
+        case (verb_str)
+            "NONE":     verbosity = VERB_NONE;
+            "LOW":      verbosity = VERB_LOW;
+            "MEDIUM":   verbosity = VERB_MEDIUM;
+            "HIGH":     verbosity = VERB_HIGH;
+            default:    verbosity = verb_str.atoi();
+        endcase
+    end
+    if ($value$plusargs("ITEMS=%d", items_to_generate))
+        tb_log(VERB_LOW, $sformatf("%0t: [mngr] *** INFO *** Generating %0d items", $time, items_to_generate));
+    if ($value$plusargs("IDLE_PCT=%d", idle_pct))
+        tb_log(VERB_LOW, $sformatf("%0t: [mngr] *** INFO *** %0d%% of the blocks driven after an idle gap", $time, idle_pct));
+    if ($test$plusargs("PERF")) begin
+        string str;
+        perf_en = 1'b1;
+        if ($value$plusargs("PERF_MODE=%s", str)) begin
+            case (str)
+                "ENC":      perf_mode = MODE_ENC;
+                "DEC":      perf_mode = MODE_DEC;
+                "MIX":      perf_mode = -1;
+                default:    $fatal(1, "[mngr] *** FAILURE *** unknown +PERF_MODE=%s (ENC, DEC or MIX)", str);
+            endcase
+        end
+        if ($value$plusargs("BP=%s", str)) begin
+            case (str)
+                "NONE":     bp_profile = BP_NONE;
+                "RANDOM":   bp_profile = BP_RANDOM;
+                "BURSTY":   bp_profile = BP_BURSTY;
+                default:    $fatal(1, "[mngr] *** FAILURE *** unknown +BP=%s (NONE, RANDOM or BURSTY)", str);
+            endcase
+        end
+        void'($value$plusargs("BP_PCT=%d", bp_pct));
+        void'($value$plusargs("BP_BURST=%d", bp_burst));
+        if ((bp_pct < 1) || (bp_pct > 100) || (bp_burst < 1))
+            $fatal(1, "[mngr] *** FAILURE *** +BP_PCT must be in 1..100 and +BP_BURST at least 1");
+        tb_log(VERB_LOW, $sformatf("%0t: [perf] *** INFO *** Performance mode: saturated input, %s backpressure (%0d%% ready, bursts up to %0d)",
+            $time, bp_name(), bp_pct, bp_burst));
+    end
+    if ($test$plusargs("LOG_RING"))
+        log_ring_en = 1'b1;
+    dpi_c_set_verbosity(verbosity);
+    dpi_c_set_log_ring(log_ring_en);
+    
+    if ($value$plusargs("VEC_FILE=%s", vec_file)) begin
+        int     file_ww, file_nkw;
+        longint file_records;
+        if (dpi_c_vec_open(vec_file, file_ww, file_nkw, file_records) != 0)
+            $fatal(1, "[mngr] *** FAILURE *** could not open vector file %s", vec_file);
+        if ((file_ww != WW) || (file_nkw != NKW))
+            $fatal(1, "[mngr] *** FAILURE *** vector file %s is Simon%0d/%0d, RTL is Simon%0d/%0d", vec_file, 2*file_ww, file_ww*file_nkw, 2*WW, WW*NKW);
+        vec_replay          = 1'b1;
+        items_to_generate   = int'(file_records);
+        tb_log(VERB_LOW, $sformatf("%0t: [mngr] *** INFO *** Replaying %0d records from %s", $time, items_to_generate, vec_file));
+    end
+end
+
 
 // -- clk/rst ------------------------------------------------------------------------------------- //
 localparam CLK_PERIOD = 200;
@@ -72,42 +269,434 @@ logic                    active_o;
 logic                    simon_inp_valid;
 logic                    simon_inp_ready;
 logic                    simon_inp_mode;
+logic                    simon_inp_alg;     // simon_top only
 logic[2-1:0][WW-1:0]     simon_inp_pt;
 logic[NKW-1:0][WW-1:0]   simon_inp_key;
+logic                    simon_key_valid;
+logic                    simon_key_ready;
+logic                    simon_cfg_valid;   // simon_mode_top only
+logic                    simon_cfg_ready;
+logic[1:0]               simon_cfg_op;
+logic                    simon_cfg_dir;
+logic[2-1:0][WW-1:0]     simon_cfg_iv;
 logic                    simon_out_valid;
 logic                    simon_out_ready;
 logic                    simon_out_mode;
+logic                    simon_out_alg;     // simon_top only
 logic[2-1:0][WW-1:0]     simon_out_ct;
+logic[simon_const_pkg::STATS_AW-1:0] simon_stats_addr = '0;
+logic[simon_const_pkg::STATS_DW-1:0] simon_stats_rdata;
 
-simon_top
-#(
-    .WW             (WW),
-    .NKW            (NKW),
-    .DATA_RST       (DATA_RST)
-)
-i_core
-(
-    .clk            (clk),
-    .arst_n         (arst_n),
+if (PIPE_TOP) begin: g_if_pipe_top
+    simon_pipe_top
+    #(
+        .WW             (WW),
+        .NKW            (NKW),
+        .DATA_RST       (DATA_RST)
+    )
+    i_core
+    (
+        .clk            (clk),
+        .arst_n         (arst_n),
+        
+        .active_o       (active_o),
+        
+        .valid_i        (simon_inp_valid),
+        .ready_o        (simon_inp_ready),
+        .mode_i         (simon_inp_mode),
+        .pt_i           (simon_inp_pt),
+        .key_i          (simon_inp_key),
+        
+        .valid_o        (simon_out_valid),
+        .ready_i        (simon_out_ready),
+        .mode_o         (simon_out_mode),
+        .ct_o           (simon_out_ct)
+    );
+end else if (AXIS_TOP) begin: g_if_axis_top
+    simon_axis_top
+    #(
+        .WW             (WW),
+        .NKW            (NKW),
+        .DATA_RST       (DATA_RST),
+        .UNROLL         (UNROLL),
+        .DEC_KEY_CACHE_DEPTH (DEC_KEY_CACHE_DEPTH),
+        .RK_RAM         (RK_RAM),
+        .N_ENGINES      (N_ENGINES),
+        .IN_FIFO_DEPTH  (IN_FIFO_DEPTH),
+        .OUT_FIFO_DEPTH (OUT_FIFO_DEPTH)
+    )
+    i_core
+    (
+        .clk            (clk),
+        .arst_n         (arst_n),
+        
+        .active_o       (active_o),
+        
+        .s_axis_tvalid  (simon_inp_valid),
+        .s_axis_tready  (simon_inp_ready),
+        .s_axis_tdata   ({simon_inp_key, simon_inp_pt}),
+        .s_axis_tuser   (simon_inp_mode),
+        .s_axis_tlast   (1'b0),
+        
+        .m_axis_tvalid  (simon_out_valid),
+        .m_axis_tready  (simon_out_ready),
+        .m_axis_tdata   (simon_out_ct),
+        .m_axis_tuser   (simon_out_mode),
+        .m_axis_tlast   ()
+    );
+end else if (N_ENGINES > 1) begin: g_if_multi_top
+    logic[N_ENGINES-1:0] eng_active;
     
-    .active_o       (active_o),
+    simon_multi_top
+    #(
+        .WW             (WW),
+        .NKW            (NKW),
+        .DATA_RST       (DATA_RST),
+        .UNROLL         (UNROLL),
+        .DEC_KEY_CACHE_DEPTH (DEC_KEY_CACHE_DEPTH),
+        .RK_RAM         (RK_RAM),
+        .N_ENGINES      (N_ENGINES),
+        .IN_FIFO_DEPTH  (IN_FIFO_DEPTH),
+        .OUT_FIFO_DEPTH (OUT_FIFO_DEPTH)
+    )
+    i_core
+    (
+        .clk            (clk),
+        .arst_n         (arst_n),
+        
+        .active_o       (eng_active),
+        
+        .valid_i        (simon_inp_valid),
+        .ready_o        (simon_inp_ready),
+        .mode_i         (simon_inp_mode),
+        .pt_i           (simon_inp_pt),
+        .key_i          (simon_inp_key),
+        
+        .valid_o        (simon_out_valid),
+        .ready_i        (simon_out_ready),
+        .mode_o         (simon_out_mode),
+        .ct_o           (simon_out_ct)
+    );
+    assign active_o = |eng_active;
+end else if (CFG_TOP) begin: g_if_cfg_top
+    logic[2-1:0][64-1:0]    cfg_pt;
+    logic[4-1:0][64-1:0]    cfg_key;
+    logic[2-1:0][64-1:0]    cfg_ct;
     
-    .valid_i        (simon_inp_valid),
-    .ready_o        (simon_inp_ready),
-    .mode_i         (simon_inp_mode),
-    .pt_i           (simon_inp_pt),
-    .key_i          (simon_inp_key),
+    for (genvar i=0; i<2; i++) begin: g_for_pt
+        assign cfg_pt[i]        = 64'(simon_inp_pt[i]);
+        assign simon_out_ct[i]  = cfg_ct[i][WW-1:0];
+    end
+    for (genvar i=0; i<4; i++) begin: g_for_key
+        assign cfg_key[i]       = i < NKW ? 64'(simon_inp_key[i % NKW]) : '0;
+    end
     
-    .valid_o        (simon_out_valid),
-    .ready_i        (simon_out_ready),
-    .mode_o         (simon_out_mode),
-    .ct_o           (simon_out_ct)
-);
+    simon_cfg_top
+    #(
+        .WW_MAX         (64),
+        .NKW_MAX        (4),
+        .DATA_RST       (DATA_RST)
+    )
+    i_core
+    (
+        .clk            (clk),
+        .arst_n         (arst_n),
+        
+        .active_o       (active_o),
+        
+        .valid_i        (simon_inp_valid),
+        .ready_o        (simon_inp_ready),
+        .mode_i         (simon_inp_mode),
+        .cfg_i          (simon_const_pkg::SIMON_CFG_W'(simon_const_pkg::simon_cfg_idx(WW, NKW))),
+        .pt_i           (cfg_pt),
+        .key_i          (cfg_key),
+        
+        .valid_o        (simon_out_valid),
+        .ready_i        (simon_out_ready),
+        .mode_o         (simon_out_mode),
+        .cfg_o          (),
+        .ct_o           (cfg_ct)
+    );
+end else if (INTERLEAVE > 0) begin: g_if_interleave_top
+    simon_interleave_top
+    #(
+        .WW             (WW),
+        .NKW            (NKW),
+        .DATA_RST       (DATA_RST),
+        .INTERLEAVE     (INTERLEAVE)
+    )
+    i_core
+    (
+        .clk            (clk),
+        .arst_n         (arst_n),
+        
+        .active_o       (active_o),
+        
+        .valid_i        (simon_inp_valid),
+        .ready_o        (simon_inp_ready),
+        .mode_i         (simon_inp_mode),
+        .pt_i           (simon_inp_pt),
+        .key_i          (simon_inp_key),
+        
+        .valid_o        (simon_out_valid),
+        .ready_i        (simon_out_ready),
+        .mode_o         (simon_out_mode),
+        .ct_o           (simon_out_ct)
+    );
+end else if (MODE_TOP) begin: g_if_mode_top
+    simon_mode_top
+    #(
+        .WW             (WW),
+        .NKW            (NKW),
+        .DATA_RST       (DATA_RST),
+        .UNROLL         (UNROLL),
+        .DEC_KEY_CACHE_DEPTH (DEC_KEY_CACHE_DEPTH)
+    )
+    i_core
+    (
+        .clk            (clk),
+        .arst_n         (arst_n),
+        
+        .active_o       (active_o),
+        
+        .cfg_valid_i    (simon_cfg_valid),
+        .cfg_ready_o    (simon_cfg_ready),
+        .op_i           (simon_cfg_op),
+        .dir_i          (simon_cfg_dir),
+        .iv_i           (simon_cfg_iv),
+        .key_i          (simon_inp_key),
+        
+        .valid_i        (simon_inp_valid),
+        .ready_o        (simon_inp_ready),
+        .data_i         (simon_inp_pt),
+        
+        .valid_o        (simon_out_valid),
+        .ready_i        (simon_out_ready),
+        .data_o         (simon_out_ct)
+    );
+    // results come out in the direction of the session (a session is only loaded once the previous one is over)
+    assign simon_out_mode = i_core.dir_r;
+end else begin: g_if_top
+    logic[3+NKW-1:0][WW-1:0] rnd;   // masking randomness, fresh every cycle
+    
+    always_ff @(posedge clk) begin: ff_rnd
+        for (int i=0; i<3+NKW; i++)
+            rnd[i] <= MASKED ? WW'({$urandom, $urandom}) : '0;
+    end
+    
+    simon_top
+    #(
+        .WW             (WW),
+        .NKW            (NKW),
+        .DATA_RST       (DATA_RST),
+        .UNROLL         (UNROLL),
+        .DEC_KEY_CACHE_DEPTH (DEC_KEY_CACHE_DEPTH),
+        .KEY_PERSIST    (KEY_PERSIST),
+        .RK_RAM         (RK_RAM),
+        .STATS          (STATS),
+        .IN_FIFO_DEPTH  (IN_FIFO_DEPTH),
+        .OUT_FIFO_DEPTH (OUT_FIFO_DEPTH),
+        .CLK_GATE       (CLK_GATE),
+        .OP_ISO         (OP_ISO),
+        .MASKED         (MASKED),
+        .SPECK          (SPECK)
+    )
+    i_core
+    (
+        .clk            (clk),
+        .arst_n         (arst_n),
+        
+        .active_o       (active_o),
+        
+        .valid_i        (simon_inp_valid),
+        .ready_o        (simon_inp_ready),
+        .mode_i         (simon_inp_mode),
+        .alg_i          (simon_inp_alg),
+        .pt_i           (simon_inp_pt),
+        .key_i          (simon_inp_key),
+        .key_valid_i    (simon_key_valid),
+        .key_ready_o    (simon_key_ready),
+        
+        .valid_o        (simon_out_valid),
+        .ready_i        (simon_out_ready),
+        .mode_o         (simon_out_mode),
+        .alg_o          (simon_out_alg),
+        .ct_o           (simon_out_ct),
+        .rnd_i          (rnd),
+        
+        .stats_clr_i    (1'b0),
+        .stats_addr_i   (simon_stats_addr),
+        .stats_rdata_o  (simon_stats_rdata)
+    );
+end
+
+// -- Throughput Checks --------------------------------------------------------------------------- //
+// simon_top loads the next staged block in the same cycle it hands a result to its output holding register:
+// an encryption (or a decryption hitting the key cache) started that way must produce its result exactly
+// ceil(T/UNROLL) cycles later (2T with MASKED, Speck's T for a Speck block), i.e. with no bubble
+localparam int N_CYCLES = simon_n_cycles(WW, NKW, UNROLL) * (MASKED ? 2 : 1);
+localparam int N_CYCLES_SPECK = speck_n_rounds(WW, NKW);
+int n_back_to_back = 0; // number of results produced N_CYCLES cycles after the previous one
+int n_key_hits     = 0; // number of blocks that found their keys stored (key cache: decryptions only, RK_RAM: all)
+
+if (SIMON_TOP) begin: g_if_tput_checks
+    wire res_hs     = g_if_top.i_core.out_ld_en;
+    wire chain      = res_hs && g_if_top.i_core.in_pop && (g_if_top.i_core.in_alg_r == ALG_SIMON);
+    wire chain_sp   = res_hs && g_if_top.i_core.in_pop && (g_if_top.i_core.in_alg_r == ALG_SPECK);
+    
+    assert property (@(posedge clk) disable iff(!arst_n)
+        chain |-> ##N_CYCLES g_if_top.i_core.fsm_out_valid) else tb_fail($sformatf("%0t: [tput] *** FAILURE *** back-to-back block did not complete in %0d cycles", $time, N_CYCLES));
+    assert property (@(posedge clk) disable iff(!arst_n)
+        chain_sp |-> ##N_CYCLES_SPECK g_if_top.i_core.fsm_out_valid) else tb_fail($sformatf("%0t: [tput] *** FAILURE *** back-to-back Speck block did not complete in %0d cycles", $time, N_CYCLES_SPECK));
+    cover property (@(posedge clk) disable iff(!arst_n)
+        chain ##N_CYCLES res_hs) n_back_to_back++;
+    cover property (@(posedge clk) disable iff(!arst_n)
+        chain_sp ##N_CYCLES_SPECK res_hs) n_back_to_back++;
+    cover property (@(posedge clk) disable iff(!arst_n)
+        g_if_top.i_core.in_pop && ((g_if_top.i_core.in_mode_r == MODE_DEC) && g_if_top.i_core.kc_hit || g_if_top.i_core.rk_hit)) n_key_hits++;
+end
+
+// -- Power Estimation ---------------------------------------------------------------------------- //
+// Activity dump, and per-group write enable duty cycles of simon_top: a register group (or the round logic) only
+// toggles in the cycles counted here when it is clock gated (or isolated)
+localparam int PWR_PT   = 0;    // text registers
+localparam int PWR_KEY  = 1;    // key registers
+localparam int PWR_SEQ  = 2;    // LFSR & t sequence
+localparam int PWR_RK   = 3;    // round key RAM
+localparam int PWR_KC   = 4;    // decryption key cache
+localparam int PWR_RND  = 5;    // round functions in use
+localparam int PWR_N    = 6;
+longint pwr_cycles = 0;
+longint pwr_en[PWR_N] = '{default: 0};
+
+initial begin
+    string vcd_file;
+    if ($value$plusargs("VCD=%s", vcd_file)) begin
+        $dumpfile(vcd_file);
+        $dumpvars(0, tb_top);
+        tb_log(VERB_LOW, $sformatf("%0t: [pwr ] *** INFO *** Dumping activity to %s", $time, vcd_file));
+    end
+end
+
+if (SIMON_TOP) begin: g_if_pwr
+    always @(posedge clk) begin
+        if (arst_n) begin
+            pwr_cycles++;
+            pwr_en[PWR_PT]  += g_if_top.i_core.i_core.pt_ld_en_i  | g_if_top.i_core.i_core.pt_run_en_i;
+            pwr_en[PWR_KEY] += g_if_top.i_core.i_core.key_ld_en_i | g_if_top.i_core.i_core.key_run_en_i;
+            pwr_en[PWR_SEQ] += g_if_top.i_core.i_core.srst_i      | g_if_top.i_core.i_core.key_run_en_i;
+            pwr_en[PWR_RK]  += g_if_top.i_core.i_core.rk_wr_en_i;
+            pwr_en[PWR_KC]  += (|g_if_top.i_core.fsm_key_reg_ld_en) | g_if_top.i_core.fsm_key_cache_fill;
+            pwr_en[PWR_RND] += g_if_top.i_core.i_core.rnd_en_i;
+        end
+    end
+end
+
+task automatic report_power();
+    const string names[PWR_N] = '{"text regs", "key regs", "LFSR & t seq", "round key RAM", "key cache", "round functions"};
+    for (int g=0; g<PWR_N; g++)
+        tb_log(VERB_LOW, $sformatf("%0t: [pwr ] *** INFO *** %s enabled in %0d / %0d cycles (%0.1f%%)", $time, names[g],
+            pwr_en[g], pwr_cycles, pwr_cycles > 0 ? 100.0 * pwr_en[g] / pwr_cycles : 0.0));
+    tb_log(VERB_LOW, $sformatf("%0t: [pwr ] *** INFO *** CLK_GATE=%0d, OP_ISO=%0d", $time, CLK_GATE, OP_ISO));
+endtask
+
+// -- Statistics ---------------------------------------------------------------------------------- //
+// reads simon_top's statistics registers, and checks the block counts against the checker's
+task automatic report_stats(int n_enc, int n_dec);
+    const string names[simon_const_pkg::STATS_LAT_SUM+1] = '{"encryptions", "decryptions", "active cycles", "stalled cycles",
+        "idle cycles", "key prepare cycles", "min latency", "max latency", "latency sum"};
+    longint unsigned val[simon_const_pkg::STATS_LAT_SUM+1];
+    for (int a=0; a<=simon_const_pkg::STATS_LAT_SUM; a++) begin
+        simon_stats_addr = a;
+        #1;
+        val[a] = simon_stats_rdata;
+        tb_log(VERB_LOW, $sformatf("%0t: [stat] *** INFO *** %s: %0d", $time, names[a], val[a]));
+    end
+    if (val[simon_const_pkg::STATS_N_ENC] + val[simon_const_pkg::STATS_N_DEC] > 0)
+        tb_log(VERB_LOW, $sformatf("%0t: [stat] *** INFO *** avg latency: %0.2f cycles", $time,
+            real'(val[simon_const_pkg::STATS_LAT_SUM]) / (val[simon_const_pkg::STATS_N_ENC] + val[simon_const_pkg::STATS_N_DEC])));
+    if ((val[simon_const_pkg::STATS_N_ENC] != n_enc) || (val[simon_const_pkg::STATS_N_DEC] != n_dec))
+        tb_fail($sformatf("%0t: [stat] *** FAILURE *** block counts %0d/%0d differ from the checked ones %0d/%0d", $time,
+            val[simon_const_pkg::STATS_N_ENC], val[simon_const_pkg::STATS_N_DEC], n_enc, n_dec));
+endtask
+
+// -- Performance Report -------------------------------------------------------------------------- //
+function automatic string bp_name();
+    case (bp_profile)
+        BP_RANDOM:  return "RANDOM";
+        BP_BURSTY:  return "BURSTY";
+        default:    return "NONE";
+    endcase
+endfunction
+
+// sink ready of the next cycle, following the backpressure profile
+int bp_left     = 0;
+bit bp_state    = 1'b1;
+function automatic bit bp_ready();
+    case (bp_profile)
+        BP_RANDOM: return $urandom_range(99) < bp_pct;
+        BP_BURSTY: begin
+            if (bp_left == 0) begin
+                bp_state    = $urandom_range(99) < bp_pct;
+                bp_left     = $urandom_range(1, bp_burst);
+            end
+            bp_left--;
+            return bp_state;
+        end
+        default:   return 1'b1;
+    endcase
+endfunction
+
+// sustained throughput and latency histograms, per mode
+task automatic report_perf();
+    const string mode_names[2] = '{"encryption", "decryption"};
+    longint n_blocks = perf_lat[MODE_ENC].size() + perf_lat[MODE_DEC].size();
+    tb_log(VERB_LOW, $sformatf("%0t: [perf] *** INFO *** Simon %0d/%0d, UNROLL=%0d, PIPE_TOP=%0d, N_ENGINES=%0d, INTERLEAVE=%0d, AXIS_TOP=%0d, FIFOs %0d/%0d, %s blocks, %s backpressure",
+        $time, 2*WW, NKW*WW, UNROLL, PIPE_TOP, N_ENGINES, INTERLEAVE, AXIS_TOP, IN_FIFO_DEPTH, OUT_FIFO_DEPTH,
+        perf_mode == MODE_ENC ? "ENC" : perf_mode == MODE_DEC ? "DEC" : "MIX", bp_name()));
+    if (n_blocks > 1) begin
+        // overall: first input to last output; sustained: between outputs, without the pipeline fill
+        longint span_all = perf_last_out - perf_first_in;
+        longint span_out = perf_last_out - perf_first_out;
+        tb_log(VERB_LOW, $sformatf("%0t: [perf] *** INFO *** %0d blocks in %0d cycles: %0.4f blocks/cycle overall, %0.4f blocks/cycle sustained (%0.2f cycles/block)",
+            $time, n_blocks, span_all, real'(n_blocks) / span_all, real'(n_blocks-1) / span_out, real'(span_out) / (n_blocks-1)));
+    end
+    for (int m=0; m<2; m++) begin
+        longint lat_min, lat_max, lat_sum, bin_w, hist_max;
+        longint hist[PERF_HIST_BINS];
+        longint lat_q[$];
+        if (perf_lat[m].size() == 0)
+            continue;
+        lat_q   = perf_lat[m].min();
+        lat_min = lat_q[0];
+        lat_q   = perf_lat[m].max();
+        lat_max = lat_q[0];
+        lat_sum = perf_lat[m].sum();
+        tb_log(VERB_LOW, $sformatf("%0t: [perf] *** INFO *** %s latency (cycles): min %0d, avg %0.2f, max %0d over %0d blocks",
+            $time, mode_names[m], lat_min, real'(lat_sum) / perf_lat[m].size(), lat_max, perf_lat[m].size()));
+        // histogram
+        bin_w       = (lat_max - lat_min + PERF_HIST_BINS) / PERF_HIST_BINS;
+        hist        = '{default: 0};
+        hist_max    = 0;
+        for (int i=0; i<perf_lat[m].size(); i++)
+            hist[(perf_lat[m][i] - lat_min) / bin_w]++;
+        foreach (hist[b])
+            hist_max = hist[b] > hist_max ? hist[b] : hist_max;
+        foreach (hist[b]) begin
+            string bar = "";
+            if (hist[b] == 0)
+                continue;
+            repeat ((hist[b] * PERF_HIST_BAR + hist_max - 1) / hist_max) bar = {bar, "#"};
+            tb_log(VERB_LOW, $sformatf("%0t: [perf] *** INFO ***   %6d..%-6d %8d %s", $time, lat_min + b*bin_w, lat_min + (b+1)*bin_w - 1, hist[b], bar));
+        end
+    end
+endtask
 
 // -- Interface with SIMON ------------------------------------------------------------------------ //
-task automatic write_to_input(input logic mode, logic[2-1:0][WW-1:0] pt, logic[NKW-1:0][WW-1:0] key);
+task automatic write_to_input(input logic mode, logic alg, logic[2-1:0][WW-1:0] pt, logic[NKW-1:0][WW-1:0] key);
     simon_inp_valid   <= 1;
     simon_inp_mode    <= mode;
+    simon_inp_alg     <= alg;
     simon_inp_pt      <= pt;
     simon_inp_key     <= key;
     
@@ -117,12 +706,43 @@ task automatic write_to_input(input logic mode, logic[2-1:0][WW-1:0] pt, logic[N
     
     simon_inp_valid   <= 0;
     simon_inp_mode    <= 'x;
+    simon_inp_alg     <= 'x;
     simon_inp_pt      <= 'x;
     simon_inp_key     <= 'x;
 endtask
 
+// session key load (KEY_PERSIST) -- key_i is the same bus as the one of write_to_input
+task automatic write_key(input logic[NKW-1:0][WW-1:0] key);
+    simon_key_valid   <= 1;
+    simon_inp_key     <= key;
+    
+    do begin
+        @(posedge clk);
+    end while (!simon_key_ready);
+    
+    simon_key_valid   <= 0;
+endtask
+
+// session load (MODE_TOP) -- key_i is the same bus as the one of write_to_input
+task automatic write_session(input logic[1:0] op, logic dir, logic[2-1:0][WW-1:0] iv, logic[NKW-1:0][WW-1:0] key);
+    simon_cfg_valid   <= 1;
+    simon_cfg_op      <= op;
+    simon_cfg_dir     <= dir;
+    simon_cfg_iv      <= iv;
+    simon_inp_key     <= key;
+    
+    do begin
+        @(posedge clk);
+    end while (!simon_cfg_ready);
+    
+    simon_cfg_valid   <= 0;
+    simon_cfg_op      <= 'x;
+    simon_cfg_dir     <= 'x;
+    simon_cfg_iv      <= 'x;
+endtask
+
 // blocking read from output
-task automatic read_from_output_b(ref logic[2-1:0][WW-1:0] ct, logic mode);
+task automatic read_from_output_b(ref logic[2-1:0][WW-1:0] ct, logic mode, logic alg);
     simon_out_ready <= 1;
     
     do begin
@@ -130,6 +750,7 @@ task automatic read_from_output_b(ref logic[2-1:0][WW-1:0] ct, logic mode);
     end while (!simon_out_valid);
     ct  = simon_out_ct;
     mode = simon_out_mode;
+    alg = SPECK ? simon_out_alg : ALG_SIMON;
     simon_out_ready <= 0;
 endtask
 
@@ -146,7 +767,7 @@ initial begin
     
     @(negedge arst_n);
     @(posedge arst_n);
-    $display("%0t: [mngr] *** INFO *** Reset phase ended.", $time);
+    tb_log(VERB_LOW, $sformatf("%0t: [mngr] *** INFO *** Reset phase ended.", $time));
     
     fork
         do_source();
@@ -154,18 +775,78 @@ initial begin
         do_sink();
         do_checker();
     join_none
-    $display("%0t: [mngr] *** INFO *** Started everything.", $time);
+    tb_log(VERB_LOW, $sformatf("%0t: [mngr] *** INFO *** Started everything.", $time));
 end
 
 // -- Source -------------------------------------------------------------------------------------- //
 task automatic do_source();
-    for (int i=0; i<ITEMS_TO_GENERATE; i++) begin
+    typedef byte key_t[NKW*WW/8];
+    key_t recent_keys[$];
+    // MODE_TOP session
+    int                     sess_left = 0;
+    bit[1:0]                sess_op;
+    bit                     sess_dir;
+    bit[2-1:0][WW-1:0]      sess_iv;
+    key_t                   sess_key;
+    bit                     sess_none = 1'b1;
+    for (int i=0; i<items_to_generate; i++) begin
         crypto_item #(.WW(WW), .NKW(NKW) ) the_item;
         
-        @(posedge clk);
-        // Produce a random item
+        if (!perf_en)
+            @(posedge clk);  // in performance mode, all items are produced ahead, so that the driver never starves
         the_item                = new();
-        assert (the_item.randomize()) else $error("Failed to randomize item");
+        if (vec_replay) begin
+            // Read the next record of the vector file
+            int             rec_mode;
+            bit[2*WW-1:0]   rec_txt_i, rec_txt_o;
+            bit[NKW*WW-1:0] rec_key;
+            assert (dpi_c_vec_next(rec_mode, rec_txt_i, rec_key, rec_txt_o)) else $fatal(1, "[srce] *** FAILURE *** vector file ended early");
+            the_item.crypto_mode    = rec_mode[0];
+            the_item.set_txt_from_flattened(rec_txt_i);
+            the_item.set_key_from_flattened(rec_key);
+            the_item.set_gold_from_flattened(rec_txt_o);
+        end else begin
+            // Produce a random item, possibly with a recent key
+            assert (the_item.randomize()) else $error("Failed to randomize item");
+            if ((recent_keys.size() > 0) && ($urandom_range(99) < KEY_REUSE_PCT))
+                the_item.key = recent_keys[$urandom_range(recent_keys.size()-1)];
+            if (perf_mode >= 0)
+                the_item.crypto_mode = perf_mode[0];
+            the_item.alg = SPECK && ($urandom_range(99) < SPECK_PCT) ? ALG_SPECK : ALG_SIMON;
+            recent_keys.push_back(the_item.key);
+            if (recent_keys.size() > KEY_REUSE_N)
+                void'(recent_keys.pop_front());
+        end
+        if (MODE_TOP && vec_replay) begin
+            // records are ECB blocks: a new session whenever the key or the direction changes
+            the_item.op             = OP_ECB;
+            the_item.new_session    = sess_none || (sess_key != the_item.key) || (sess_dir != the_item.crypto_mode);
+            sess_key                = the_item.key;
+            sess_dir                = the_item.crypto_mode;
+            sess_none               = 1'b0;
+        end else if (MODE_TOP) begin
+            // a new session replaces the IV (0), the key (1) or both (2) of the previous one, mid-stream
+            if (sess_left == 0) begin
+                int what = sess_none ? 2 : $urandom_range(2);
+                sess_op     = 2'($urandom_range(2));
+                sess_dir    = perf_mode >= 0 ? perf_mode[0] : 1'($urandom_range(1));
+                if (what != 1) begin
+                    sess_iv = (2*WW)'({$urandom, $urandom, $urandom, $urandom});
+                    if ($urandom_range(7) == 0)
+                        sess_iv[0] = '1 - $urandom_range(3); // the counter carries into the upper word within the session
+                end
+                if (what != 0)
+                    sess_key = the_item.key;
+                sess_left   = $urandom_range(1, MODE_SESSION_MAX);
+                sess_none   = 1'b0;
+                the_item.new_session = 1'b1;
+            end
+            the_item.op             = sess_op;
+            the_item.crypto_mode    = sess_dir;
+            the_item.iv             = sess_iv;
+            the_item.key            = sess_key;
+            sess_left--;
+        end
         
         // the_item.crypto_mode    = MODE_DEC;
         // the_item.txt            = '{8'h_72, 8'h_69, 8'h_62, 8'h_65, 8'h_20, 8'h_77, 8'h_68, 8'h_65, 8'h_6e, 8'h_20, 8'h_74, 8'h_68, 8'h_65, 8'h_72, 8'h_65, 8'h_20};
@@ -175,9 +856,10 @@ task automatic do_source();
         the_item.gen_time = $time();
         // Push to [Source]-->[Driver] mailbox
         assert (mb_source_2_driver.try_put(the_item)) else $error("[Source] could not put int mb_source_2_driver");
-        $display("%0t: [srce] *** INFO *** produced item:\n      %s", $time, the_item.to_str(the_item.crypto_mode == MODE_ENC));
+        if (log_on(VERB_HIGH))
+            tb_log(VERB_HIGH, $sformatf("%0t: [srce] *** INFO *** produced item:\n      %s", $time, the_item.to_str(the_item.crypto_mode == MODE_ENC)));
     end
-    $display("%0t: [srce] *** INFO *** ended production of %0d items", $time, ITEMS_TO_GENERATE);
+    tb_log(VERB_LOW, $sformatf("%0t: [srce] *** INFO *** ended production of %0d items", $time, items_to_generate));
 endtask
 /*
 64/96
@@ -204,29 +886,59 @@ endtask
 
 // -- Driver -------------------------------------------------------------------------------------- //
 task automatic do_driver();
+    logic[NKW-1:0][WW-1:0]  session_key;
+    bit                     session_key_valid = 1'b0;
+    
     simon_inp_valid <= 0;
     simon_inp_mode  <= 'x;
+    simon_inp_alg   <= 'x;
     simon_inp_pt    <= 'x;
     simon_inp_key   <= 'x;
+    simon_key_valid <= 0;
+    simon_cfg_valid <= 0;
     // start driver loop
     forever begin
         crypto_item #(.WW(WW), .NKW(NKW) ) the_item;
         logic[2-1:0][WW-1:0]    the_txt;
         logic[NKW-1:0][WW-1:0]  the_key;
         
-        @(posedge clk);
+        // in performance mode, the next block is driven in the cycle that follows the handshake (valid_i saturated)
+        if (!perf_en)
+            @(posedge clk);
         // -- Mailbox Read -- //
         mb_source_2_driver.get(the_item);
-        $display("%0t: [drvr] *** INFO *** got item from mb:\n      %s", $time, the_item.to_str(the_item.crypto_mode == MODE_ENC));
+        if (log_on(VERB_HIGH))
+            tb_log(VERB_HIGH, $sformatf("%0t: [drvr] *** INFO *** got item from mb:\n      %s", $time, the_item.to_str(the_item.crypto_mode == MODE_ENC)));
         
         the_txt = the_item.get_word_packed_txt();
         the_key = the_item.get_word_packed_key();
-        $display("%0t: [drvr] *** INFO *** driving pt: %h %h | key: %h", $time, the_txt[1], the_txt[0], the_key);
+        if (log_on(VERB_HIGH))
+            tb_log(VERB_HIGH, $sformatf("%0t: [drvr] *** INFO *** driving pt: %h %h | key: %h", $time, the_txt[1], the_txt[0], the_key));
         
-        if (the_item.crypto_mode == MODE_DEC) begin
-            the_txt = {the_txt[0], the_txt[1]}; // word reverse!
+        if ((the_item.crypto_mode == MODE_DEC) && !MODE_TOP) begin
+            the_txt = {the_txt[0], the_txt[1]}; // word reverse! (simon_mode_top does it internally)
+        end
+        if (MODE_TOP && the_item.new_session) begin
+            if (log_on(VERB_HIGH))
+                tb_log(VERB_HIGH, $sformatf("%0t: [drvr] *** INFO *** loading session: op %0d, %s, iv: %h, key: %h", $time,
+                    the_item.op, the_item.crypto_mode == MODE_ENC ? "enc" : "dec", the_item.iv, the_key));
+            write_session(.op(the_item.op), .dir(the_item.crypto_mode), .iv(the_item.iv), .key(the_key));
+        end
+        if (KEY_PERSIST && (!session_key_valid || (session_key != the_key))) begin
+            if (log_on(VERB_HIGH))
+                tb_log(VERB_HIGH, $sformatf("%0t: [drvr] *** INFO *** loading session key: %h", $time, the_key));
+            write_key(the_key);
+            session_key         = the_key;
+            session_key_valid   = 1'b1;
+        end
+        if (!perf_en && (idle_pct > 0) && ($urandom_range(99) < idle_pct))
+            repeat ($urandom_range(1, 2*simon_n_cycles(WW, NKW, UNROLL))) @(posedge clk);
+        write_to_input(.mode(the_item.crypto_mode), .alg(the_item.alg), .pt(the_txt), .key(the_key));
+        if (perf_en) begin
+            perf_in_cycle.push_back($time / CLK_PERIOD);
+            if (perf_first_in < 0)
+                perf_first_in = $time / CLK_PERIOD;
         end
-        write_to_input(.mode(the_item.crypto_mode), .pt(the_txt), .key(the_key));
         assert (mb_driver_2_checker.try_put(the_item)) else $error("[drvr] *** ERROR *** could not put int mb_driver_2_checker");
     end
 endtask
@@ -239,19 +951,40 @@ task automatic do_sink();
     forever begin
         logic[2-1:0][WW-1:0]    the_txt;
         logic                   the_mode;
+        logic                   the_alg;
         crypto_item #(.WW(WW), .NKW(NKW) ) the_item;
         
-        @(posedge clk);
-        read_from_output_b(the_txt, the_mode);
+        if (perf_en) begin
+            // ready_i follows the backpressure profile, one decision per cycle
+            do begin
+                simon_out_ready <= bp_ready();
+                @(posedge clk);
+            end while (!(simon_out_valid && simon_out_ready));
+            the_txt     = simon_out_ct;
+            the_mode    = simon_out_mode;
+            the_alg     = SPECK ? simon_out_alg : ALG_SIMON;
+            if (MODE_TOP)
+                wait (perf_in_cycle.size() > 0); // CTR: the input handshake of the block is in this very cycle (the driver may run after)
+            assert (perf_in_cycle.size() > 0) else $error("[sink] *** ERROR *** result without a block in flight");
+            perf_lat[the_mode].push_back($time / CLK_PERIOD - perf_in_cycle.pop_front());
+            perf_last_out = $time / CLK_PERIOD;
+            if (perf_first_out < 0)
+                perf_first_out = perf_last_out;
+        end else begin
+            @(posedge clk);
+            read_from_output_b(the_txt, the_mode, the_alg);
+        end
         the_item                = new();
         the_item.key            = '{NKW*WW/8{8'b0}};
         the_item.crypto_mode    = the_mode;
-        if (the_mode == MODE_DEC) begin
+        the_item.alg            = the_alg;
+        if ((the_mode == MODE_DEC) && !MODE_TOP) begin
             the_txt = {the_txt[0], the_txt[1]};
         end
         the_item.set_txt_from_packed_words(the_txt);
         
-        $display("%0t: [sink] *** INFO *** got item from simon:\n      %s", $time, the_item.to_str(the_item.crypto_mode == MODE_DEC));
+        if (log_on(VERB_HIGH))
+            tb_log(VERB_HIGH, $sformatf("%0t: [sink] *** INFO *** got item from simon:\n      %s", $time, the_item.to_str(the_item.crypto_mode == MODE_DEC)));
         assert (mb_sink_2_checker.try_put(the_item)) else $error("[sink] *** ERROR *** could not put int mb_sink_2_checker");
     end
 endtask
@@ -260,40 +993,180 @@ endtask
 task automatic do_checker();
     automatic int total_count = 0;
     automatic int success_count = 0;
+    automatic int next_progress = (items_to_generate + 9) / 10;
+    automatic int mode_count[2]   = '{0, 0};
+    automatic int mode_success[2] = '{0, 0};
+    automatic int alg_count[2]    = '{0, 0};
+    automatic int alg_success[2]  = '{0, 0};
+    automatic int op_count[3]     = '{0, 0, 0};
+    automatic int op_success[3]   = '{0, 0, 0};
+    bit[2*WW-1:0] mode_chain;   // MODE_TOP: chaining value of the current session, across batches
     
-    while (total_count < ITEMS_TO_GENERATE) begin
-        crypto_item #(.WW(WW), .NKW(NKW) ) item_in;
-        crypto_item #(.WW(WW), .NKW(NKW) ) item_out;
+    while (total_count < items_to_generate) begin
+        crypto_item #(.WW(WW), .NKW(NKW) ) items_in[$];
+        crypto_item #(.WW(WW), .NKW(NKW) ) items_out[$];
         crypto_item #(.WW(WW), .NKW(NKW) ) item_gold;
+        int             batch_size;
+        int             n_failed;
+        int             modes[];
+        bit[2*WW-1:0]   txts_i[];
+        bit[NKW*WW-1:0] keys_i[];
+        bit[2*WW-1:0]   txts_o[];
         
-        // Read from mailboxes for new items -- blocking reads
-        mb_driver_2_checker.get(item_in);
-        mb_sink_2_checker.get(item_out);
-        
-        $display("%0t: [chck] *** INFO *** got source item: %s", $time, item_in.to_str(item_in.crypto_mode == MODE_ENC));
-        $display("%0t: [chck] *** INFO *** got sink item:   %s", $time, item_out.to_str(item_out.crypto_mode == MODE_DEC));
-        
-        if (item_in.crypto_mode == item_out.crypto_mode) begin
-            byte golden_txt[2*WW/8];
-            $display("%0t: [chck] *** INFO *** Calling DPI-C golden routine for %scryption...", $time, item_in.crypto_mode == MODE_ENC ? "en" : "de");
-            dpi_c_run_simon(.crypto_mode(int'(item_in.crypto_mode)), .txt_i(item_in.txt), .key_i(item_in.key), .txt_o(golden_txt));
-            item_gold = new();
-            item_gold.txt = golden_txt;
-            if (golden_txt == item_out.txt) begin
-                success_count++;
-                $display("%0t: [chck] *** SUCCESS *** Generated (%s) matches Golden (%s)", $time, item_out.txt_to_str(), item_gold.txt_to_str());
-            end else begin
-                $error("%0t: [chck] *** FAILURE *** Generated (%s) does NOT match Golden (%s)", $time, item_out.txt_to_str(), item_gold.txt_to_str());
+        // Gather a batch of source/sink item pairs -- blocking reads
+        batch_size = (items_to_generate - total_count) < CHECK_BATCH_SIZE ? (items_to_generate - total_count) : CHECK_BATCH_SIZE;
+        for (int i=0; i<batch_size; i++) begin
+            crypto_item #(.WW(WW), .NKW(NKW) ) item_in;
+            crypto_item #(.WW(WW), .NKW(NKW) ) item_out;
+            
+            mb_driver_2_checker.get(item_in);
+            mb_sink_2_checker.get(item_out);
+            
+            if (log_on(VERB_HIGH)) begin
+                tb_log(VERB_HIGH, $sformatf("%0t: [chck] *** INFO *** got source item: %s", $time, item_in.to_str(item_in.crypto_mode == MODE_ENC)));
+                tb_log(VERB_HIGH, $sformatf("%0t: [chck] *** INFO *** got sink item:   %s", $time, item_out.to_str(item_out.crypto_mode == MODE_DEC)));
+            end
+            items_in.push_back(item_in);
+            items_out.push_back(item_out);
+        end
+        
+        // Flatten the batch & call the golden model once for all items
+        modes   = new[batch_size];
+        txts_i  = new[batch_size];
+        keys_i  = new[batch_size];
+        txts_o  = new[batch_size];
+        for (int i=0; i<batch_size; i++) begin
+            modes[i]  = int'(items_in[i].crypto_mode);
+            txts_i[i] = items_in[i].get_flattened_txt();
+            keys_i[i] = items_in[i].get_flattened_key();
+        end
+        if (vec_replay) begin
+            // expected texts come from the vector file
+            for (int i=0; i<batch_size; i++)
+                txts_o[i] = items_in[i].get_flattened_gold();
+        end else if (MODE_TOP) begin
+            // chain the ECB golden model item by item, as simon_mode_top does
+            if (log_on(VERB_MEDIUM))
+                tb_log(VERB_MEDIUM, $sformatf("%0t: [chck] *** INFO *** Chaining DPI-C golden routine over a batch of %0d items...", $time, batch_size));
+            for (int i=0; i<batch_size; i++) begin
+                bit[2*WW-1:0] blk;
+                if (items_in[i].new_session)
+                    mode_chain = items_in[i].iv;
+                case (items_in[i].op)
+                    OP_CBC: begin
+                        if (modes[i] == MODE_ENC) begin
+                            dpi_c_run_simon_packed(MODE_ENC, WW, NKW, txts_i[i] ^ mode_chain, keys_i[i], txts_o[i]);
+                            mode_chain = txts_o[i];
+                        end else begin
+                            dpi_c_run_simon_packed(MODE_DEC, WW, NKW, txts_i[i], keys_i[i], blk);
+                            txts_o[i]  = blk ^ mode_chain;
+                            mode_chain = txts_i[i];
+                        end
+                    end
+                    OP_CTR: begin
+                        dpi_c_run_simon_packed(MODE_ENC, WW, NKW, mode_chain, keys_i[i], blk);
+                        txts_o[i]  = txts_i[i] ^ blk;
+                        mode_chain = mode_chain + 1;
+                    end
+                    default: begin
+                        dpi_c_run_simon_packed(modes[i], WW, NKW, txts_i[i], keys_i[i], txts_o[i]);
+                    end
+                endcase
             end
+        end else if (!SPECK) begin
+            if (log_on(VERB_MEDIUM))
+                tb_log(VERB_MEDIUM, $sformatf("%0t: [chck] *** INFO *** Calling DPI-C golden routine for a batch of %0d items...", $time, batch_size));
+            n_failed = dpi_c_run_simon_packed_batch(.n_items(batch_size), .ww(WW), .nkw(NKW), .modes_i(modes), .txts_i(txts_i), .keys_i(keys_i), .txts_o(txts_o));
+            if (n_failed != 0)
+                tb_fail($sformatf("%0t: [chck] *** FAILURE *** DPI-C golden routine could not run all items", $time));
         end else begin
-            $error("%0t: [chck] *** FAILURE *** source/sink items' << MODE >> DO NOT match! ", $time);
+            // one golden call per cipher, on the items of the batch that use it
+            for (int a=0; a<2; a++) begin
+                int             idx[$];
+                int             sub_modes[];
+                bit[2*WW-1:0]   sub_txts_i[];
+                bit[NKW*WW-1:0] sub_keys_i[];
+                bit[2*WW-1:0]   sub_txts_o[];
+                
+                idx = items_in.find_index(it) with (it.alg == a);
+                if (idx.size() == 0)
+                    continue;
+                sub_modes   = new[idx.size()];
+                sub_txts_i  = new[idx.size()];
+                sub_keys_i  = new[idx.size()];
+                sub_txts_o  = new[idx.size()];
+                foreach (idx[j]) begin
+                    sub_modes[j]    = modes[idx[j]];
+                    sub_txts_i[j]   = txts_i[idx[j]];
+                    sub_keys_i[j]   = keys_i[idx[j]];
+                end
+                if (log_on(VERB_MEDIUM))
+                    tb_log(VERB_MEDIUM, $sformatf("%0t: [chck] *** INFO *** Calling DPI-C %s golden routine for %0d items...", $time, a == ALG_SPECK ? "Speck" : "Simon", idx.size()));
+                if (a == ALG_SPECK)
+                    n_failed = dpi_c_run_speck_packed_batch(.n_items(idx.size()), .ww(WW), .nkw(NKW), .modes_i(sub_modes), .txts_i(sub_txts_i), .keys_i(sub_keys_i), .txts_o(sub_txts_o));
+                else
+                    n_failed = dpi_c_run_simon_packed_batch(.n_items(idx.size()), .ww(WW), .nkw(NKW), .modes_i(sub_modes), .txts_i(sub_txts_i), .keys_i(sub_keys_i), .txts_o(sub_txts_o));
+                if (n_failed != 0)
+                    tb_fail($sformatf("%0t: [chck] *** FAILURE *** DPI-C golden routine could not run all items", $time));
+                foreach (idx[j])
+                    txts_o[idx[j]] = sub_txts_o[j];
+            end
         end
         
-        total_count++;
+        // Compare
+        for (int i=0; i<batch_size; i++) begin
+            if ((items_in[i].crypto_mode == items_out[i].crypto_mode) && (items_in[i].alg == items_out[i].alg)) begin
+                item_gold = new();
+                item_gold.set_txt_from_flattened(txts_o[i]);
+                if (item_gold.txt == items_out[i].txt) begin
+                    success_count++;
+                    mode_success[items_in[i].crypto_mode]++;
+                    alg_success[items_in[i].alg]++;
+                    op_success[items_in[i].op]++;
+                    if (log_on(VERB_HIGH))
+                        tb_log(VERB_HIGH, $sformatf("%0t: [chck] *** SUCCESS *** Generated (%s) matches Golden (%s)", $time, items_out[i].txt_to_str(), item_gold.txt_to_str()));
+                end else begin
+                    tb_fail($sformatf("%0t: [chck] *** FAILURE *** Generated (%s) does NOT match Golden (%s)", $time, items_out[i].txt_to_str(), item_gold.txt_to_str()));
+                end
+            end else begin
+                tb_fail($sformatf("%0t: [chck] *** FAILURE *** source/sink items' << MODE >> or << ALG >> DO NOT match! ", $time));
+            end
+            mode_count[items_in[i].crypto_mode]++;
+            alg_count[items_in[i].alg]++;
+            op_count[items_in[i].op]++;
+        end
+        
+        total_count += batch_size;
+        // progress, every 10%
+        if (total_count >= next_progress) begin
+            tb_log(VERB_LOW, $sformatf("%0t: [chck] *** INFO *** Progress: %0d/%0d checked, %0d failed.", $time, total_count, items_to_generate, total_count - success_count));
+            next_progress += (items_to_generate + 9) / 10;
+        end
     end
     
     $display("\n");
     $display("%0t: [chck] *** INFO *** Checked all transactions: %0d/%0d succeeded.", $time, success_count, total_count);
+    $display("%0t: [chck] *** INFO ***   encryptions: %0d/%0d | decryptions: %0d/%0d", $time, mode_success[MODE_ENC], mode_count[MODE_ENC], mode_success[MODE_DEC], mode_count[MODE_DEC]);
+    if (MODE_TOP)
+        $display("%0t: [chck] *** INFO ***   ECB: %0d/%0d | CBC: %0d/%0d | CTR: %0d/%0d", $time, op_success[OP_ECB], op_count[OP_ECB],
+            op_success[OP_CBC], op_count[OP_CBC], op_success[OP_CTR], op_count[OP_CTR]);
+    if (SPECK)
+        $display("%0t: [chck] *** INFO ***   Simon: %0d/%0d | Speck: %0d/%0d", $time, alg_success[ALG_SIMON], alg_count[ALG_SIMON], alg_success[ALG_SPECK], alg_count[ALG_SPECK]);
+    begin
+        longint rk_hits, rk_misses;
+        dpi_c_get_rk_cache_stats(rk_hits, rk_misses);
+        tb_log(VERB_LOW, $sformatf("%0t: [chck] *** INFO *** DPI-C round key cache: %0d hits / %0d misses.", $time, rk_hits, rk_misses));
+    end
+    if (SIMON_TOP)
+        tb_log(VERB_LOW, $sformatf("%0t: [tput] *** INFO *** %0d blocks back-to-back (%0d cycles after the previous result), %0d stored key hits.", $time, n_back_to_back, N_CYCLES, n_key_hits));
+    if (STATS && SIMON_TOP)
+        report_stats(mode_count[MODE_ENC], mode_count[MODE_DEC]);
+    if (SIMON_TOP)
+        report_power();
+    if (perf_en)
+        report_perf();
+    if (vec_replay)
+        dpi_c_vec_close();
     $display("\n");
     $display("%0t: [chck] *** INFO *** Now ending", $time);
     $display("\n");
@@ -0,0 +1,311 @@
+/**
+ * @author Anastasios Psarras (a.psarras4225@gmail.com)
+ *
+ * @license MIT license, check license.md
+ *
+ * @brief Verilator cycle model harness of simon_top (no DPI-C, no licensed simulator)
+ *        Drives the Verilated simon_top directly through its ready/valid interfaces and checks every result in-process
+ *        against the generic C kernel (tb-c/simon_generic.h, self-tested against the Simon & Speck paper vectors).
+ *        The input is kept saturated (a new block is offered in the cycle after each handshake), and the output ready
+ *        is asserted in a given % of the cycles (-b), so that the run also measures the simulated cycles/block,
+ *        the latency (input to output handshake) and the simulation speed.
+ *        The Simon configuration is fixed at Verilation (VL_WW/VL_NKW here, -GWW/-GNKW for the RTL, both set by the
+ *        Makefile); RTL assertions are compiled in (--assert) and stop the run on failure.
+ *        With MASKED (VL_MASKED), the randomness input rnd_i is driven with fresh random words every cycle.
+ *
+ *        Build:    make -C tb-verilator WW=32 NKW=3 [UNROLL=..] [THREADS=..]   (see tb-verilator/Makefile)
+ *        Usage:    obj_<config>/Vsimon_top [-n items] [-m enc|dec|mix] [-r key_reuse_pct] [-b ready_pct] [-s seed] [-v]
+ *
+ * @param -n        Number of random blocks (default: 100000)
+ * @param -m        enc, dec or mix (mode chosen randomly per block) (default: mix)
+ * @param -r        % of the blocks reusing one of the last 3 keys, so that the decryption key cache hits (default: 50)
+ * @param -b        % of the cycles the output is ready, 100 for no backpressure (default: 100)
+ * @param -s        Seed (default: 1)
+ * @param -v        Prints every transaction
+ *
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <random>
+#include <type_traits>
+
+#include "verilated.h"
+#include "Vsimon_top.h"
+
+#include "definitions.h"
+#include "simon_generic.h"
+
+#ifndef VL_WW
+#define VL_WW   32
+#endif
+#ifndef VL_NKW
+#define VL_NKW  3
+#endif
+#ifndef VL_MASKED
+#define VL_MASKED   0
+#endif
+
+#define VL_MODE_MIX         2
+#define VL_RESET_CYCLES     4
+#define VL_KEY_REUSE_N      3
+#define VL_TIMEOUT_CYCLES   100000  // max cycles without an output handshake while blocks are in flight
+
+// -- Signal Access ----------------------------------------------------------------------------- //
+// A packed logic[k-1:0][WW-1:0] port is an integer up to 64 bits, and an array of 32-bit chunks (least significant
+// first) above, in which case word i occupies bits [i*WW +: WW] of the chunks.
+template <typename T>
+static void VlPutWords(T& sig, const u64 words[], int numwords, int ww)
+{
+    if constexpr (std::is_integral<T>::value) {
+        u64 v = 0;
+        for (int w=0; w<numwords; w++)
+            v |= (words[w] & MASKN(ww)) << (w*ww);
+        sig = (T)v;
+    } else {
+        for (int c=0; c<(numwords*ww+31)/32; c++)
+            sig[c] = 0;
+        for (int w=0; w<numwords; w++)
+            for (int b=0; b<ww; b++) {
+                int bit = w*ww + b;
+                sig[bit/32] |= (u32)((words[w] >> b) & 1) << (bit%32);
+            }
+    }
+}
+
+template <typename T>
+static void VlGetWords(const T& sig, u64 words[], int numwords, int ww)
+{
+    if constexpr (std::is_integral<T>::value) {
+        for (int w=0; w<numwords; w++)
+            words[w] = ((u64)sig >> (w*ww)) & MASKN(ww);
+    } else {
+        for (int w=0; w<numwords; w++) {
+            words[w] = 0;
+            for (int b=0; b<ww; b++) {
+                int bit = w*ww + b;
+                words[w] |= (u64)((sig[bit/32] >> (bit%32)) & 1) << b;
+            }
+        }
+    }
+}
+
+// -- Items ------------------------------------------------------------------------------------- //
+typedef struct {
+    int     mode;
+    u64     txt[2];     // plaintext (enc) or ciphertext (dec), NSA word order
+    u64     key[4];
+    u64     gold[2];    // expected output, NSA word order
+    u64     in_cycle;   // input handshake cycle
+} vl_item_t;
+
+static std::mt19937_64 rng;
+
+static u64 RandWord(int ww)
+{
+    return rng() & MASKN(ww);
+}
+
+// -- Main -------------------------------------------------------------------------------------- //
+int main(int argc, char** argv)
+{
+    u64         n_items     = 100000;
+    int         mode        = VL_MODE_MIX;
+    int         reuse_pct   = 50;
+    int         ready_pct   = 100;
+    u64         seed        = 1;
+    int         verbose     = 0;
+
+    const std::unique_ptr<VerilatedContext> ctx{new VerilatedContext};
+    ctx->commandArgs(argc, argv);
+    // Verilator keeps its +verilator+ arguments, everything else is ours
+    for (int i=1; i<argc; i++) {
+        const char* a = argv[i];
+        const char* v = (i+1 < argc) ? argv[i+1] : NULL;
+        if      (!strcmp(a, "-n") && v) { n_items   = strtoull(v, NULL, 0); i++; }
+        else if (!strcmp(a, "-m") && v) { mode      = !strcmp(v, "enc") ? MODE_ENC : !strcmp(v, "dec") ? MODE_DEC : VL_MODE_MIX; i++; }
+        else if (!strcmp(a, "-r") && v) { reuse_pct = atoi(v); i++; }
+        else if (!strcmp(a, "-b") && v) { ready_pct = atoi(v); i++; }
+        else if (!strcmp(a, "-s") && v) { seed      = strtoull(v, NULL, 0); i++; }
+        else if (!strcmp(a, "-v"))      { verbose   = 1; }
+        else if (!strncmp(a, "+verilator+", 11)) { }
+        else {
+            fprintf(stderr, "usage: %s [-n items] [-m enc|dec|mix] [-r key_reuse_pct] [-b ready_pct] [-s seed] [-v]\n", argv[0]);
+            return 2;
+        }
+    }
+    if ((ready_pct < 1) || (ready_pct > 100) || (reuse_pct < 0) || (reuse_pct > 100) || (n_items == 0)) {
+        fprintf(stderr, "[vl] -b must be in 1..100, -r in 0..100 and -n at least 1\n");
+        return 2;
+    }
+
+    const simon_gen_cfg_t* cfg = SimonGenConfig(2*VL_WW, VL_NKW*VL_WW);
+    if (!cfg) {
+        fprintf(stderr, "[vl] no Simon %d/%d configuration\n", 2*VL_WW, VL_NKW*VL_WW);
+        return 2;
+    }
+    if (SimonGenSelfTest() != 0) {
+        fprintf(stderr, "[vl] generic kernel self-test failed\n");
+        return 2;
+    }
+    rng.seed(seed);
+
+    const std::unique_ptr<Vsimon_top> top{new Vsimon_top{ctx.get(), "TOP"}};
+
+    // -- Reset -- //
+    top->clk            = 0;
+    top->arst_n         = 1;
+    top->valid_i        = 0;
+    top->mode_i         = 0;
+    top->alg_i          = 0;    // Simon blocks only (simon_top built without SPECK)
+    top->key_valid_i    = 0;
+    top->ready_i        = 0;
+    top->stats_clr_i    = 0;
+    top->stats_addr_i   = 0;
+    top->eval();
+    top->arst_n         = 0;
+    top->eval();
+    for (int c=0; c<VL_RESET_CYCLES; c++) {
+        top->clk = 1; top->eval(); ctx->timeInc(1);
+        top->clk = 0; top->eval(); ctx->timeInc(1);
+    }
+    top->arst_n         = 1;
+    top->eval();
+
+    // -- Run -- //
+    std::deque<vl_item_t>   in_flight;              // in input order, results come back in the same order
+    std::deque<const u64*>  recent_keys;
+    vl_item_t               next;
+    bool                    next_valid  = false;
+    u64                     n_driven    = 0;
+    u64                     n_checked   = 0;
+    u64                     n_failed    = 0;
+    u64                     n_mode[2]   = {0, 0};
+    u64                     cycle       = 0;
+    u64                     last_out    = 0;
+    u64                     first_out   = 0;
+    u64                     lat_min     = ~0ULL, lat_max = 0, lat_sum = 0;
+    u64                     key_ring[VL_KEY_REUSE_N][4];
+    int                     key_ring_ptr = 0;
+    u64                     rk[N_ROUNDS__128_256];
+
+    auto t_start = std::chrono::steady_clock::now();
+    while ((n_checked < n_items) && !ctx->gotFinish()) {
+        // produce the next block
+        if (!next_valid && (n_driven < n_items)) {
+            next.mode = (mode == VL_MODE_MIX) ? (int)(rng() & 1) : mode;
+            next.txt[0] = RandWord(VL_WW);
+            next.txt[1] = RandWord(VL_WW);
+            if (!recent_keys.empty() && ((int)(rng() % 100) < reuse_pct)) {
+                memcpy(next.key, recent_keys[rng() % recent_keys.size()], sizeof(next.key));
+            } else {
+                for (int w=0; w<4; w++)
+                    next.key[w] = w < VL_NKW ? RandWord(VL_WW) : 0;
+                memcpy(key_ring[key_ring_ptr], next.key, sizeof(next.key));
+                if (recent_keys.size() == VL_KEY_REUSE_N)
+                    recent_keys.pop_front();
+                recent_keys.push_back(key_ring[key_ring_ptr]);
+                key_ring_ptr = (key_ring_ptr + 1) % VL_KEY_REUSE_N;
+            }
+            cfg->KeySchedule(next.key, rk);
+            if (next.mode == MODE_ENC)
+                cfg->Encrypt(next.txt, next.gold, rk);
+            else
+                cfg->Decrypt(next.gold, next.txt, rk);
+            next_valid = true;
+        }
+
+        // drive the inputs of this cycle (decryption: the ciphertext goes in word-reversed, as in tb_top)
+        top->valid_i = next_valid;
+        if (next_valid) {
+            u64 pt_words[2];
+            pt_words[0] = next.mode == MODE_DEC ? next.txt[1] : next.txt[0];
+            pt_words[1] = next.mode == MODE_DEC ? next.txt[0] : next.txt[1];
+            top->mode_i = next.mode;
+            VlPutWords(top->pt_i,  pt_words, 2, VL_WW);
+            VlPutWords(top->key_i, next.key, VL_NKW, VL_WW);
+        }
+        if (VL_MASKED) {
+            u64 rnd_words[3+VL_NKW];
+            for (int w=0; w<3+VL_NKW; w++)
+                rnd_words[w] = RandWord(VL_WW);
+            VlPutWords(top->rnd_i, rnd_words, 3+VL_NKW, VL_WW);
+        }
+        top->ready_i = (ready_pct == 100) || ((int)(rng() % 100) < ready_pct);
+        top->eval();
+
+        // handshakes of this cycle, taken at the rising edge
+        bool in_hs  = top->valid_i && top->ready_o;
+        bool out_hs = top->valid_o && top->ready_i;
+        if (out_hs) {
+            u64 ct_words[2], out[2];
+            VlGetWords(top->ct_o, ct_words, 2, VL_WW);
+            if (in_flight.empty()) {
+                fprintf(stderr, "[vl] *** FAILURE *** cycle %llu: result without a block in flight\n", (unsigned long long)cycle);
+                return 1;
+            }
+            vl_item_t& it = in_flight.front();
+            out[0] = it.mode == MODE_DEC ? ct_words[1] : ct_words[0];
+            out[1] = it.mode == MODE_DEC ? ct_words[0] : ct_words[1];
+            if ((top->mode_o != it.mode) || (out[0] != it.gold[0]) || (out[1] != it.gold[1])) {
+                n_failed++;
+                fprintf(stderr, "[vl] *** FAILURE *** cycle %llu: %s of %016llx %016llx: got %016llx %016llx (mode %d), expected %016llx %016llx\n",
+                        (unsigned long long)cycle, it.mode == MODE_ENC ? "enc" : "dec",
+                        (unsigned long long)it.txt[1], (unsigned long long)it.txt[0],
+                        (unsigned long long)out[1], (unsigned long long)out[0], top->mode_o,
+                        (unsigned long long)it.gold[1], (unsigned long long)it.gold[0]);
+            } else if (verbose) {
+                printf("[vl] cycle %llu: %s %016llx %016llx -> %016llx %016llx\n", (unsigned long long)cycle,
+                       it.mode == MODE_ENC ? "enc" : "dec", (unsigned long long)it.txt[1], (unsigned long long)it.txt[0],
+                       (unsigned long long)out[1], (unsigned long long)out[0]);
+            }
+            u64 lat = cycle - it.in_cycle;
+            lat_min = lat < lat_min ? lat : lat_min;
+            lat_max = lat > lat_max ? lat : lat_max;
+            lat_sum += lat;
+            n_mode[it.mode]++;
+            if (n_checked == 0)
+                first_out = cycle;
+            last_out = cycle;
+            n_checked++;
+            in_flight.pop_front();
+        }
+        if (in_hs) {
+            next.in_cycle = cycle;
+            in_flight.push_back(next);
+            next_valid = false;
+            n_driven++;
+        }
+
+        top->clk = 1; top->eval(); ctx->timeInc(1);
+        top->clk = 0; top->eval(); ctx->timeInc(1);
+        cycle++;
+
+        if (!in_flight.empty() && (cycle - (n_checked ? last_out : in_flight.front().in_cycle) > VL_TIMEOUT_CYCLES)) {
+            fprintf(stderr, "[vl] *** FAILURE *** no result for %d cycles\n", VL_TIMEOUT_CYCLES);
+            return 1;
+        }
+    }
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - t_start).count();
+    top->final();
+
+    // -- Report -- //
+    printf("[vl] Simon %d/%d: %llu/%llu succeeded (encryptions: %llu, decryptions: %llu)\n", 2*VL_WW, VL_NKW*VL_WW,
+           (unsigned long long)(n_checked - n_failed), (unsigned long long)n_checked,
+           (unsigned long long)n_mode[MODE_ENC], (unsigned long long)n_mode[MODE_DEC]);
+    if (n_checked > 1)
+        printf("[vl] %llu cycles: %.2f cycles/block sustained, latency min %llu / avg %.2f / max %llu cycles\n",
+               (unsigned long long)cycle, (double)(last_out - first_out) / (n_checked - 1),
+               (unsigned long long)lat_min, (double)lat_sum / n_checked, (unsigned long long)lat_max);
+    printf("[vl] %.3f s: %.0f cycles/s, %.0f blocks/s\n", wall, cycle / wall, n_checked / wall);
+    if (ctx->gotFinish() && (n_checked < n_items)) {
+        fprintf(stderr, "[vl] *** FAILURE *** simulation stopped after %llu blocks\n", (unsigned long long)n_checked);
+        return 1;
+    }
+    return n_failed ? 1 : 0;
+}